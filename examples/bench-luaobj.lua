@@ -0,0 +1,50 @@
+require "yats.stdlib"
+require "yats.core"
+require "yats.src"
+require "yats.misc"
+require "yats.dummy"
+
+-- Benchmark bench-luaobj.lua: throughput of Lua objects vs. C objects.
+--
+-- cbrsrc_1 --> fwd_1 --> sink_1
+-- cbrsrc_n --> fwd_n --> sink_n
+--
+-- The forwarders 'fwd' are C objects (class 'dummy') in the first run and
+-- Lua objects (class 'luadummy') in the second run. Each source sends a
+-- cell in each slot.
+--
+-- Usage: luayats -n examples/bench-luaobj.lua
+
+local nsrc = 10
+local slots = 200000
+
+local function bench(fwdclass)
+  local src, fwd, snk = {}, {}, {}
+  yats.sim:setRand(1)
+  yats.sim:resetTime()
+  for i = 1, nsrc do
+    src[i] = yats.cbrsrc{"src"..i, delta = 1, vci = i, out = {"fwd"..i, fwdclass}}
+    fwd[i] = yats[fwdclass]{"fwd"..i, out = {"sink"..i, "sink"}}
+    snk[i] = yats.sink{"sink"..i}
+  end
+  yats.sim:connect()
+  local t0 = os.clock()
+  yats.sim:run(slots, slots)
+  local t = os.clock() - t0
+  local cells = 0
+  for i = 1, nsrc do
+    cells = cells + snk[i]:getCounter()
+  end
+  yats.sim:reset()
+  return {cells = cells, seconds = t, rate = cells / t}
+end
+
+local res = {}
+res.c = bench("dummy")
+res.lua = bench("luadummy")
+for _, k in ipairs{"c", "lua"} do
+  printf("%-4s %10d cells %8.3f s %12.0f cells/s\n",
+	 k, res[k].cells, res[k].seconds, res[k].rate)
+end
+printf("Lua objects are %.1f times slower than C objects.\n", res.c.rate / res.lua.rate)
+return res
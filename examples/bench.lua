@@ -0,0 +1,108 @@
+require "yats.stdlib"
+require "yats.core"
+
+-- Benchmark bench.lua: speed of the kernel and of some example models.
+--
+-- Micro benchmarks: basic operations of the kernel (see src/kernel/bench.c)
+--   alarm       alarme() + unalarme(), delays 1 ... 100
+--   alarm-far   alarme() + unalarme(), delays 1 ... 100000 (with the
+--               calendar only up to TIME_LEN - 1)
+--   queue       queue::enqueue() + dequeue()
+--   uqueue      uqueue::enqueue() + dequeue()
+--   pool        new + delete of cells (NEW_DELETE)
+--   geo1        geo1_rand()
+--   dispatch    activation of 300 objects with 3 timers each: early()
+--               with a switch on event::key, or (dispatch-handler) one
+--               direct handler per event
+-- Macro benchmarks: the examples below without any output. All calls of
+-- sim:run() are timed (wall clock), the set up of the model is not.
+--
+-- The results are written to stdout as CSV lines 'name,metric,value', e.g.
+--   micro.alarm,ops_per_s,1.2e+08
+--   macro.test-tcpip,slots_per_s,4.1e+06
+-- Compare the output of two releases to find regressions.
+--
+-- Usage: luayats -n examples/bench.lua      (or: make bench)
+--        LUAYATSBENCH=micro|macro selects a part.
+
+local part = os.getenv("LUAYATSBENCH") or "all"
+local nops = 10000000
+
+local macros = {
+  "test-4-muxaf",
+  "test-4-muxdf",
+  "test-4-muxdist",
+  "test-4-muxfrmprio",
+  "test-4-muxprio",
+  "test-4-muxwfq",
+  "test-tcpip",
+  "test-ethbridge-1",
+}
+
+local _print, _printf, _stdout, _output = print, printf, io.stdout, io.output()
+local function report(name, metric, value)
+  _stdout:write(string.format("%s,%s,%.6g\n", name, metric, value))
+  _stdout:flush()
+end
+
+local function micro()
+  report("micro.alarm", "ops_per_s", yats.bench_alarm(nops, 100))
+  report("micro.alarm-far", "ops_per_s", yats.bench_alarm(nops, 100000))
+  report("micro.queue", "ops_per_s", yats.bench_queue(nops, 1))
+  report("micro.uqueue", "ops_per_s", yats.bench_queue(nops, 0))
+  report("micro.pool", "ops_per_s", yats.bench_pool(nops))
+  report("micro.geo1", "ops_per_s", yats.bench_geo1(nops))
+  report("micro.dispatch", "ops_per_s", yats.bench_dispatch(nops, 0))
+  report("micro.dispatch-handler", "ops_per_s", yats.bench_dispatch(nops, 1))
+end
+
+-- Run an example with sim:run() timed and all output suppressed
+local function macro(name)
+  local f, err = loadfile("./examples/"..name..".lua")
+  assert(f, err)
+  local run = yats.sim.run
+  local slots, events, seconds = 0, 0, 0
+  yats.sim.run = function(self, n, dots)
+    local e, t = _sim:GetEventCount(), yats.bench_now()
+    -- no dots
+    local res = run(self, n, 2 * n)
+    seconds = seconds + yats.bench_now() - t
+    events = events + _sim:GetEventCount() - e
+    slots = slots + n
+    return res
+  end
+  _G.print = function(...) end
+  _G.printf = function(...) end
+  io.stdout = {write = function(...) end, flush = function(...) end}
+  -- io.write() writes to the default output file
+  local devnull = assert(io.open("/dev/null", "w"))
+  io.output(devnull)
+  local env = setmetatable({}, {__index = _G})
+  setfenv(f, env)
+  yats.sim:reset()
+  -- no pcall(): sim:run() yields
+  f()
+  _G.print, _G.printf, io.stdout = _print, _printf, _stdout
+  io.output(_output)
+  devnull:close()
+  yats.sim.run = run
+  yats.sim:reset()
+  report("macro."..name, "slots", slots)
+  report("macro."..name, "events", events)
+  report("macro."..name, "seconds", seconds)
+  report("macro."..name, "slots_per_s", slots / seconds)
+  report("macro."..name, "events_per_s", events / seconds)
+end
+
+if part == "all" or part == "micro" then
+  micro()
+  -- bench_geo1() has drawn random numbers, bench_dispatch() has created
+  -- objects
+  yats.sim:setRand(1)
+end
+if part == "all" or part == "macro" then
+  for _, name in ipairs(macros) do
+    macro(name)
+  end
+end
+os.exit(0)
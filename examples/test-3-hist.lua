@@ -0,0 +1,57 @@
+require "yats.stdlib"
+require "yats.core"
+require "yats.src"
+require "yats.muxdmx"
+require "yats.misc"
+
+-- Example test-3-hist.lua: delay quantiles with log-linear histograms.
+--
+-- geosrc_1 --> |\
+-- geosrc_n --> |/ --> meas3 --> meas2 --> meas --> sink
+--              mux
+--
+-- The measurement devices do not need a maximum delay; the histograms
+-- cover all delays with a relative precision of 1%.
+
+yats.sim:SetRand(10)
+yats.sim:ResetTime()
+
+local nsrc = 8
+
+local src = {}
+for i = 1, nsrc do
+  src[i] = yats.geosrc{"src"..i, ed = 10, vci = i, out = {"mux", "in"..i}}
+end
+yats.mux{"mux", ninp = nsrc, buff = 1000, out = {"m3", "meas3"}}
+local m3 = yats.meas3{"m3", ctd = true, iat = true, vci = {1, nsrc}, hist = 0.01,
+  out = {"m2", "meas2"}}
+local m2 = yats.meas2{"m2", hist = true, out = {"m1", "meas"}}
+local m1 = yats.meas{"m1", vci = -1, maxtim = 1000, hist = 0.01, out = {"sink", "sink"}}
+yats.sink{"sink"}
+
+yats.sim:connect()
+yats.sim:run(1000000, 100000)
+
+-- The quantiles from the dense distribution of 'm1' and from its histogram
+-- agree within the precision.
+local function densequantile(m, q)
+  local n, cum = 0, 0
+  for i = 0, m.maxtim - 1 do n = n + m:getDist(i) end
+  for i = 0, m.maxtim - 1 do
+    cum = cum + m:getDist(i)
+    if cum >= q * n then return i end
+  end
+end
+
+local res = {}
+for _, q in ipairs{0.5, 0.99, 0.999} do
+  res[q] = {dense = densequantile(m1, q), hist = m1:getQuantile(q),
+	    ctd = m2:getCTDQuantile(q), iat = m2:getIATQuantile(q),
+	    vci1 = m3:getCTDQuantile(1, q)}
+  printf("p%-5g dense %6d  meas %8.1f  meas2 ctd %8.1f iat %8.1f  meas3 vci 1 %8.1f\n",
+	 q * 100, res[q].dense, res[q].hist, res[q].ctd, res[q].iat, res[q].vci1)
+  assert(math.abs(res[q].hist - res[q].dense) <= 0.01 * res[q].dense + 1)
+  assert(res[q].hist == res[q].ctd)
+end
+printf("histogram buckets: %d, max delay %d\n", m1.hist:getLen(), m1.hist:getMax())
+return res
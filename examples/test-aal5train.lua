@@ -0,0 +1,66 @@
+require "yats.stdlib"
+require "yats.core"
+require "yats.misc"
+require "yats.tcpip"
+
+-- Example test-aal5train.lua: AAL5 segmentation with cell trains.
+--
+-- src1 --> aal5send (single cells) --------------> aal5rec ------> sink1
+-- src2 --> aal5send (train = 8) -----------------> aal5rec ------> sink2
+-- src3 --> aal5send (train = 8) --> aal5split --> aal5rec ------> sink3
+-- src4 --> aal5send (train = 8, copycid) --------> aal5recMult --> sink4
+--
+-- All sources send the same frames. A train is taken by the receivers as
+-- a whole, so the chains with trains deliver the same cells, SDUs and SDU
+-- delays as the chain with single cells. aal5split sends the cells of a
+-- train one per slot, one slot after the train has arrived.
+
+yats.sim:setRand(1)
+yats.sim:resetTime()
+
+local delta, len, train = 100, 1500, 8
+local recs = {}
+for i = 1, 3 do
+  yats.cbrframe{"src"..i, delta = delta, len = len, start_time = 1,
+		out = {"aal"..i, "data"}}
+  recs[i] = yats.aal5rec{"rec"..i, out = {"sink"..i, "sink"}}
+  yats.sink{"sink"..i}
+end
+yats.aal5send{"aal1", vci = 1, buf = 10, bstart = 5,
+	      out = {{"rec1", "in"}, {"src1", "ctrl"}}}
+yats.aal5send{"aal2", vci = 2, buf = 10, bstart = 5, train = train,
+	      out = {{"rec2", "in"}, {"src2", "ctrl"}}}
+yats.aal5send{"aal3", vci = 3, buf = 10, bstart = 5, train = train,
+	      out = {{"split", "in"}, {"src3", "ctrl"}}}
+yats.aal5split{"split", out = {"rec3", "in"}}
+
+yats.cbrframe{"src4", delta = delta, len = len, start_time = 1, connid = 2,
+	      out = {"aal4", "data"}}
+yats.aal5send{"aal4", maxcid = 3, copycid = true, buf = 10, bstart = 5,
+	      train = train, out = {{"recm", "in"}, {"src4", "ctrl"}}}
+local recm = yats.aal5recMult{"recm", maxvci = 3, out = {"sink4", "sink"}}
+yats.sink{"sink4"}
+
+yats.sim:run(100000, 10000)
+
+for i = 1, 3 do
+  local r = recs[i]
+  printf("rec%d:  %d cells, %d SDUs, mean SDU delay %.2f, %d cells lost\n", i,
+	 r:getCounter(), r:getSDUCount(), r.delay_mean, r.cell_loss)
+end
+printf("recm:  %d cells, %d SDUs, mean SDU delay %.2f\n", recm:getCellCount(2),
+       recm:getSDUCount(2), recm:getDelayMean(2))
+
+local r1 = recs[1]
+assert(r1:getSDUCount() > 0, "no SDUs received")
+for i = 2, 3 do
+  assert(recs[i]:getCounter() == r1:getCounter(), "number of cells differs")
+  assert(recs[i]:getSDUCount() == r1:getSDUCount(), "number of SDUs differs")
+  assert(recs[i].cell_loss == 0 and recs[i].sdu_loss == 0, "losses detected")
+end
+assert(recs[2].delay_mean == r1.delay_mean, "SDU delay differs")
+assert(recs[3].delay_mean == r1.delay_mean + 1, "SDU delay behind aal5split differs")
+assert(recm:getCellCount(2) == r1:getCounter(), "number of cells differs (aal5recMult)")
+assert(recm:getSDUCount(2) == r1:getSDUCount(), "number of SDUs differs (aal5recMult)")
+assert(recm:getDelayMean(2) == r1.delay_mean, "SDU delay differs (aal5recMult)")
+return {r1:getSDUCount(), r1.delay_mean}
@@ -0,0 +1,53 @@
+require "yats.stdlib"
+require "yats.core"
+require "yats.src"
+require "yats.muxdmx"
+require "yats.misc"
+require "yats.replica"
+
+-- Example test-branch.lua: several measurements from one warm-up.
+--
+-- geosrc_1 --> |\
+-- geosrc_n --> |/ --> meas --> sink
+--              mux
+--
+-- The system is warmed up once. sim:branch() then forks the measurement
+-- runs from the warmed-up state; each run has its own seed.
+
+yats.sim:setRand(1)
+yats.sim:resetTime()
+
+local nsrc = 8
+for i = 1, nsrc do
+  yats.geosrc{"src"..i, ed = 9, vci = i, out = {"mux", "in"..i}}
+end
+local mx = yats.mux{"mux", ninp = nsrc, buff = 100, out = {"meas", "meas"}}
+local m = yats.meas{"meas", vci = -1, maxtim = 200, hist = 0.01, out = {"sink", "sink"}}
+yats.sink{"sink"}
+
+-- warm-up
+yats.sim:run(100000, 100000)
+local snap = yats.sim:snapshot()
+
+local results, report = yats.sim:branch(4, {
+  seed = 10,
+  run = function(index)
+    m:resCounter()
+    m:resDist()
+    mx:resLoss()
+    yats.sim:run(500000, 500000)
+    return {cells = m:getCounter(), p99 = m:getQuantile(0.99),
+	    loss = mx:getLosses(1, nsrc)}
+  end
+})
+
+for i = 1, 4 do
+  printf("branch %d: cells %d loss %d p99 %.1f\n",
+	 i, results[i].cells, results[i].loss, results[i].p99)
+end
+for _, v in ipairs(report) do
+  printf("%-8s mean %12.3f  [%12.3f, %12.3f]\n", v.name, v.mean, v.lo, v.up)
+end
+-- this process is still at the snapshot
+assert(SimTime == snap.time)
+return report
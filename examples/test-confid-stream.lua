@@ -0,0 +1,35 @@
+require "yats"
+require "yats.stdlib"
+require "yats.statist"
+
+-- Example test-confid-stream.lua: confidence intervals in streaming mode.
+--
+-- The same correlated samples (AR(1), a = 0.9) go into a confid object
+-- storing all values and into one in streaming mode. Mean and variance
+-- agree; the streaming interval comes from batch means and accounts for
+-- the correlation, the interval of the stored values does not.
+
+local lev = 0.95
+local N = 200000
+yats.sim:setRand(1)
+
+local cstore = yats.confid{"store", level = lev}
+local cstream = yats.confid{"stream", level = lev, stream = true, batches = 32, maxlag = 4}
+
+local x = 0
+for i = 1, N do
+  x = 0.9 * x + yats.random(1000)
+  cstore:add(x)
+  cstream:add(x)
+end
+
+local result = {}
+for _, c in ipairs{cstore, cstream} do
+  printf("%-6s n=%d mean=%.4f var=%.4f width=%.4f corr(1)=%.4f corr(4)=%.4f\n",
+    c.name, c:getLen(), c:getMean(), c:getVar(), c:getWidth(lev),
+    c:getCorr(1, 1), c:getCorr(4, 1))
+  table.insert(result, math.floor(c:getMean() * 1000))
+  table.insert(result, math.floor(c:getWidth(lev) * 1000))
+end
+printf("stream: batch size %d, %d batches\n", cstream:getBatchSize(), cstream:getBatches())
+return result
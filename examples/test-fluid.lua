@@ -0,0 +1,52 @@
+require "yats.stdlib"
+require "yats.core"
+require "yats.src"
+require "yats.muxevt"
+require "yats.tcpip"
+require "yats.misc"
+
+-- Example test-fluid.lua: foreground frames under fluid background load.
+--
+-- geosrc_i --> dat2fram_i --> |\
+-- fluidsrc (100 on/off) ----> |/ --> meas --> sink
+--                           muxFrmPrio
+--
+-- Instead of 100 cell sources, the background load of 80% is one fluid
+-- source, which only sends rate changes.
+
+yats.sim:setRand(1)
+yats.sim:resetTime()
+
+local nfg = 2
+local flen = 1000
+local bitrate = 100e6
+local servicerate = bitrate * yats.SlotLength
+-- 100 on/off sources, each 1.6% of the bitrate when on, 50% on
+local nbg = 100
+local bgrate = 0.016 * servicerate
+
+for i = 1, nfg do
+  yats.geosrc{"src"..i, ed = 1000, vci = i, out = {"d2f"..i, "dat2fram"}}
+  yats.dat2fram{"d2f"..i, connid = i, pcp = 0, flen = flen, out = {"mux", "in"..i}}
+end
+local bg = yats.fluidsrc{"bg", n = nbg, rate = bgrate, eb = 2000, es = 2000,
+  inprio = 1, out = {"mux", "in"..(nfg + 1)}}
+local mx = yats.muxFrmPrio{"mux", ninp = nfg + 1, nprio = 2, buff = 100,
+  servicerate = servicerate, mode = "async", out = {"meas", "meas3"}}
+mx:setPriority(1, 1)
+mx:setQueueMax(0, 100)
+local m = yats.meas3{"meas", connid = {1, nfg}, ctd = {0, 10000}, ctddiv = 10,
+  out = {"sink", "sink"}}
+yats.sink{"sink"}
+
+yats.sim:connect()
+yats.sim:run(1000000, 100000)
+
+printf("fluid rate changes: %d\n", bg:getCounter())
+printf("fluid rate now: %.1f%%, backlog: %.0f bits\n",
+  100 * mx:getFluidRate(1) / servicerate, mx:getFluidBacklog(1))
+for i = 1, nfg do
+  printf("connid %d: frames %d, mean CTD %.1f slots\n", i,
+    m:getCount(i - 1), m:getMeanCTD(i - 1))
+end
+printf("losses: %d\n", mx:getLossTot())
@@ -0,0 +1,70 @@
+require "yats.stdlib"
+require "yats.core"
+require "yats.src"
+require "yats.muxdmx"
+require "yats.misc"
+
+-- Example test-parallel.lua: parallel simulation (kernel compiled with PDES).
+--
+-- A ring of nsite sites. Each site sends its traffic over a line to the
+-- next site, where it is multiplexed with local traffic:
+--
+-- geosrc_k1 --> |\                        local_k+1 --> |\
+-- geosrc_kn --> |/ --> line_k --------------------------> |/ --> sink_k+1
+--              up_k      (delay 50)                       down_k+1
+--
+-- The lines decouple the sites: sim:setPartitions() puts them into
+-- different threads, the lookahead is 50 slots.
+-- The results of parallel runs are reproducible, but differ slightly from
+-- the sequential run.
+
+local nsite = 4
+local nsrc = 4
+
+local function build()
+  local snk = {}
+  for k = 1, nsite do
+    local nxt = k % nsite + 1
+    for i = 1, nsrc do
+      yats.geosrc{"src"..k.."_"..i, ed = 6, vci = i, out = {"up"..k, "in"..i}}
+    end
+    yats.mux{"up"..k, ninp = nsrc, buff = 50, out = {"line"..k, "line"}}
+    yats.line{"line"..k, delay = 50, out = {"down"..nxt, "in1"}}
+    yats.geosrc{"local"..k, ed = 4, vci = 0, out = {"down"..k, "in2"}}
+    yats.mux{"down"..k, ninp = 2, maxvci = nsrc + 1, buff = 20, out = {"sink"..k, "sink"}}
+    snk[k] = yats.sink{"sink"..k}
+  end
+  return snk
+end
+
+local function run(jobs)
+  yats.sim:setRandGen("xoshiro")
+  yats.sim:setRand(1)
+  yats.sim:resetTime()
+  local snk = build()
+  yats.sim:connect()
+  local n, lookahead = yats.sim:setPartitions{jobs = jobs}
+  yats.sim:run(200000, 100000)
+  local res = {partitions = n, lookahead = lookahead, cells = {}, loss = {}}
+  for k = 1, nsite do
+    res.cells[k] = snk[k]:getCounter()
+    res.loss[k] = yats.sim:getObj("down"..k):getLosses(1, 2)
+  end
+  yats.sim:reset()
+  return res
+end
+
+local res = {seq = run(1), par = run(nsite), par2 = run(nsite)}
+for _, k in ipairs{"seq", "par", "par2"} do
+  local r = res[k]
+  printf("%-4s partitions %d lookahead %3d", k, r.partitions, r.lookahead)
+  for i = 1, nsite do
+    printf("  sink%d %7d loss %5d", i, r.cells[i], r.loss[i])
+  end
+  printf("\n")
+end
+-- same seed, same partitions: same results
+for i = 1, nsite do
+  assert(res.par.cells[i] == res.par2.cells[i] and res.par.loss[i] == res.par2.loss[i])
+end
+return res
@@ -0,0 +1,53 @@
+require "yats.stdlib"
+require "yats.core"
+require "yats.src"
+require "yats.muxdmx"
+require "yats.misc"
+require "yats.restart"
+
+-- Example test-restart.lua: cell loss ratio with RESTART.
+--
+-- geosrc_1 --> |\
+-- geosrc_n --> |/ --> sink
+--              mux
+--
+-- The loss ratio of the multiplexer is estimated twice: with a plain run
+-- and with RESTART from the same state. The restart object watches the
+-- queue of the multiplexer; each upward crossing of a threshold splits the
+-- trajectory into 4.
+
+yats.sim:setRand(1)
+yats.sim:resetTime()
+
+local nsrc, buff = 8, 24
+for i = 1, nsrc do
+  yats.geosrc{"src"..i, ed = 10, vci = i, out = {"mux", "in"..i}}
+end
+local mx = yats.mux{"mux", ninp = nsrc, buff = buff, out = {"sink", "sink"}}
+local snk = yats.sink{"sink"}
+local rs = yats.restart{"restart", queue = mx.q, thresholds = {6, 12, 18}}
+
+local function count()
+  return {loss = mx:getLossTot(), cells = snk:getCounter()}
+end
+
+-- warm-up
+yats.sim:run(10000, 10000)
+
+-- plain run
+local slots = 1000000
+local c0 = count()
+yats.sim:run(slots, slots)
+local c1 = count()
+local plain = (c1.loss - c0.loss) / (c1.loss - c0.loss + c1.cells - c0.cells)
+
+-- RESTART
+local res = yats.sim:runRestart{
+  watch = rs, slots = slots / 10, splits = 4, count = count, seed = 7
+}
+local est = res.counts.loss / (res.counts.loss + res.counts.cells)
+
+printf("plain:   loss ratio %.3e (%d slots)\n", plain, slots)
+printf("RESTART: loss ratio %.3e (%d slots, %d retrials, %d slots in all)\n",
+       est, res.slots, res.retrials, res.effort)
+return {plain, est}
@@ -0,0 +1,39 @@
+require "yats.stdlib"
+require "yats.core"
+require "yats.src"
+require "yats.muxdmx"
+require "yats.misc"
+require "yats.seqrun"
+
+-- Example test-seqrun.lua: run until the confidence interval is narrow enough.
+--
+-- geosrc_1 --> |\
+-- geosrc_n --> |/ --> meas --> sink
+--              mux
+--
+-- sim:runSequential() observes the mean cell delay in intervals of
+-- 10000 slots, cuts off the warm-up (MSER-5) and stops as soon as the
+-- 95% confidence interval is within +-2% of the mean.
+
+yats.sim:setRand(1)
+yats.sim:resetTime()
+
+local nsrc = 8
+for i = 1, nsrc do
+  yats.geosrc{"src"..i, ed = 9, vci = i, out = {"mux", "in"..i}}
+end
+yats.mux{"mux", ninp = nsrc, buff = 100, out = {"meas", "meas"}}
+local m = yats.meas{"meas", vci = -1, maxtim = 200, out = {"sink", "sink"}}
+yats.sink{"sink"}
+
+local res = yats.sim:runSequential{
+  observe = {m}, relwidth = 0.02, level = 0.95, interval = 10000,
+  batches = 20, maxslots = 10000000
+}
+
+local r = res.results[1]
+printf("converged: %s after %d slots, warm-up %d slots\n",
+       tostring(res.converged), res.slots, res.warmup)
+printf("mean delay %.3f +- %.3f (%.1f%%)\n", r.mean or 0, r.width or 0,
+       100 * (r.relwidth or 0))
+return {res.slots, res.warmup}
@@ -0,0 +1,46 @@
+require "yats.stdlib"
+require "yats.core"
+require "yats.src"
+require "yats.muxdmx"
+require "yats.misc"
+require "yats.sweep"
+
+-- Example test-sweep.lua: buffer size sweep with common random numbers.
+--
+-- geosrc_1 --> |\
+-- geosrc_n --> |/ --> meas --> sink
+--              mux
+--
+-- The scenario runs for each buffer size in 4 replications. The sources
+-- draw the same random numbers at all buffer sizes, so the differences to
+-- the first point are much more precise than the values themselves.
+-- The same file works as scenario of a sweep from the command line:
+--   luayats -n --grid="buff=8,16,32" --replicas=4 examples/test-sweep.lua
+
+local function scenario(p)
+  yats.sim:setRand(1)
+  yats.sim:resetTime()
+  for i = 1, p.nsrc do
+    yats.geosrc{"src"..i, ed = p.ed, vci = i, out = {"mux", "in"..i}}
+  end
+  local mx = yats.mux{"mux", ninp = p.nsrc, buff = p.buff, out = {"meas", "meas"}}
+  yats.meas{"meas", vci = -1, maxtim = 200, out = {"sink", "sink"}}
+  yats.sink{"sink"}
+  yats.sim:run(200000, 200000)
+  return {loss = mx:getLosses(1, p.nsrc)}
+end
+
+local defaults = {nsrc = 8, ed = 9, buff = 16}
+
+if yats.sweep.current then
+  -- a grid point of a sweep from the command line
+  return scenario(yats.sweep.param(defaults))
+end
+
+local report = yats.sweep.run{
+  grid = {buff = {8, 16, 32}}, replicas = 4, jobs = 4, seed = 1,
+  run = function()
+    return scenario(yats.sweep.param(defaults))
+  end
+}
+return report
@@ -0,0 +1,68 @@
+require "yats.stdlib"
+require "yats.core"
+require "yats.src"
+require "yats.muxdmx"
+require "yats.misc"
+
+-- Example test-trace.lua: binary trace of cell transfer delays.
+--
+-- geosrc_1 --> |\
+-- geosrc_n --> |/ --> meas --> sinktrace
+--              mux
+--
+-- The meas object writes the transfer delay of every cell to a binary
+-- trace, the sinktrace object the inter-arrival time of every cell. The
+-- traces are read back and compared with the histogram of meas and the
+-- cell counts.
+-- With codec = "lz4" or "zstd", the blocks are compressed (requires a
+-- build with HAVE_LZ4 or HAVE_ZSTD).
+
+yats.sim:setRand(1)
+yats.sim:resetTime()
+
+local fname = "/tmp/test-trace.trc"
+local aname = "/tmp/test-trace-iat.trc"
+local nsrc = 8
+for i = 1, nsrc do
+  yats.geosrc{"src"..i, ed = 10, vci = i, out = {"mux", "in"..i}}
+end
+yats.mux{"mux", ninp = nsrc, buff = 32, out = {"meas", "meas"}}
+local ms = yats.meas{"meas", vci = -1, maxtim = 64, hist = true,
+		     trace = {file = fname, codec = "raw"}, out = {"sink", "sinktrace"}}
+local sk = yats.sinktrace{"sink", trace = aname}
+
+yats.sim:run(1000000, 100000)
+ms.trace:flush()
+sk.trace:flush()
+
+-- read the trace back
+local n, sum, vcis = 0, 0, {}
+for r in yats.tracerecords(fname) do
+  n = n + 1
+  sum = sum + r.delay
+  vcis[r.vci] = (vcis[r.vci] or 0) + 1
+end
+printf("meas:  %d cells, mean delay %.4f\n", ms.hist:getCount(), ms.hist:getMean())
+printf("trace: %d records, mean delay %.4f\n", n, sum / n)
+for i = 1, nsrc do
+  printf("  vci %d: %d cells\n", i, vcis[i] or 0)
+end
+assert(n == ms.hist:getCount(), "number of records differs")
+assert(math.abs(sum / n - ms.hist:getMean()) < 1e-9, "mean delay differs")
+
+-- arrivals at the sink: the IATs add up to the time of the last arrival
+local na, last, iats = 0, 0, 0
+for r in yats.tracerecords(aname) do
+  assert(r.kind == yats.TREC_ARRIVAL, "unexpected record kind")
+  assert(r.vci >= 1 and r.vci <= nsrc, "unexpected VCI")
+  na = na + 1
+  iats = iats + r.delay
+  last = r.time
+end
+printf("sink:  %d cells, %d arrival records\n", sk:getCounter(), na)
+assert(na == sk:getCounter(), "number of arrival records differs")
+assert(na == n, "number of arrivals differs from number of delays")
+assert(iats == last, "IATs do not add up")
+os.remove(fname)
+os.remove(aname)
+return {n, sum / n}
@@ -0,0 +1,41 @@
+require "yats.stdlib"
+require "yats.core"
+require "yats.src"
+require "yats.misc"
+
+-- Example test-tracesrc.lua: replay of a frame trace.
+--
+-- tracesrc --> sink
+--
+-- A small trace of frame records is written first (16 bytes per record,
+-- little endian hosts only), then replayed twice.
+
+local fname = os.tmpname()
+
+-- Little endian integer of n bytes
+local function le(v, n)
+  local t = {}
+  for i = 1, n do
+    t[i] = string.char(math.mod(v, 256))
+    v = math.floor(v / 256)
+  end
+  return table.concat(t)
+end
+
+local nrec = 1000
+local f = assert(io.open(fname, "wb"))
+for i = 1, nrec do
+  -- iat, length, vlan, priority, drop precedence
+  f:write(le(math.mod(i, 5), 8), le(64 + math.mod(i, 1400), 4),
+	  le(math.mod(i, 3), 2), le(math.mod(i, 8), 1), le(0, 1))
+end
+f:close()
+
+yats.sim:resetTime()
+local src = yats.tracesrc{"src", file = fname, format = "frame", rep = 2,
+  connid = 1, out = {"sink", "sink"}}
+yats.sink{"sink"}
+
+yats.sim:run(10000, 10000)
+printf("records: %d, position: %d\n", src:getRecords(), src:getPosition())
+os.remove(fname)
@@ -19,7 +19,7 @@ WARN = -Wall -Wno-write-strings
 CFLAGS = -DUSELUA -D__LINUX__ -Dexport=export_ -DCD_NO_OLD_INTERFACE -fno-operator-names $(WARN) $(INCS) $(MODCFLAGS) $(USERCFLAGS) 
 LDFLAGS =  $(MODLDFLAGS) $(USERLDFLAGS)
 LIBDIR = -L/usr/local/lib $(USERLIBDIR)
-LIBS = -lm $(LUALIBS) $(IUPLIBS) $(CDLIBS)
+LIBS = -lm -lpthread $(TRACELIBS) $(LUALIBS) $(IUPLIBS) $(CDLIBS)
 
 
 # system capture
@@ -365,7 +365,7 @@ void	abrMux::late(
 	while (n != 0)
 	{	// chose a cell
 		if (n > 1)
-			p = inp_buff + (my_rand() % n);
+			p = inp_buff + my_randn(n);
 		else	p = inp_buff;
 		pc = *p;
 
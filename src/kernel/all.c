@@ -159,6 +159,14 @@ static void trailer(void)
 {
   lua_pushstring(WL, "\nNOTE: This is a Luayats internal error!\n      Depending on the error you probably better restart the application.");
   lua_concat(WL, 2);
+#ifdef PDES
+  // worker thread of a parallel run: there is no way back to Lua
+  if (CurPart > 0) {
+    fprintf(stderr, "%s\n", lua_tostring(WL, -1));
+    exit(1);
+  }
+  pdes_abort();     // main thread: end the parallel run first
+#endif
   lua_error(WL);
 }
 
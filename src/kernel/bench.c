@@ -0,0 +1,263 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+
+/*
+*	Micro benchmarks of the kernel
+*
+*	Used by examples/bench.lua (make bench) to track the speed of the
+*	basic operations between releases. The operations work on private
+*	events and data objects, the state of the simulation is not changed
+*	(except for the random number generator in bench_geo1() and the
+*	random streams of the objects created by bench_dispatch()).
+*/
+
+#include "bench.h"
+#include "sim.h"
+#include "data.h"
+#include "queue.h"
+
+#define	BENCH_BATCH	(1024)	// events or data objects per round
+
+// wall clock time in seconds (monotonic)
+double	bench_now(void)
+{
+	struct	timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// private random numbers: do not disturb the simulation's generator
+static	unsigned bench_rand(unsigned *s)
+{
+	*s ^= *s << 13;
+	*s ^= *s >> 17;
+	*s ^= *s << 5;
+	return *s;
+}
+
+/*
+*	Register BENCH_BATCH events at random delays 1 ... spread and
+*	unregister them again. Delays of TIME_LEN or more use the far wheel
+*	(sim:setEventManager("wheel")). The calendar only takes delays below
+*	TIME_LEN: without the wheel, spread is limited to TIME_LEN - 1.
+*/
+double	bench_alarm(
+	int	n,
+	int	spread)
+{
+	event	*evts[BENCH_BATCH];
+	unsigned seed = 1;
+	double	t;
+	int	i, k, rounds;
+
+	if (spread < 1)
+		errm0("bench_alarm(): spread must be at least 1");
+	if ( !EventWheel && spread >= TIME_LEN)
+		spread = TIME_LEN - 1;
+	for (i = 0; i < BENCH_BATCH; ++i)
+		CHECK(evts[i] = new event(&_sim, i));
+	rounds = n / BENCH_BATCH + 1;
+
+	t = bench_now();
+	for (k = 0; k < rounds; ++k)
+	{	for (i = 0; i < BENCH_BATCH; ++i)
+			alarme(evts[i], 1 + bench_rand(&seed) % spread);
+		// unregister in another order than registered
+		for (i = 0; i < BENCH_BATCH; i += 2)
+			unalarme(evts[i]);
+		for (i = 1; i < BENCH_BATCH; i += 2)
+			unalarme(evts[i]);
+	}
+	t = bench_now() - t;
+
+	for (i = 0; i < BENCH_BATCH; ++i)
+		delete evts[i];
+	return 2.0 * rounds * BENCH_BATCH / t;
+}
+
+/*
+*	Fill a queue with BENCH_BATCH cells and empty it again
+*/
+double	bench_queue(
+	int	n,
+	int	limited)
+{
+	queue	q(BENCH_BATCH);
+	uqueue	uq;
+	data	*pd[BENCH_BATCH];
+	double	t;
+	int	i, k, rounds;
+
+	for (i = 0; i < BENCH_BATCH; ++i)
+		pd[i] = new cell(i);
+	rounds = n / BENCH_BATCH + 1;
+
+	t = bench_now();
+	if (limited)
+	{	for (k = 0; k < rounds; ++k)
+		{	for (i = 0; i < BENCH_BATCH; ++i)
+				q.enqueue(pd[i]);
+			while (q.dequeue() != NULL)
+				;
+		}
+	}
+	else
+	{	for (k = 0; k < rounds; ++k)
+		{	for (i = 0; i < BENCH_BATCH; ++i)
+				uq.enqueue(pd[i]);
+			while (uq.dequeue() != NULL)
+				;
+		}
+	}
+	t = bench_now() - t;
+
+	for (i = 0; i < BENCH_BATCH; ++i)
+		delete pd[i];
+	return 2.0 * rounds * BENCH_BATCH / t;
+}
+
+/*
+*	Allocate BENCH_BATCH cells and free them again, the pool keeps the
+*	memory between the rounds
+*/
+double	bench_pool(
+	int	n)
+{
+	cell	*pc[BENCH_BATCH];
+	double	t;
+	int	i, k, rounds;
+
+	rounds = n / BENCH_BATCH + 1;
+
+	t = bench_now();
+	for (k = 0; k < rounds; ++k)
+	{	for (i = 0; i < BENCH_BATCH; ++i)
+			pc[i] = new cell(i);
+		for (i = 0; i < BENCH_BATCH; ++i)
+			delete pc[i];
+	}
+	t = bench_now() - t;
+
+	return 2.0 * rounds * BENCH_BATCH / t;
+}
+
+/*
+*	Geometrically distributed random numbers (E[] = 10)
+*/
+double	bench_geo1(
+	int	n)
+{
+	volatile int sink;
+	double	t;
+	int	i, h, sum = 0;
+
+	h = get_geo1_handler(10.0);
+
+	t = bench_now();
+	for (i = 0; i < n; ++i)
+		sum += geo1_rand(h);
+	t = bench_now() - t;
+
+	sink = sum;
+	(void) sink;
+	return n / t;
+}
+
+/*
+*	Activation of objects with several timers, as by sim::run(): each of
+*	BENCH_OBJS objects has three events. Either the events have no handler
+*	and early() switches on event::key (like tcpipsend without handlers),
+*	or each event is bound to its method with evt_method<>. The events are
+*	activated in a random order, as evt_early() in sim.c does it, but
+*	without the calendar.
+*/
+#define	BENCH_OBJS	(300)
+#define	BENCH_TIMERS	(3)
+
+class	bench_obj: public root {
+public:
+	bench_obj(int handler)
+		: evt0(this, 0, handler ? evt_method<bench_obj, &bench_obj::timer0> : NULL),
+		  evt1(this, 1, handler ? evt_method<bench_obj, &bench_obj::timer1> : NULL),
+		  evt2(this, 2, handler ? evt_method<bench_obj, &bench_obj::timer2> : NULL)
+	{	cnt0 = cnt1 = cnt2 = 0;
+	}
+
+	void	early(event *evt)
+	{	switch (evt->key) {
+		case 0:	timer0(evt);
+			break;
+		case 1:	timer1(evt);
+			break;
+		case 2:	timer2(evt);
+			break;
+		}
+	}
+	void	timer0(event *)	{ ++cnt0; }
+	void	timer1(event *)	{ cnt1 += 2; }
+	void	timer2(event *)	{ cnt2 ^= cnt0; }
+
+	event	evt0, evt1, evt2;
+	unsigned cnt0, cnt1, cnt2;
+};
+
+double	bench_dispatch(
+	int	n,
+	int	handler)
+{
+	bench_obj	*objs[BENCH_OBJS];
+	event	*evts[BENCH_OBJS * BENCH_TIMERS], *p;
+	unsigned seed = 1;
+	double	t;
+	int	i, j, k, rounds;
+
+	for (i = 0; i < BENCH_OBJS; ++i)
+	{	CHECK(objs[i] = new bench_obj(handler));
+		evts[BENCH_TIMERS * i] = &objs[i]->evt0;
+		evts[BENCH_TIMERS * i + 1] = &objs[i]->evt1;
+		evts[BENCH_TIMERS * i + 2] = &objs[i]->evt2;
+	}
+	for (i = BENCH_OBJS * BENCH_TIMERS - 1; i > 0; --i)
+	{	j = bench_rand(&seed) % (i + 1);
+		p = evts[i];
+		evts[i] = evts[j];
+		evts[j] = p;
+	}
+	rounds = n / (BENCH_OBJS * BENCH_TIMERS) + 1;
+
+	t = bench_now();
+	for (k = 0; k < rounds; ++k)
+		for (i = 0; i < BENCH_OBJS * BENCH_TIMERS; ++i)
+		{	p = evts[i];
+			if (p->handler != NULL)
+				p->handler(p);
+			else
+				p->obj->early(p);
+		}
+	t = bench_now() - t;
+
+	for (i = 0; i < BENCH_OBJS; ++i)
+		delete objs[i];
+	return (double) rounds * BENCH_OBJS * BENCH_TIMERS / t;
+}
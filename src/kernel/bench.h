@@ -0,0 +1,47 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+
+#ifndef	_BENCH_H_
+#define	_BENCH_H_
+
+#include "defs.h"
+
+/*
+*	Micro benchmarks of the kernel (see bench.c and examples/bench.lua).
+*	Each function performs about n operations and returns operations per
+*	second. Run them while no simulation is running: the calendar has to
+*	be in a consistent state. bench_geo1() draws from the random number
+*	generator and bench_dispatch() creates objects (with random streams),
+*	call sim:setRand() afterwards.
+*/
+
+//tolua_begin
+double bench_alarm(int n, int spread);	// alarme() + unalarme(), delays 1 ... spread
+double bench_queue(int n, int limited);	// enqueue() + dequeue() of queue or uqueue
+double bench_pool(int n);		// new + delete of cells (NEW_DELETE pool)
+double bench_geo1(int n);		// geo1_rand()
+double bench_dispatch(int n, int handler); // activation of 300 objects x 3 timers
+double bench_now(void);			// wall clock time in seconds
+//tolua_end
+
+#endif	// _BENCH_H_
@@ -49,34 +49,66 @@
 */
 #include "defs.h"
 #include "data.h"
+#ifdef	__LINUX__
+#include <sys/mman.h>
+#endif
 
 /************************************************************************/
 /*
 *	Memory management for the data classes:
 *		a memory pool pointer for each data class
+*		(one per thread with PDES)
 */
-data	*data::pool = NULL;
-data	*cell::pool = NULL;
-data	*cellPayl::pool = NULL;
-data	*cellSeq::pool = NULL;
-data	*frame::pool = NULL;
-data	*tcpipFrame::pool = NULL;
-data	*tcpAck::pool = NULL;
-data	*rmCell::pool = NULL;
-data	*aal5Cell::pool = NULL;
-data	*frameSeq::pool = NULL;
-data	*isaFrame::pool = NULL;
-data	*dqdbSlot::pool = NULL;
-data	*dmpduSeg::pool = NULL;
+THREAD_LOCAL slabpool	data::pool;
+THREAD_LOCAL slabpool	cell::pool;
+THREAD_LOCAL slabpool	cellPayl::pool;
+THREAD_LOCAL slabpool	cellSeq::pool;
+THREAD_LOCAL slabpool	frame::pool;
+THREAD_LOCAL slabpool	tcpipFrame::pool;
+THREAD_LOCAL slabpool	tcpAck::pool;
+THREAD_LOCAL slabpool	rmCell::pool;
+THREAD_LOCAL slabpool	aal5Cell::pool;
+THREAD_LOCAL slabpool	frameSeq::pool;
+THREAD_LOCAL slabpool	isaFrame::pool;
+THREAD_LOCAL slabpool	dqdbSlot::pool;
+THREAD_LOCAL slabpool	dmpduSeg::pool;
+THREAD_LOCAL slabpool	aal5Train::pool;
+THREAD_LOCAL slabpool	fluid::pool;
 
 /************************************************************************/
 /*
 *	Class independent memory allocation of a bundle of objects:
 *	Exclusion of the real memory allocation from inline new operator,
 *	because (hopefully) seldom called
+*
+*	Each bundle (chunk) is linked into the list of chunks of its pool.
+*	release_pools() returns the chunks of all pools without objects in use
+*	to the system (called by sim:reset()). Optionally, chunks are backed by
+*	transparent huge pages (Linux only).
+*
+*	With PDES, each thread has its own pools. Data objects sent to another
+*	partition are returned to the pool of the receiving thread, i.e. the
+*	chunks are shared among the threads afterwards: pool_shared() turns
+*	off release_pools() for the rest of the program, and the statistics
+*	only cover the objects allocated by the main thread.
 */
 
+struct	slabchunk {
+	slabchunk	*next;
+	size_t		size;		// size of the chunk including this header
+	int		mapped;		// allocated by mmap()
+};
+
+// keep the objects aligned as with new char[]
+#define	CHUNK_HDR	((sizeof(slabchunk) + 15) & ~(size_t) 15)
+#define	HUGE_PAGE	(2 * 1024 * 1024)
+
+static	THREAD_LOCAL slabpool *pools[_end_type];	// all pools in use, by class key
+static	int		PoolHuge = FALSE;
+static	int		PoolShared = FALSE;	// chunks shared by threads
+
 void	*alloc_pool(
+	slabpool *pool,		// the pool of the class
 	size_t	siz,		// size of an object
 	int	gran,		// # of objects to be allocated
 	dat_typ	type)		// object type
@@ -84,6 +116,8 @@ void	*alloc_pool(
 	int	rel;
 	char	*p;
 	int	i;
+	size_t	size;
+	slabchunk	*pc = NULL;
 
 	dprintf("alloc_pool(): allocating %d objects of type %s (size %d)\n",
 	          	       gran, typ2str(type), (int) siz);
@@ -92,7 +126,35 @@ void	*alloc_pool(
 		errm0("internal error: alloc_pool()");
 	rel = siz / sizeof(char);
 
-	CHECK(p = new char[gran * rel]);
+	size = CHUNK_HDR + (size_t) gran * rel;
+#ifdef	__LINUX__
+	if (PoolHuge)
+	{	size = (size + HUGE_PAGE - 1) & ~(size_t) (HUGE_PAGE - 1);
+		if ((p = (char *) mmap(NULL, size, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) != MAP_FAILED)
+		{	(void) madvise(p, size, MADV_HUGEPAGE);
+			pc = (slabchunk *) p;
+			pc->mapped = TRUE;
+			// use the whole huge page(s)
+			gran = (size - CHUNK_HDR) / rel;
+		}
+	}
+#endif
+	if (pc == NULL)
+	{	size = CHUNK_HDR + (size_t) gran * rel;
+		CHECK(p = new char[size]);
+		pc = (slabchunk *) p;
+		pc->mapped = FALSE;
+	}
+	pc->size = size;
+	pc->next = pool->chunks;
+	pool->chunks = pc;
+	pool->nchunks++;
+	pool->bytes += size;
+	if (type >= 0 && type < _end_type)
+		pools[type] = pool;
+
+	p += CHUNK_HDR;
 	for (i = 0; i < gran - 1; ++i)
 	{	((data *)(p + i * rel))->next = (data *) (p + (i + 1) * rel);
 		((data *)(p + i * rel))->type = type;
@@ -105,6 +167,80 @@ void	*alloc_pool(
 	return	p;
 }
 
+/*
+*	Release the chunks of all pools which have no object in use.
+*	Returns the number of bytes released (none after pool_shared()).
+*/
+double	release_pools(void)
+{
+	int	i;
+	double	freed = 0.0;
+	slabpool	*pool;
+	slabchunk	*pc;
+
+	if (PoolShared)
+		return 0.0;
+	for (i = 0; i < _end_type; ++i)
+	{	if ((pool = pools[i]) == NULL || pool->inuse != 0)
+			continue;
+		while ((pc = pool->chunks) != NULL)
+		{	pool->chunks = pc->next;
+			freed += pc->size;
+#ifdef	__LINUX__
+			if (pc->mapped)
+			{	(void) munmap((void *) pc, pc->size);
+				continue;
+			}
+#endif
+			delete[] (char *) pc;
+		}
+		pool->free = NULL;
+		pool->nchunks = 0;
+		pool->bytes = 0;
+	}
+	return freed;
+}
+
+/*
+*	Statistics of the pool of a data class: POOL_INUSE, POOL_HIWAT, POOL_CHUNKS, POOL_BYTES
+*/
+double	pool_stat(
+	dat_typ	type,
+	int	what)
+{
+	slabpool	*pool;
+
+	if (type < 0 || type >= _end_type)
+		errm1d("pool_stat(): invalid data type %d", (int) type);
+	if ((pool = pools[type]) == NULL)
+		return 0.0;
+	switch (what) {
+	case POOL_INUSE:	return pool->inuse;
+	case POOL_HIWAT:	return pool->hiwat;
+	case POOL_CHUNKS:	return pool->nchunks;
+	case POOL_BYTES:	return (double) pool->bytes;
+	default:		errm1d("pool_stat(): invalid selector %d", what);
+	}
+	return 0.0;
+}
+
+void	reset_pool_stat(void)
+{
+	int	i;
+	for (i = 0; i < _end_type; ++i)
+		if (pools[i] != NULL)
+			pools[i]->hiwat = pools[i]->inuse;
+}
+
+void	pool_hugepages(int on)
+{
+	PoolHuge = on;
+}
+
+void	pool_shared(void)
+{
+	PoolShared = TRUE;
+}
 
 /*
 *	Check and shift (according to the diplacement) a given index into an array.
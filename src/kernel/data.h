@@ -44,8 +44,9 @@
 *		  operators. They decrease the simulation time by approx. 30% and initialize
 *		  the 'type' object members.
 *		- CLONE(class_name): definition of the method clone() (make a copy of an object)
-*	3.	Define the static class member (data *new_class::pool) in data.c,
-*		it has been declared by NEW_DELETE().
+*	3.	Define the static class member (THREAD_LOCAL slabpool new_class::pool)
+*		in data.c, it has been declared by NEW_DELETE(). Without THREAD_LOCAL,
+*		the definition does not match the declaration under PDES.
 *	4.	Register the new class in data_classes() (very below). The macro
 *		DATA_CLASS(internal_class_name, external_name) uses the information of previous
 *		BASECLASS() and CLASS_KEY() statements to examine the derivation relationships.
@@ -75,8 +76,10 @@ typedef	enum	{
   IsaFrameType = 10,
   DQDBSlotType = 11, 
   DMPDUSegType = 12,
+  AAL5TrainType = 13,
+  FluidType = 14,
   // include new values before _end_type, and adjust _end_type.
-  _end_type = 13
+  _end_type = 15
 } dat_typ;
 
 // =============================================================================
@@ -98,6 +101,7 @@ public:
     //	embedded = NULL; we let do this the first time by the memory allocation
     //		routine, and we reset embedded in ~data() if necessary
     embedded = NULL;
+    shared = 0;
     // would be too dangerous: Suppose somebody defines
     // a data object or sth. derived normally in a block. Then not operator
     // new is called, but the object is placed on the stack. Thus, embedded won't
@@ -119,9 +123,36 @@ public:
     if (embedded) {
       // We shift this to the constructor, see above.
       // embedded = NULL; // it goes cleaned back into the memory pool
-      delete embedded;
+      embedded->release();
     }
   }
+
+//tolua_end
+  // Shared data items: clone() does not copy the embedded data item, the
+  // copies share it (e.g. a frame flooded to all ports of a bridge).
+  // share() adds an owner, release() drops one and deletes the item with
+  // the last one. A shared item must not be changed: take it out of its
+  // container with takeEmbedded(), which copies it if necessary.
+  inline data *share(void){
+    DATA_SHARE(this);
+    return this;
+  }
+  inline void release(void){
+    if (DATA_UNSHARE(this))
+      delete this;
+  }
+  inline data *takeEmbedded(void){
+    data *pd = embedded, *pc;
+    embedded = NULL;
+    if (pd != NULL && pd->shared != 0) {
+      // other owners: take a copy
+      pc = pd->clone();
+      pd->release();
+      pd = pc;
+    }
+    return pd;
+  }
+//tolua_begin
   // how long am I?
   virtual size_t pdu_len() {
     return 1;	
@@ -135,6 +166,7 @@ public:
 //tolua_end
 
   int 	clp;
+  int	shared;		// # of further owners, see share()
 
 #ifdef	DATA_OBJECT_TRACE
   char	*traceOrigPtr;	// points to the SetTrace network object
@@ -154,8 +186,9 @@ public:
         virtual data *clone() {\
           data    *pd;\
           pd = new aClass( *this);\
+          pd->shared = 0;\
           if (embedded)\
-            pd->embedded = embedded->clone();\
+            pd->embedded = embedded->share();\
             return pd;\
         }\
 	virtual	~aClass(){}
@@ -463,6 +496,48 @@ public:
 };
 //tolua_end
 
+// =============================================================================
+//	AAL5 cell trains: ncells consecutive cells of one AAL SDU in one object
+// =============================================================================
+// The members of aal5Cell describe the train: cell_seq and time belong to the
+// first cell (the others follow in the next slots), pt and first_cell to the
+// last one, which also carries the embedded frame if pt == 1.
+// Registered as derived from data, not from aal5Cell: objects checking for
+// CellType or AAL5CellType reject trains in typecheck(). Generic objects
+// accounting per cell (mux, meas without VCI) reject them in traincheck()
+// (see ino.h); split() takes the cells off (see aal5split).
+class aal5Train:	public aal5Cell {
+public:
+  BASECLASS(data);
+  CLASS_KEY(AAL5TrainType);
+  NEW_DELETE(1000);	// the pool member has to be defined in data.c
+  CLONE(aal5Train);
+
+  inline aal5Train(int i, int n): aal5Cell(i) {
+    ncells = n;
+  }
+  size_t	pdu_len() {
+    return 53 * ncells;
+  }
+  // Takes the first cell off the train. The train is empty when ncells
+  // has dropped to 0 and has to be deleted by the caller then.
+  inline aal5Cell *split(void) {
+    aal5Cell *pc = new aal5Cell(vci);
+    pc->clp = clp;
+    pc->time = time++;
+    pc->sdu_seq = sdu_seq;
+    pc->cell_seq = cell_seq++;
+    if (--ncells == 0) {
+      pc->pt = pt;
+      pc->first_cell = first_cell;
+      pc->embedded = takeEmbedded();
+    } else
+      pc->pt = 0;
+    return pc;
+  }
+  int ncells;		// number of cells in the train
+};
+
 // =============================================================================
 //	DQDB: DQDB-TimeSlot 
 // =============================================================================
@@ -513,6 +588,29 @@ public:
   int connID;		// internal  adress of DMPDU_segment
 };
 
+// =============================================================================
+//	Fluid: change of the rate of a fluid (background) flow
+// =============================================================================
+// Sent by fluid sources (fluidsrc) to fluid-aware multiplexers (muxFrmPrio).
+// The item carries no traffic itself, only the rate change.
+class fluid:	public	data {
+public:
+  BASECLASS(data);
+  CLASS_KEY(FluidType);
+  NEW_DELETE(100);	// the pool member has to be defined in data.c
+  CLONE(fluid);
+
+  inline	fluid(double d, int pcp) {
+    delta = d; prioCodePoint = pcp;
+  }
+  size_t pdu_len() {
+    return 0;
+  }
+
+  double delta;		// rate change in bits per slot
+  int prioCodePoint;	// priority of the flow, as in frames
+};
+
 // =============================================================================
 //	Registration of data classes
 // =============================================================================
@@ -533,6 +631,8 @@ inline	void	data_classes(void)
   DATA_CLASS(isaFrame, "IsabelFrame");
   DATA_CLASS(dqdbSlot, "DQDBSlot");
   DATA_CLASS(dmpduSeg, "DMPDUSeg");
+  DATA_CLASS(aal5Train, "AAL5Train");
+  DATA_CLASS(fluid, "Fluid");
 }
 //tolua_end
 #endif	// _DATA_H_
@@ -50,7 +50,8 @@
 //      (e.g. during init() and command())
 //    - calling alarml( ..., 0) during the early phase (registration for the
 //      late phase of the same slot) is allowed
-//         b) an event structure is not used twice by alarme(), alarml(), eache(), or eachl()
+//         b) an event structure is not used twice by alarme(), alarml(), eache(), eachl(),
+//            or lazyl()
 // 
 //  Turning the EVENT_DEBUG on slows the simulator down by approx. 10 per cent.
 // 
@@ -74,6 +75,20 @@
 
 //#define RECEIVE_DEBUG 1
 
+//
+// If OBJECT_PROFILE is turned on, the profiler (see sim::SetProfile()) also counts
+// the calls of rec() methods and charges the time spent in them to the receiver.
+// Same requirements as RECEIVE_DEBUG (usage of REC).
+//
+
+//#define OBJECT_PROFILE 1
+
+#ifdef OBJECT_PROFILE
+#define rec(x,y) recProf((x), (y), this)
+#define REC(x,y) recProfOri(x,y,void *(*)())
+// see DATA_OBJECT_TRACE for the third parameter
+#else // OBJECT_PROFILE
+
 #ifdef DATA_OBJECT_TRACE
 #define rec(x,y) recTrac((x), (y), this)
 #define REC(x,y) recTracOri(x,y,void *(*)())
@@ -94,6 +109,36 @@
 
 #endif // DATA_OBJECT_TRACE
 
+#endif // OBJECT_PROFILE
+
+//
+// If TIME64 is turned on, the simulation clock (tim_typ) and the common counters
+// (cnt_typ, e.g. ino::counter) have 64 bits. The clock never wraps around, long runs
+// need no sim:resetTime(), and the overflow checks of the counters are
+// compiled out (CNT_OVERFLOW() is always false).
+// Exported counters (intScalar) only show the lower 32 bits.
+//
+
+//#define TIME64 1
+
+//
+// If PDES is turned on, sim::run() can distribute the objects over several threads
+// (conservative parallel simulation, see pdes.c and sim:setPartitions()). The state of
+// the kernel (calendar, SimTime, data pools, ...) becomes thread-local (THREAD_LOCAL).
+// As long as no partitions are set, the simulation runs sequentially.
+// Link with -pthread.
+//
+
+//#define PDES 1
+
+#ifdef PDES
+#if defined(OBJECT_PROFILE) || defined(DATA_OBJECT_TRACE) || defined(RECEIVE_DEBUG)
+#error "PDES cannot be combined with OBJECT_PROFILE, DATA_OBJECT_TRACE or RECEIVE_DEBUG"
+#endif
+#endif // PDES
+
+#include "simtime.h"	// THREAD_LOCAL, tim_typ, cnt_typ
+
 #ifdef EBZAW
 #include <iostream.h>
 #endif
@@ -210,16 +255,12 @@ void syntax1d(char *, int);
 * Type declarations
 */
 
-/*
-* Type of the simulation clock
-*/
 //tolua_begin
-typedef unsigned int tim_typ;
 
-extern tim_typ SimTime; // simulation time
+extern THREAD_LOCAL tim_typ SimTime; // simulation time
 extern double SlotLength; // length of a slot in seconds
-extern double SimTimeReal;
-extern int TimeType; // early or late slot phase?
+extern THREAD_LOCAL double SimTimeReal;
+extern THREAD_LOCAL int TimeType; // early or late slot phase?
 //tolua_end
 /**************************************************************************/
 // definition of common data classes
@@ -227,33 +268,66 @@ extern int TimeType; // early or late slot phase?
 #define BASECLASS(cl) typedef cl _baseclass_
 #define CLASS_KEY(key) enum {_cl_key_ = key}
 #define NEW_DELETE(gran)\
- static data *pool;\
+ static THREAD_LOCAL slabpool pool;\
  inline void *operator new(size_t siz)\
-  { extern void *alloc_pool(size_t, int, dat_typ);\
+  { extern void *alloc_pool(slabpool *, size_t, int, dat_typ);\
    data *pd;\
-   if ((pd = pool) == NULL)\
-    pd = pool = (data *) alloc_pool(siz, gran, (dat_typ) _cl_key_);\
-   pool = pool->next;\
+   if ((pd = pool.free) == NULL)\
+    pd = pool.free = (data *) alloc_pool(&pool, siz, gran, (dat_typ) _cl_key_);\
+   pool.free = pd->next;\
+   if (++pool.inuse > pool.hiwat)\
+    pool.hiwat = pool.inuse;\
    return pd;\
   }\
  inline void operator delete(void *p)\
   {\
-   ((data *)p)->next = pool;\
-   pool = (data *)p;\
+   ((data *)p)->next = pool.free;\
+   pool.free = (data *)p;\
+   --pool.inuse;\
   }
+// clone(): the copy shares the embedded data item (see data::share())
 #define CLONE(aClass)\
  virtual data *clone()\
  { data *pd;\
   pd = new aClass( *this);\
+  pd->shared = 0;\
   if (embedded)\
-   pd->embedded = embedded->clone();\
+   pd->embedded = embedded->share();\
   return pd;\
  }
+// drop an owner of a shared data item, TRUE: it was the last one
+#ifdef PDES
+#define DATA_UNSHARE(pd) (__atomic_fetch_sub(&(pd)->shared, 1, __ATOMIC_ACQ_REL) == 0)
+#define DATA_SHARE(pd) __atomic_fetch_add(&(pd)->shared, 1, __ATOMIC_RELAXED)
+#else
+#define DATA_UNSHARE(pd) ((pd)->shared-- == 0)
+#define DATA_SHARE(pd) (++(pd)->shared)
+#endif
 #define DATA_CLASS(cl, name)\
  { extern void add_class(char *, dat_typ, dat_typ);\
    add_class((char*)name, (dat_typ) cl::_cl_key_, (dat_typ) cl::_baseclass_::_cl_key_);	\
  }
 
+/*
+* Memory pool of a data class, declared by NEW_DELETE (see data.c)
+* Objects are taken from chunks of gran objects. The chunks of a pool
+* are released by release_pools() as soon as no object is in use.
+*/
+class data;
+struct slabchunk;
+struct slabpool {
+  data *free;  // free objects
+  slabchunk *chunks;  // allocated chunks
+  int inuse;  // objects currently in use
+  int hiwat;  // high water mark of inuse
+  int nchunks;  // number of chunks
+  size_t bytes;  // size of all chunks
+};
+#define POOL_INUSE  (0)
+#define POOL_HIWAT  (1)
+#define POOL_CHUNKS (2)
+#define POOL_BYTES  (3)
+
 class root;
 #include "data.h"
 
@@ -266,6 +340,11 @@ class root;
 extern char *typ2str(dat_typ); // convert a dat_typ to string
 extern dat_typ str2typ(char *); // the other direction
 extern int type_check_table[_end_type][_end_type];
+extern double release_pools(void); // release unused chunks of all pools
+extern double pool_stat(dat_typ, int); // POOL_INUSE, ..., POOL_BYTES
+extern void reset_pool_stat(void); // reset high water marks
+extern void pool_hugepages(int); // back new chunks with huge pages
+extern void pool_shared(void); // objects have moved between threads, see PDES
 
 /**************************************************************************/
 // definition of the argument classes for the root::special()-method
@@ -273,6 +352,68 @@ extern int type_check_table[_end_type][_end_type];
 // definition of the root::export() argument structure
 #include "special.h"
 
+/*
+* Random number stream: xoshiro256** (Blackman, Vigna)
+* Each object owns a stream. The streams are 2^128 numbers apart
+* (see jump()) and are derived from the seed given to my_srand().
+*/
+class randstream {
+public:
+  unsigned long long s[4];
+  void seed(unsigned long long);
+  void jump(void);
+  inline unsigned long long next(void) {
+    unsigned long long r = rotl(s[1] * 5, 7) * 9;
+    unsigned long long t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return r;
+  }
+private:
+  static inline unsigned long long rotl(unsigned long long x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+};
+extern THREAD_LOCAL randstream *RandCur;	// stream of the currently activated object
+extern randstream RandMaster;	// stream used outside of object activations
+
+/*
+* sim::run() selects the stream of an object only for early() and late().
+* rec() runs on the stream of the sender. An object drawing random numbers
+* in rec() (or in methods called from there) selects its own stream with
+*	rec_typ xyz::REC(data *pd, int key) { randscope rs(this); ... }
+*/
+class randscope {
+  randstream *old;
+public:
+  inline randscope(root *);
+  ~randscope() {RandCur = old;}
+};
+
+/*
+* Per-object profiling (see sim::SetProfile())
+* Counts the activations of each object and the processor cycles spent in it.
+* Calls of rec() are only counted when compiled with OBJECT_PROFILE.
+*/
+struct profdata {
+  unsigned long long nearly;	// early() activations
+  unsigned long long nlate;	// late() activations
+  unsigned long long nrec;	// rec() calls
+  unsigned long long cycles;	// spent in the object itself, w/o called objects
+};
+#define PROF_EARLY  (0)
+#define PROF_LATE   (1)
+#define PROF_REC    (2)
+#define PROF_CYCLES (3)
+extern int Profiling;
+extern profdata *prof_enter(root *);
+extern void prof_leave(profdata *);
+extern void prof_delete(profdata *);
+
 /*
 * Root class
 */
@@ -309,7 +450,16 @@ public:
   root *next;
   char *name;
   tim_typ time;
+  int lp;	// partition (logical process) of the object, see PDES
   //tolua_end
+  profdata *prof;	// profiling data, NULL if never profiled
+  randstream rng;	// own random number stream (RAND_XOSHIRO)
+  root *rng_next;	// list of all objects in order of creation
+  root **rng_pprev;
+#ifdef OBJECT_PROFILE
+
+  rec_typ recProf(data *, int, root *);
+#endif // OBJECT_PROFILE
 #ifdef DATA_OBJECT_TRACE
 
   rec_typ recTrac(data *, int, root *);
@@ -336,6 +486,24 @@ public:
 }
 ; // end definition class root
 
+inline randscope::randscope(root *obj) {
+  old = RandCur;
+  RandCur = &obj->rng;
+}
+
+#ifdef PDES
+/*
+* Parallel simulation (see pdes.c)
+* A data object sent to an object of another partition is posted to the thread
+* of that partition by pdes_post(). This is only allowed for receivers delaying
+* their input by at least the lookahead, i.e. line objects.
+*/
+extern THREAD_LOCAL int CurPart; // partition of the running thread, -1: sequential run
+extern void pdes_post(root *, data *, int);
+extern void pdes_abort(void);	// error in the main thread, see pdes.c
+#define PDES_REMOTE(obj) (CurPart >= 0 && (obj)->lp != CurPart)
+#endif // PDES
+
 #if 0
 class block: public root {
   block() {}
@@ -350,12 +518,26 @@ class block: public root {
 #define MAGICEVT    (0x22091991)
 #define MAGICEVTCHK (0xccf6e66e)
 
+//tolua_end
+// Direct handler of an event: called by the kernel instead of
+// obj->early() / obj->late(). An object with several timers may bind one
+// method to each instead of switching on event::key. Bind a member function
+// with evt_method<class, &class::method>. The effect on the tcpip models
+// is measured by macro.test-tcpip of make bench (examples/bench.lua),
+// before and after binding handlers; micro.dispatch and
+// micro.dispatch-handler compare the two ways of activation alone.
+typedef void (*evt_handler)(event *);
+
+//tolua_begin
 class event {
 public:
   // forbid uninitialized events
   inline event(root *o, int k) {
     obj = o;
     key = k;
+    handler = NULL;
+    pprev = NULL;
+    rank = 0;
 #ifdef EVENT_DEBUG
     used = FALSE;
 #endif
@@ -363,6 +545,17 @@ public:
   }
   ~event() {}
   //tolua_end
+  inline event(root *o, int k, evt_handler h) {
+    obj = o;
+    key = k;
+    handler = h;
+    pprev = NULL;
+    rank = 0;
+#ifdef EVENT_DEBUG
+    used = FALSE;
+#endif
+
+  }
   inline void *operator new(size_t siz) {
     event *p;
     CHECK(p = (event *)malloc(siz));
@@ -383,6 +576,9 @@ public:
   unsigned int dyn;
   unsigned int dynchk;
   //tolua_end
+  evt_handler handler;  // NULL: obj->early() / obj->late()
+  event **pprev;  // the pointer pointing to me, NULL: not registered
+  unsigned int rank;  // order of eache(), eachl(), lazyl(), 0: none of them
 #ifdef EVENT_DEBUG
 
   int used;  // TRUE: event is currently used by the scheduler
@@ -390,6 +586,12 @@ public:
 }
 ; //tolua_export
 
+template <class T, void (T::*M)(event *)>
+void evt_method(event *evt)
+{
+  (static_cast<T *>(evt->obj)->*M)(evt);
+}
+
 
 /*
 * Data structures for parser and scanner
@@ -460,17 +662,38 @@ tok_typ eval(char *, char *);
 //tolua_begin
 void unalarme(event *);
 void unalarml(event *);
+void realarme(event *, tim_typ);
+void realarml(event *, tim_typ);
 void eache(event *);
 void eachl(event *);
+void lazyl(event *);
+void slotend(event *);
+void unslotend(event *);
 //tolua_end
 // Random Variables
 #define USE_MY_RAND (1)
 
 #ifdef USE_MY_RAND
-int my_rand(void);
+// generators selectable by my_randgen()
+#define RAND_LEGACY  (0) // 15 bit LCG of IBM/DEC, one stream for all objects
+#define RAND_XOSHIRO (1) // 64 bit xoshiro256**, one stream per object
+// derivation of the object streams selectable by my_randkey()
+#define RAND_BYORDER (0) // in the order of object creation
+#define RAND_BYNAME  (1) // from the object name (common random numbers)
+
+int my_rand(void);		// 15 bit, 0 ... 32767
+int my_randn(int);		// 0 ... n - 1
+unsigned long long my_rand64(void);
 // included by Mue: 29.10.1999
 double uniform(); // defined in geo1.c
 void my_srand(int);
+void my_randgen(int);
+int my_getrandgen(void);
+void my_randkey(int);
+int my_getrandkey(void);
+void rand_register(root *);	// called by root::root()
+void rand_name(root *);		// name of the object has been set
+void rand_unregister(root *);	// called by root::~root()
 #else /* USE_MY_RAND */
 extern "C" long int random(void);
 extern "C" int srandom(int);
@@ -480,6 +703,9 @@ inline int my_rand(void) {
 inline void my_srand(int i) {
   (void) srandom(i);
 }
+inline int my_randn(int n) {
+  return random() % n;
+}
 #endif /* USE_MY_RAND */
 
 #define rand()  PleaseUseMy_RandInstead
@@ -565,6 +791,11 @@ macro with unassigned return value, or
 #define TXT_MAX (70000)  // max length of input text (with includes)
                                                      //tolua_begin
 #define TIME_LEN (100000)  // basic length for running the simulator
+#define FAR_LEN (1024)  // revolutions of the calendar covered by the far timing wheel
+
+                                                     // event manager backends, see sim::SetEventManager()
+#define EVT_CALENDAR (0)  // static calendar queue only
+#define EVT_WHEEL (1)  // calendar plus hierarchical far wheel
 
 #define NILVCI (-1)  // common constant for an unknown VCI
 
@@ -592,25 +823,63 @@ return r;\
                                                      { Alarme,
                                                      Alarml,
                                                      Eache,
-                                                     Eachl
+                                                     Eachl,
+                                                     Lazyl,
+                                                     Slotend
                                                      };
                                                      extern void check_evt(event *, tim_typ, enum evt_dbg_enum);
 #endif
+                                                     // timing wheel backend: events not fitting into the calendar (see sim.c)
+                                                     extern int EventWheel;
+                                                     extern void alarmfar(event *, int);
+                                                     // wakel() for events registered by lazyl() (see sim.c)
+                                                     extern void wake_insert(event *);
+
+                                                     // occupancy bitmap of the calendar (early and late), used to skip empty slots
+                                                     // A set bit means: the calendar position may contain events.
+#define EVT_MAP_BITS (64)
+                                                     extern THREAD_LOCAL unsigned long long eventmap[];
+#define EVT_MARK(i) (eventmap[(i) / EVT_MAP_BITS] |= 1ULL << ((i) % EVT_MAP_BITS))
+                                                     // link an event at the head of an event list
+                                                     inline void evt_link(
+                                                     event **e,
+                                                     event *evt)
+                                                     {
+                                                     if ((evt->next = *e) != NULL)
+                                                        (*e)->pprev = &evt->next;
+                                                     evt->pprev = e;
+                                                     *e = evt;
+                                                     }
+
+                                                     // remove an event from the event list it is linked in
+                                                     inline void evt_unlink(
+                                                     event *evt)
+                                                     {
+                                                     if ((*evt->pprev = evt->next) != NULL)
+                                                        evt->next->pprev = evt->pprev;
+                                                     evt->pprev = NULL;
+                                                     }
+
                                                      //tolua_begin
                                                      inline void alarme(
                                                      event *evt,
                                                      tim_typ delta)
                                                      {
                                                      event **e;
-                                                     extern event *eventse[];
+                                                     extern THREAD_LOCAL event *eventse[];
 
 #ifdef EVENT_DEBUG
                                                      check_evt(evt, delta, Alarme);
 #endif
 
-                                                     e = eventse + ((evt->time = SimTime + delta) % TIME_LEN);
-                                                     evt->next = *e;
-                                                     *e = evt;
+                                                     evt->time = SimTime + delta;
+                                                     if (delta >= TIME_LEN && EventWheel) {
+                                                        alarmfar(evt, EARLY);
+                                                        return;
+                                                     }
+                                                     e = eventse + (evt->time % TIME_LEN);
+                                                     EVT_MARK(evt->time % TIME_LEN);
+                                                     evt_link(e, evt);
                                                      }
 
                                                      // registration for the second slot phase
@@ -619,15 +888,36 @@ return r;\
                                                      tim_typ delta)
                                                      {
                                                      event **e;
-                                                     extern event *eventsl[];
+                                                     extern THREAD_LOCAL event *eventsl[];
 
 #ifdef EVENT_DEBUG
                                                      check_evt(evt, delta, Alarml);
 #endif
 
-                                                     e = eventsl + ((evt->time = SimTime + delta) % TIME_LEN);
-                                                     evt->next = *e;
-                                                     *e = evt;
+                                                     evt->time = SimTime + delta;
+                                                     if (delta >= TIME_LEN && EventWheel) {
+                                                        alarmfar(evt, LATE);
+                                                        return;
+                                                     }
+                                                     e = eventsl + (evt->time % TIME_LEN);
+                                                     EVT_MARK(evt->time % TIME_LEN);
+                                                     evt_link(e, evt);
+                                                     }
+
+                                                     // activate the late phase once, e.g. on arrival of data:
+                                                     // - events registered by lazyl(): at their place in the list of eachl(),
+                                                     //   in the next slot if their place has been passed already
+                                                     // - other events: alarml(evt, 0), allowed in the early phase only
+                                                     // Nothing happens if the event is already registered.
+                                                     inline void wakel(
+                                                     event *evt)
+                                                     {
+                                                     if (evt->pprev == NULL) {
+                                                        if (evt->rank == 0)
+                                                           alarml(evt, 0);
+                                                        else
+                                                           wake_insert(evt);
+                                                     }
                                                      }
                                                      //tolua_end
 
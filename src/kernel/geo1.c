@@ -103,7 +103,7 @@ int get_geo1_handler(double expct)
 
 int geo1_rand(int type)
 {
-  return distrib[type][my_rand() % RAND_MODULO];
+  return distrib[type][my_randn(RAND_MODULO)];
 }
 
 /*
@@ -119,26 +119,212 @@ tim_typ	*get_geo1_table(int i)
 /*
 *	This is the random number generator of IBM (AIX) and DEC (OSF/1)
 *	We reimplement it to be independent of different versions on different platforms
+*
+*	With my_randgen(RAND_XOSHIRO), the 64 bit generator xoshiro256** is used
+*	instead. Each object has its own stream, which is selected by the kernel
+*	when the object is activated by early() or late() (see sim::run()).
+*	rec() is called by the sender and draws from the sender's stream,
+*	unless the receiver selects its own by a randscope (see defs.h).
+*	Random numbers drawn outside of an activation (e.g. during construction)
+*	are taken from RandMaster.
+*	The streams are obtained by jumping 2^128 numbers ahead, starting at the
+*	seed given to my_srand(), in the order of object creation.
+*	With my_randkey(RAND_BYNAME), the stream of a named object is seeded from
+*	the seed and the name instead: an object gets the same stream, however
+*	many objects are created before it (common random numbers in parameter
+*	sweeps, see yats/sweep.lua).
 */
 
 static long int	next = 1;
+static int	RandGen = RAND_LEGACY;
+static unsigned long long RandSeed = 1;
+static int	RandKey = RAND_BYORDER;
+
+randstream	RandMaster;
+THREAD_LOCAL randstream *RandCur = &RandMaster;
+static randstream RandCursor;		// stream for the next object created
+static root	*RandObjs = NULL;	// all objects in order of creation
+static root	**RandTail = &RandObjs;
+
+/*
+*	seed a stream by the splitmix64 generator (as recommended for xoshiro)
+*/
+void randstream::seed(unsigned long long x)
+{
+  int i;
+  for (i = 0; i < 4; ++i) {
+    unsigned long long z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    s[i] = z ^ (z >> 31);
+  }
+}
+
+/*
+*	advance the stream by 2^128 numbers
+*/
+void randstream::jump(void)
+{
+  static const unsigned long long JUMP[] = {
+    0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+    0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+  };
+  unsigned long long s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+  int i, b;
+  for (i = 0; i < 4; ++i)
+    for (b = 0; b < 64; ++b) {
+      if (JUMP[i] & (1ULL << b)) {
+	s0 ^= s[0];
+	s1 ^= s[1];
+	s2 ^= s[2];
+	s3 ^= s[3];
+      }
+      next();
+    }
+  s[0] = s0;
+  s[1] = s1;
+  s[2] = s2;
+  s[3] = s3;
+}
+
+/*
+*	seed the stream of a named object from the seed and the name (FNV-1a)
+*/
+static void rand_keyed(root *obj)
+{
+  unsigned long long h = 0xcbf29ce484222325ULL;
+  const unsigned char *c;
+
+  for (c = (const unsigned char *) obj->name; *c != 0; ++c)
+    h = (h ^ *c) * 0x100000001b3ULL;
+  obj->rng.seed(h ^ (RandSeed * 0xd1b54a32d192ed03ULL));
+}
+
+/*
+*	(re-)derive the streams of all objects from the seed
+*/
+static void rand_streams(void)
+{
+  root *p;
+  RandMaster.seed(RandSeed);
+  RandCursor = RandMaster;
+  RandCursor.jump();
+  for (p = RandObjs; p != NULL; p = p->rng_next) {
+    if (RandKey == RAND_BYNAME && p->name != NULL)
+      rand_keyed(p);
+    else
+      p->rng = RandCursor;
+    RandCursor.jump();
+  }
+}
+
+void rand_register(root *obj)
+{
+  obj->rng_next = NULL;
+  obj->rng_pprev = RandTail;
+  *RandTail = obj;
+  RandTail = &obj->rng_next;
+  if (RandGen == RAND_XOSHIRO) {
+    obj->rng = RandCursor;
+    RandCursor.jump();
+  }
+}
+
+/*
+*	The name of an object has been set (after its construction)
+*/
+void rand_name(root *obj)
+{
+  if (RandGen == RAND_XOSHIRO && RandKey == RAND_BYNAME && obj->name != NULL)
+    rand_keyed(obj);
+}
+
+void rand_unregister(root *obj)
+{
+  if (RandCur == &obj->rng)
+    RandCur = &RandMaster;
+  if ((*obj->rng_pprev = obj->rng_next) != NULL)
+    obj->rng_next->rng_pprev = obj->rng_pprev;
+  else
+    RandTail = obj->rng_pprev;
+}
 
 int	my_rand(void)
 {
-  next = next * 1103515245 + 12345;
-  return (next >> 16) & 32767;
+  if (RandGen == RAND_LEGACY) {
+    next = next * 1103515245 + 12345;
+    return (next >> 16) & 32767;
+  }
+  return (int) (RandCur->next() >> 49);
+}
+
+/*
+*	uniformly distributed in 0 ... n - 1
+*	The legacy generator keeps the historic my_rand() % n.
+*/
+int	my_randn(int n)
+{
+  if (RandGen == RAND_LEGACY)
+    return my_rand() % n;
+  return (int) (((RandCur->next() >> 32) * (unsigned long long) n) >> 32);
+}
+
+unsigned long long my_rand64(void)
+{
+  if (RandGen == RAND_LEGACY)
+    return (unsigned long long) my_rand();
+  return RandCur->next();
 }
 
 // included by Mue: 29.10.1999
 double uniform()
 {
-  return my_rand() / 32767.0;
+  if (RandGen == RAND_LEGACY)
+    return my_rand() / 32767.0;
+  return (RandCur->next() >> 11) * (1.0 / 9007199254740992.0);
 }
 
 
 void my_srand(int seed)
 {
   next = seed;
+  RandSeed = (unsigned long long) seed;
+  if (RandGen == RAND_XOSHIRO)
+    rand_streams();
+}
+
+/*
+*	select the generator: RAND_LEGACY or RAND_XOSHIRO
+*/
+void my_randgen(int gen)
+{
+  if (gen != RAND_LEGACY && gen != RAND_XOSHIRO)
+    errm1d("my_randgen(): unknown random number generator %d", gen);
+  RandGen = gen;
+  if (RandGen == RAND_XOSHIRO)
+    rand_streams();
+}
+
+int	my_getrandgen(void)
+{
+  return RandGen;
+}
+
+/*
+*	select the derivation of the streams: RAND_BYORDER or RAND_BYNAME
+*/
+void my_randkey(int key)
+{
+  if (key != RAND_BYORDER && key != RAND_BYNAME)
+    errm1d("my_randkey(): unknown derivation of streams %d", key);
+  RandKey = key;
+  if (RandGen == RAND_XOSHIRO)
+    rand_streams();
+}
+
+int	my_getrandkey(void)
+{
+  return RandKey;
 }
 
 #endif	/* USE_MY_RAND */
@@ -0,0 +1,209 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+/*
+*	Log-linear histogram, see hdrhist.h
+*
+*	Bucket layout with b = subbits, S = 2^b:
+*	- buckets 0 ... S-1 hold the values 0 ... S-1,
+*	- above, the values with their highest bit at position b-1+k (k >= 1)
+*	  fall into S/2 buckets of width 2^k, bucket index k*S/2 + (v >> k).
+*	Values up to the largest tim_typ need (8*sizeof(tim_typ) - b + 2) * S/2
+*	buckets.
+*/
+
+#include "hdrhist.h"
+
+hdrhist	*hdrhist::all = NULL;
+
+hdrhist::hdrhist(
+	double	relprec)	// relative precision, e.g. 0.01
+{
+	if (relprec <= 0.0 || relprec >= 1.0)
+		errm0("hdrhist: relative precision must be between 0 and 1");
+
+	// 2^-(subbits-1) <= relprec
+	subbits = 2;
+	while (1.0 / (1 << (subbits - 1)) > relprec && subbits < 20)
+		++subbits;
+	sublen = 1ULL << subbits;
+	nbuckets = (8 * (int) sizeof(tim_typ) - subbits + 2) << (subbits - 1);
+
+	CHECK(counts = new unsigned[nbuckets]);
+	pqp[0] = &pq[0];
+	pqp[1] = &pq[1];
+	pqp[2] = &pq[2];
+	reset();
+
+	next = all;
+	all = this;
+}
+
+hdrhist::~hdrhist()
+{
+	hdrhist	**pp;
+
+	for (pp = &all; *pp != NULL; pp = &(*pp)->next)
+		if (*pp == this)
+		{	*pp = next;
+			break;
+		}
+	delete[] counts;
+}
+
+void	hdrhist::reset(void)
+{
+	int	i;
+
+	for (i = 0; i < nbuckets; ++i)
+		counts[i] = 0;
+	count = 0;
+	min = ~0ULL;
+	max = 0;
+	sum = 0.0;
+	*pqp[0] = *pqp[1] = *pqp[2] = 0.0;
+}
+
+/*
+*	Store the exported quantiles elsewhere
+*/
+void	hdrhist::setQuantileOut(
+	double	*p50,
+	double	*p99,
+	double	*p999)
+{
+	pqp[0] = p50;
+	pqp[1] = p99;
+	pqp[2] = p999;
+	refresh();
+	if (count == 0)
+		*pqp[0] = *pqp[1] = *pqp[2] = 0.0;
+}
+
+/*
+*	Lowest and highest value of a bucket
+*/
+double	hdrhist::getBucketLow(
+	int	i)
+{
+	int	half = 1 << (subbits - 1);
+	int	shift;
+
+	if (i < (int) sublen)
+		return i;
+	shift = i / half - 1;
+	return (double) ((unsigned long long) (i - shift * half) << shift);
+}
+
+double	hdrhist::getBucketHigh(
+	int	i)
+{
+	int	half = 1 << (subbits - 1);
+
+	if (i < (int) sublen)
+		return i;
+	return getBucketLow(i) + (double) ((1ULL << (i / half - 1)) - 1);
+}
+
+/*
+*	Value of quantile q: the middle of the bucket which contains the
+*	value of rank ceil(q * count), limited to the observed min and max.
+*/
+double	hdrhist::quantile(
+	double	q)
+{
+	unsigned long long rank, cum;
+	double	v;
+	int	i;
+
+	if (count == 0)
+		return 0.0;
+	if (q <= 0.0)
+		return (double) min;
+	if (q >= 1.0)
+		return (double) max;
+
+	rank = (unsigned long long) (q * count);
+	if (rank < q * count)
+		++rank;
+	if (rank == 0)
+		rank = 1;
+	cum = 0;
+	for (i = 0; i < nbuckets; ++i)
+		if ((cum += counts[i]) >= rank)
+			break;
+	if (i == nbuckets)
+		return (double) max;
+
+	v = (getBucketLow(i) + getBucketHigh(i)) / 2.0;
+	if (v < min)
+		v = min;
+	if (v > max)
+		v = max;
+	return v;
+}
+
+/*
+*	Update the exported quantiles in one pass
+*/
+void	hdrhist::refresh(void)
+{
+	static const double q[3] = {0.5, 0.99, 0.999};
+	unsigned long long rank[3], cum;
+	double	v;
+	int	i, k;
+
+	if (count == 0)
+		return;
+	for (k = 0; k < 3; ++k)
+	{	rank[k] = (unsigned long long) (q[k] * count);
+		if (rank[k] < q[k] * count)
+			++rank[k];
+		if (rank[k] == 0)
+			rank[k] = 1;
+	}
+	cum = 0;
+	k = 0;
+	for (i = 0; i < nbuckets && k < 3; ++i)
+	{	cum += counts[i];
+		while (k < 3 && cum >= rank[k])
+		{	v = (getBucketLow(i) + getBucketHigh(i)) / 2.0;
+			if (v < min)
+				v = min;
+			if (v > max)
+				v = max;
+			*pqp[k++] = v;
+		}
+	}
+}
+
+/*
+*	Refresh the quantiles of all histograms, called at the end of
+*	sim::run(): exported values are up to date between runs.
+*/
+void	hdrhist::refreshAll(void)
+{
+	hdrhist	*h;
+
+	for (h = all; h != NULL; h = h->next)
+		h->refresh();
+}
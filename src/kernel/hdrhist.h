@@ -0,0 +1,109 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+#ifndef	_HDRHIST_H_
+#define	_HDRHIST_H_
+
+#include "defs.h"
+
+/*
+*	Log-linear histogram (HDR histogram) of non-negative integer values,
+*	e.g. transfer delays or inter arrival times in slots.
+*
+*	Values below 2^subbits are counted exactly. Above, each power of two
+*	is divided into 2^(subbits-1) buckets of equal width, i.e. a value is
+*	known with the relative precision given to the constructor. The whole
+*	range of tim_typ is covered with a few thousand counters, independent
+*	of the largest value expected.
+*
+*	unsigned hdrhist::add(v)		add a value, returns the new
+*						bucket count (0: overflow)
+*	double	hdrhist::quantile(q)		value of quantile q (0 ... 1)
+*
+*	The quantiles p50, p99 and p99.9 are kept in pq[] for export. They are
+*	updated every HDR_REFRESH values, by refresh() and, for all histograms,
+*	by refreshAll() at the end of sim::run(). setQuantileOut() redirects
+*	them, e.g. into the per-index arrays of meas3.
+*/
+
+#define	HDR_REFRESH	(4096)		// must be a power of two
+
+//tolua_begin
+class	hdrhist {
+public:
+  hdrhist(double relprec = 0.01);
+  ~hdrhist();
+  void reset(void);
+  double quantile(double q);
+  double getCount(void) {return count;}
+  double getMin(void) {return count > 0 ? (double) min : 0.0;}
+  double getMax(void) {return count > 0 ? (double) max : 0.0;}
+  double getMean(void) {return count > 0 ? sum / count : 0.0;}
+  double getPrecision(void) {return 1.0 / (1 << (subbits - 1));}
+  int getLen(void) {return nbuckets;}
+  int getBucket(int i) {return (i >= 0 && i < nbuckets) ? (int) counts[i] : 0;}
+  double getBucketLow(int i);
+  double getBucketHigh(int i);
+  void refresh(void);
+  static void refreshAll(void);
+  //tolua_end
+
+  void setQuantileOut(double *p50, double *p99, double *p999);
+
+  inline unsigned add(tim_typ t)
+  {
+    unsigned long long v = t;
+    int i;
+    if (v < sublen)
+      i = (int) v;
+    else {
+      // shift: number of low order bits dropped
+      int shift = 64 - __builtin_clzll(v) - subbits;
+      i = ((shift + 1) << (subbits - 1)) + (int) (v >> shift) - (1 << (subbits - 1));
+    }
+    if (v < min)
+      min = v;
+    if (v > max)
+      max = v;
+    sum += (double) v;
+    if ((++count & (HDR_REFRESH - 1)) == 0)
+      refresh();
+    return ++counts[i];
+  }
+
+  unsigned *counts;	// bucket counters
+  int	nbuckets;	// # of buckets
+  int	subbits;	// bits of precision
+  unsigned long long sublen;	// 2^subbits: values counted exactly
+  unsigned long long count;	// # of values
+  unsigned long long min;
+  unsigned long long max;
+  double sum;
+  double pq[3];		// p50, p99, p99.9
+  double *pqp[3];	// where refresh() stores them, default: pq
+
+private:
+  hdrhist *next;	// all histograms
+  static hdrhist *all;
+};
+
+#endif	// _HDRHIST_H_
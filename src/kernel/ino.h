@@ -104,6 +104,14 @@ public:
     return type_check_table[type][pd->type];
   }
 
+  // For objects taking any data item, but accounting per cell (buffers,
+  // losses, delays): an aal5Train would count as one cell.
+  inline void traincheck(data *pd)
+  {
+    if (pd->type == AAL5TrainType)
+      errm1s("%s: cell train received, use aal5split in front", (char*) name);
+  }
+
   inline void chkStartStop(rec_typ	x)
   {
     if (x != ContSend && x != StopSend)
@@ -111,13 +119,13 @@ public:
 	     "return neither ContSend nor StopSend", (char*) name);
   }
 //tolua_begin
-  inline unsigned int getCounter(void) {return counter;}
+  inline cnt_typ getCounter(void) {return counter;}
   inline void resCounter(void) {counter = 0;}
-  inline void setCounter(unsigned int n) {counter = n;}
+  inline void setCounter(cnt_typ n) {counter = n;}
   inline unsigned int getVCI(void) {return vci;}
   inline void setVCI(int vci) {this->vci = vci;}
 
-  unsigned int counter;	// a counter for common use
+  cnt_typ counter;	// a counter for common use
   unsigned int ival0;
   unsigned int ival1;
   unsigned int ival2;
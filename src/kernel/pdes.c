@@ -0,0 +1,411 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+/*
+*	Conservative parallel simulation (compiled with PDES)
+*
+*	The objects are divided into partitions (root::lp, assigned by
+*	sim:setPartitions()). Partitions are only connected by line objects:
+*	a data object sent to a line of another partition arrives there not
+*	before the delay of the line. The smallest of these delays is the
+*	lookahead L.
+*
+*	sim::run() simulates in windows of L slots. Each partition is run by
+*	its own thread with its own calendar (partition 0 by the main thread).
+*	During a window, data objects for lines of other partitions are posted
+*	to mailboxes (pdes_post()). At the beginning of the next window, the
+*	receiving thread calls the lines with the posted data objects, SimTime
+*	set back to the time of sending. The line registers for the delivery
+*	at SimTime + delay, which is not earlier than the current window.
+*
+*	The mailboxes are double-buffered: posting of window k and receiving of
+*	window k - 1 use different buffers. The windows are separated by two
+*	barriers (start and end of window), the main thread decides on the
+*	next window in between.
+*
+*	The results are reproducible for the same seed and the same
+*	partitions. They differ from the sequential run, since the order of
+*	activations within a slot changes with the partitions.
+*
+*	Restrictions:
+*	- The object streams of random numbers (RAND_XOSHIRO) are required.
+*	- No profiling (sim::SetProfile()).
+*	- Objects coupled by other means than data objects (pointers to other
+*	  objects, special(), Lua objects) have to be in the same partition.
+*	- sim::stop() takes effect at the end of the current window.
+*	- An error in a worker thread terminates the program. An error in the
+*	  main thread (partition 0) ends the parallel run by pdes_abort() before
+*	  the Lua error unwinds sim::run().
+*/
+
+#include "defs.h"
+#include "sim.h"
+
+#ifdef PDES
+#include <pthread.h>
+
+// commands of the main thread to the workers
+#define PDES_BEGIN	(0)
+#define PDES_WINDOW	(1)
+#define PDES_END	(2)
+#define PDES_QUIT	(3)
+
+struct	pdes_msg {
+	root	*to;		// receiver
+	data	*pd;
+	int	key;
+	tim_typ	time;		// SimTime when sent
+};
+
+struct	pdes_mbox {
+	pdes_msg *msg;
+	int	len;
+	int	size;
+};
+
+// events of a partition, handed over at begin and end of a run
+struct	pdes_evts {
+	event	*early;
+	event	*late;
+	event	*each_e;
+	event	*each_l;
+	event	*wake;		// woken by wakel()
+};
+
+THREAD_LOCAL int CurPart = -1;
+
+static	int	PdesParts = 1;		// # of partitions
+static	tim_typ	PdesLookahead = 0;	// length of a window, 0: unlimited
+static	int	PdesThreads = 1;	// # of running threads (incl. the main thread)
+static	pthread_t PdesTid[PDES_MAX];
+static	pthread_barrier_t PdesGo;	// start of a command
+static	pthread_barrier_t PdesDone;	// end of a command
+static	int	PdesCmd;
+static	int	PdesLen;		// length of the window
+static	tim_typ	PdesStart;		// SimTime at begin of the run
+static	volatile int PdesStop;		// sim::stop() called in a window
+static	pdes_mbox *PdesMbox[2];		// [parity][src * PdesThreads + dst]
+static	THREAD_LOCAL int PdesParity;	// buffers of the current window
+static	pdes_evts PdesEvts[PDES_MAX];
+static	int	PdesInCmd;		// main thread between PdesGo and PdesDone
+
+/*
+*	Set the number of partitions and the lookahead (0: unlimited)
+*/
+void	pdes_set(
+	int	n,
+	tim_typ	lookahead)
+{
+	if (n < 1 || n > PDES_MAX)
+		errm1d("sim::SetPartitions(): number of partitions must be 1 ... %d", PDES_MAX);
+	PdesParts = n;
+	PdesLookahead = lookahead;
+}
+
+int	pdes_parts(void)
+{
+	return PdesParts;
+}
+
+void	pdes_stop(void)
+{
+	PdesStop = TRUE;
+}
+
+/*
+*	Called in a child process after fork(): only the main thread has been
+*	copied, the workers are started again by the next parallel run.
+*/
+void	pdes_forked(void)
+{
+	int	i;
+
+	PdesThreads = 1;
+	for (i = 0; i < 2; ++i)
+		PdesMbox[i] = NULL;
+}
+
+/*
+*	Called by the receiver (line::rec()) if the sender runs in another
+*	partition: deliver pd in the next window
+*/
+void	pdes_post(
+	root	*to,
+	data	*pd,
+	int	key)
+{
+	pdes_mbox *b;
+	pdes_msg *m;
+	int	i;
+
+	if (to->lp < 0 || to->lp >= PdesThreads)
+		errm1s1d("%s: partition %d out of range", to->name, to->lp);
+	b = PdesMbox[PdesParity] + CurPart * PdesThreads + to->lp;
+	if (b->len == b->size)
+	{	b->size = b->size == 0 ? 64 : 2 * b->size;
+		CHECK(m = new pdes_msg[b->size]);
+		for (i = 0; i < b->len; ++i)
+			m[i] = b->msg[i];
+		delete[] b->msg;
+		b->msg = m;
+	}
+	m = b->msg + b->len++;
+	m->to = to;
+	m->pd = pd;
+	m->key = key;
+	m->time = SimTime;
+}
+
+/*
+*	Deliver the data objects posted to the running partition in
+*	buffer parity, in the order of the sending partitions
+*/
+static	void	pdes_drain(
+	int	parity)
+{
+	tim_typ	now = SimTime;
+	pdes_mbox *b;
+	pdes_msg *m;
+	int	src, i;
+
+	TimeType = EARLY;
+	for (src = 0; src < PdesThreads; ++src)
+	{	b = PdesMbox[parity] + src * PdesThreads + CurPart;
+		for (i = 0, m = b->msg; i < b->len; ++i, ++m)
+		{	SimTime = m->time;
+			SimTimeReal = SimTime * SlotLength;
+			RandCur = &m->to->rng;
+			m->to->rec(m->pd, m->key);
+		}
+		b->len = 0;
+	}
+	SimTime = now;
+	SimTimeReal = SimTime * SlotLength;
+	RandCur = &RandMaster;
+}
+
+/*
+*	Execute a command for the partition of the running thread
+*/
+static	void	pdes_exec(
+	int	part)
+{
+	pdes_evts *pe = PdesEvts + part;
+
+	switch (PdesCmd) {
+	case PDES_BEGIN:
+		CurPart = part;
+		PdesParity = 0;
+		if (part != 0)
+		{	SimTime = PdesStart;
+			SimTimeReal = SimTime * SlotLength;
+		}
+		evt_give(pe->early, pe->late, pe->each_e, pe->each_l, pe->wake);
+		break;
+	case PDES_WINDOW:
+		PdesParity ^= 1;
+		pdes_drain(PdesParity ^ 1);
+		run_window(PdesLen);
+		break;
+	case PDES_END:
+		pdes_drain(PdesParity);
+		evt_take(&pe->early, &pe->late, &pe->each_e, &pe->each_l, &pe->wake);
+		if (part != 0)
+			evt_count_merge();
+		CurPart = -1;
+		break;
+	}
+}
+
+static	void	*pdes_worker(
+	void	*arg)
+{
+	int	part = (int) (long) arg;
+
+	for (;;)
+	{	pthread_barrier_wait(&PdesGo);
+		if (PdesCmd == PDES_QUIT)
+			break;
+		pdes_exec(part);
+		pthread_barrier_wait(&PdesDone);
+	}
+	return NULL;
+}
+
+// let all threads (incl. the main thread) execute cmd
+static	void	pdes_command(
+	int	cmd)
+{
+	PdesCmd = cmd;
+	pthread_barrier_wait(&PdesGo);
+	PdesInCmd = TRUE;
+	pdes_exec(0);
+	PdesInCmd = FALSE;
+	pthread_barrier_wait(&PdesDone);
+}
+
+/*
+*	(Re-)start the worker threads for PdesParts partitions
+*/
+static	void	pdes_threads(void)
+{
+	int	i;
+
+	if (PdesThreads == PdesParts)
+		return;
+	if (PdesThreads > 1)
+	{	PdesCmd = PDES_QUIT;
+		pthread_barrier_wait(&PdesGo);
+		for (i = 1; i < PdesThreads; ++i)
+			pthread_join(PdesTid[i], NULL);
+		pthread_barrier_destroy(&PdesGo);
+		pthread_barrier_destroy(&PdesDone);
+		for (i = 0; i < 2; ++i)
+			delete[] PdesMbox[i];	// all buffers are empty
+	}
+	PdesThreads = PdesParts;
+	for (i = 0; i < 2; ++i)
+	{	CHECK(PdesMbox[i] = new pdes_mbox[PdesThreads * PdesThreads]);
+		memset(PdesMbox[i], 0, PdesThreads * PdesThreads * sizeof(pdes_mbox));
+	}
+	pthread_barrier_init(&PdesGo, NULL, PdesThreads);
+	pthread_barrier_init(&PdesDone, NULL, PdesThreads);
+	for (i = 1; i < PdesThreads; ++i)
+		if (pthread_create(&PdesTid[i], NULL, pdes_worker, (void *) (long) i) != 0)
+			errm1d("sim::run(): can't create thread for partition %d", i);
+}
+
+// split a list of events by partitions, keeping the order
+static	void	pdes_split(
+	event	*l,
+	int	which)		// 0: early, 1: late, 2: each_e, 3: each_l, 4: wake
+{
+	event	**tail[PDES_MAX];
+	event	*p;
+	int	i;
+
+	for (i = 0; i < PdesParts; ++i)
+	{	tail[i] = which == 0 ? &PdesEvts[i].early : which == 1 ? &PdesEvts[i].late :
+			which == 2 ? &PdesEvts[i].each_e : which == 3 ? &PdesEvts[i].each_l :
+			&PdesEvts[i].wake;
+		*tail[i] = NULL;
+	}
+	while ((p = l) != NULL)
+	{	l = p->next;
+		i = p->obj->lp;
+		if (i < 0 || i >= PdesParts)
+			errm1s1d("%s: partition %d out of range", p->obj->name, i);
+		p->next = NULL;
+		*tail[i] = p;
+		tail[i] = &p->next;
+	}
+}
+
+/*
+*	Begin of a parallel run: distribute the events of the main thread
+*/
+void	pdes_begin(void)
+{
+	event	*early, *late, *each_e, *each_l, *wake;
+
+	if (my_getrandgen() != RAND_XOSHIRO)
+		errm0("sim::run(): parallel simulation needs the random generator RAND_XOSHIRO");
+	if (Profiling)
+		errm0("sim::run(): no profiling with parallel simulation");
+	pdes_threads();
+	pool_shared();
+
+	evt_take(&early, &late, &each_e, &each_l, &wake);
+	pdes_split(early, 0);
+	pdes_split(late, 1);
+	pdes_split(each_e, 2);
+	pdes_split(each_l, 3);
+	pdes_split(wake, 4);
+	PdesStart = SimTime;
+	PdesStop = FALSE;
+	pdes_command(PDES_BEGIN);
+}
+
+/*
+*	Simulate one window of at most nSlots slots in all partitions.
+*	Returns the number of slots simulated.
+*/
+int	pdes_window(
+	int	nSlots)
+{
+	if (PdesLookahead != 0 && (tim_typ) nSlots > PdesLookahead)
+		nSlots = (int) PdesLookahead;
+	PdesLen = nSlots;
+	pdes_command(PDES_WINDOW);
+	if (PdesStop)
+		_sim.stop();
+	return nSlots;
+}
+
+/*
+*	End of a parallel run: collect the events of all partitions
+*/
+void	pdes_end(void)
+{
+	pdes_evts *pe;
+	int	i;
+
+	pdes_command(PDES_END);
+	for (i = 0, pe = PdesEvts; i < PdesThreads; ++i, ++pe)
+		evt_give(pe->early, pe->late, pe->each_e, pe->each_l, pe->wake);
+}
+
+/*
+*	Error in the main thread during a parallel run (called by the error
+*	routines before the Lua error unwinds sim::run()): complete the
+*	current command, such that the workers do not block in PdesDone, and
+*	end the run. The workers then wait for the next run as usual.
+*	An error while ending the run calls pdes_abort() again, with PdesCmd
+*	== PDES_END.
+*/
+void	pdes_abort(void)
+{
+	pdes_evts *pe;
+	int	i, k;
+
+	if (CurPart != 0)
+		return;
+	if (PdesInCmd)
+	{	PdesInCmd = FALSE;
+		pthread_barrier_wait(&PdesDone);
+	}
+	if (PdesCmd != PDES_END)
+	{	pdes_end();
+		return;
+	}
+	// Error in pdes_drain() of the main thread: the workers have handed
+	// over their events, those of the main thread are still in its
+	// calendar. Data objects not delivered yet are dropped.
+	for (k = 0; k < 2; ++k)
+		for (i = 0; i < PdesThreads; ++i)
+			PdesMbox[k][i * PdesThreads].len = 0;
+	CurPart = -1;
+	for (i = 1, pe = PdesEvts + 1; i < PdesThreads; ++i, ++pe)
+		evt_give(pe->early, pe->late, pe->each_e, pe->each_l, pe->wake);
+}
+
+#endif	// PDES
@@ -0,0 +1,140 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+#ifndef	_PQUEUE_H_
+#define	_PQUEUE_H_
+
+#include "defs.h"
+
+/*
+*	Sort queue (binary heap) ordered by the member time of the items.
+*
+*	Replacement for sort queues built with uqueue::enqTime() or
+*	uoqueue::enqTime(), which search the insert position linearly.
+*	Here, enqTime() and dequeue() take O(log n).
+*
+*	The order of items with equal time is the same as in the list:
+*	enqTime() puts an item in front of all items with the same time, i.e.
+*	the item enqueued last leaves first.
+*
+*	The time of a queued item must not be changed, with one exception:
+*	the times of all items may be shifted by the same amount (as done by
+*	the restim() methods of the WFQ multiplexers).
+*
+*	T is either data (cells, frames, ...) or root (objects, e.g. ino).
+*
+*	void	pqueue::enqTime(T *p);
+*	T	*pqueue::dequeue(void);		NULL, if the queue is empty
+*	T	*pqueue::first(void);		NULL, if the queue is empty
+*	int	pqueue::isEmpty(void);
+*	int	pqueue::getlen(void);
+*/
+
+template <class T> class pqueue {
+public:
+  inline pqueue(void)
+  {
+    q_len = 0;
+    q_size = 0;
+    q_seq = 0;
+    heap = NULL;
+  }
+  inline ~pqueue() {delete[] heap;}
+
+  inline void enqTime(T *p)
+  {
+    int i, parent;
+    entry e;
+    if (q_len == q_size)
+      grow();
+    e.item = p;
+    e.seq = q_seq++;
+    // sift up
+    for (i = q_len++; i > 0; i = parent) {
+      parent = (i - 1) >> 1;
+      if ( !before(e, heap[parent]))
+	break;
+      heap[i] = heap[parent];
+    }
+    heap[i] = e;
+  }
+
+  inline T *dequeue(void)
+  {
+    int i, child;
+    T *p;
+    entry e;
+    if (q_len == 0)
+      return NULL;
+    p = heap[0].item;
+    e = heap[ --q_len];
+    // sift down the last entry from the root
+    for (i = 0; (child = 2 * i + 1) < q_len; i = child) {
+      if (child + 1 < q_len && before(heap[child + 1], heap[child]))
+	++child;
+      if ( !before(heap[child], e))
+	break;
+      heap[i] = heap[child];
+    }
+    heap[i] = e;
+    return p;
+  }
+
+  inline T *first(void)
+  {
+    return q_len == 0 ? (T *) 0 : heap[0].item;
+  }
+  inline int isEmpty(void) {return q_len == 0;}
+  inline int getlen(void) {return q_len;}
+
+  int	q_len;	// public, since it is sometimes exported for displaying
+
+private:
+  struct entry {
+    T *item;
+    unsigned long long seq;	// enqueue order
+  };
+  // ordering: increasing time, for equal time the newest first
+  static inline int before(const entry &a, const entry &b)
+  {
+    if (a.item->time != b.item->time)
+      return a.item->time < b.item->time;
+    return a.seq > b.seq;
+  }
+  void grow(void)
+  {
+    entry *h;
+    int i;
+    q_size = q_size == 0 ? 16 : 2 * q_size;
+    CHECK(h = new entry[q_size]);
+    for (i = 0; i < q_len; ++i)
+      h[i] = heap[i];
+    delete[] heap;
+    heap = h;
+  }
+
+  int	q_size;
+  unsigned long long q_seq;
+  entry	*heap;
+};
+
+#endif	// _PQUEUE_H_
@@ -47,13 +47,19 @@
 root::root(void)
 {
   name = (char *) "<name: unknown>";
+  lp = 0;
+  prof = NULL;
+  rand_register(this);
 #ifdef	RECEIVE_DEBUG
 	recDbgList = NULL;
 #endif
 }
 root::~root()
 {
-  dprintf("%d root destruct: %s\n", SimTime, this->name);
+  dprintf(TIM_FMT " root destruct: %s\n", SimTime, this->name);
+  rand_unregister(this);
+  if (prof != NULL)
+    prof_delete(prof);
 }
 void	root::init(void)
 {
@@ -162,6 +168,25 @@ rec_typ	root::recTrac(
 	return this->recTracOri(pd, iKey, (void *(*)()) NULL);
 }
 #endif	// DATA_OBJECT_TRACE
+
+#ifdef	OBJECT_PROFILE
+rec_typ	root::recProf(
+	data	*pd,
+	int	iKey,
+	root	*)
+{
+	profdata	*prev;
+	rec_typ		ret;
+
+	if ( !Profiling)
+		return this->recProfOri(pd, iKey, (void *(*)()) NULL);
+	prev = prof_enter(this);
+	++prof->nrec;
+	ret = this->recProfOri(pd, iKey, (void *(*)()) NULL);
+	prof_leave(prev);
+	return ret;
+}
+#endif	// OBJECT_PROFILE
 	
 
 
@@ -82,6 +82,46 @@
 * hash table entry.
 * Unalarmx() now has both lists available to go through: the entry of the hash table (determined
 * by the time of the event to delete) and - if not found there - the early_now/late_now pointers.
+* Meanwhile, each registered event carries a back pointer (event::pprev) to the pointer
+* referencing it - wherever this is: hash table, early_now/late_now, or the lists of the timing
+* wheel. Thus, unalarmx() does not need to look for the event any longer, it simply unlinks it.
+* realarme() / realarml() move a (possibly registered) event to a new activation time.
+*
+* Timing wheel (EVT_WHEEL):
+* Events looking ahead TIME_LEN slots or more are re-scanned in every revolution of the
+* calendar. With small slot lengths (e.g. TCP timers at microsecond slots) this costs
+* a lot. With the timing wheel backend enabled, such events are not put into the calendar
+* but into a far wheel with FAR_LEN positions, each of them covering one full revolution
+* of the calendar (TIME_LEN slots). Events even further ahead go into an overflow list.
+* At the beginning of each revolution the far wheel position of this revolution is
+* cascaded into the calendar, every FAR_LEN revolutions the overflow list is
+* redistributed. Thus, a far event is touched at most twice before it is activated.
+* The calendar itself is unchanged, hence all events in the calendar are due within
+* the current revolution.
+*
+* Profiling:
+* With sim::SetProfile(TRUE), each activation is counted per object, and the processor
+* cycles (TSC) between activations are charged to the running object. Cycles spent in
+* the kernel itself are charged to the simulator object. prof_enter() / prof_leave()
+* switch between objects; they are also used for rec() when compiled with OBJECT_PROFILE.
+*
+* Lazy activation in each slot (lazyl(), wakel()):
+* Objects like multiplexers only have work in their late phase if data has arrived
+* (or is still queued). Instead of eachl(), they register with lazyl() and call wakel()
+* for each arrival. The woken events are kept in a bit set indexed by the rank of
+* registration (with a summary bit per word), and merged with the list of eachl() when
+* the late phases of each slot are processed. Thus, the order of activation is the same as with eachl(), but idle
+* objects are not activated at all. An event woken after its place in the list has been
+* passed is activated in the next slot.
+*
+* End of slot (slotend()):
+* Observers of the state of a slot (e.g. the importance watcher of RESTART) register
+* with slotend(). They are activated after all late activations of each slot.
+*
+* Parallel simulation (PDES):
+* All of the above except slotend() is thread-local. With sim::SetPartitions(n > 1), sim::run() hands
+* the events of each partition over to a thread and simulates in windows of
+* lookahead slots (see pdes.c). The events are taken back at the end of the run.
 */
 
 #include "defs.h"
@@ -89,17 +129,59 @@
 //#define EVENT_LOG (0) // turn event logging on. The value determines the
 // SimTime when to begin logging
 #include "sim.h"
+#include "hdrhist.h"
 
 // Debugging flag - need to improve this to a full featured log
 bool cdebug = false;
 
 // hash tables for event lists
-event *eventse[TIME_LEN];
-event *eventsl[TIME_LEN];
+THREAD_LOCAL event *eventse[TIME_LEN];
+THREAD_LOCAL event *eventsl[TIME_LEN];
 
 // lists of objects registered for activation in each time slot
-static event *timee = NULL;
-static event *timel = NULL;
+static THREAD_LOCAL event *timee = NULL;
+static THREAD_LOCAL event *timel = NULL;
+// registered by slotend(): activated at the end of each slot (sequential runs)
+static event *timex = NULL;
+
+// lazy activation in the late phase: events woken by wakel(), one bit per rank
+static unsigned int EvtRank = 0;  // last rank given by eache(), eachl(), lazyl()
+static event **wake_evt = NULL;  // events registered by lazyl(), indexed by rank
+static unsigned int wake_evt_size = 0;
+static THREAD_LOCAL unsigned long long *wake_bits = NULL;  // bit set: woken
+static THREAD_LOCAL unsigned long long *wake_sum = NULL;  // bit set: word of wake_bits not zero
+static THREAD_LOCAL unsigned long long *wake_next = NULL;  // bit set: woken for the next slot
+static THREAD_LOCAL unsigned long long *wake_nsum = NULL;  // bit set: word of wake_next not zero
+static THREAD_LOCAL unsigned int wake_words = 0;  // length of wake_bits and wake_next
+static THREAD_LOCAL int wake_cnt = 0;  // # of woken events (wake_bits)
+static THREAD_LOCAL int wake_ncnt = 0;  // # of woken events (wake_next)
+#define WAKE_ANY (~0U)
+static THREAD_LOCAL unsigned int wake_cursor = WAKE_ANY;  // rank of the running late() of each slot
+static event *wake_mark;  // event::pprev of woken events
+
+// timing wheel for events beyond the calendar
+int EventWheel = FALSE;  // TRUE: timing wheel backend active
+
+struct farwheel {
+   event *far[FAR_LEN];  // each position keeps the events of one revolution
+   event *ovfl;  // events beyond the wheel
+};
+static THREAD_LOCAL farwheel wheele;
+static THREAD_LOCAL farwheel wheell;
+static THREAD_LOCAL tim_typ wheel_rev = 0;  // last revolution cascaded into the calendar
+
+// occupancy bitmap for skipping empty slots
+THREAD_LOCAL unsigned long long eventmap[TIME_LEN / EVT_MAP_BITS + 1];
+static int SlotSkip = FALSE;  // TRUE: jump over empty slots if possible (sim:setSlotSkip())
+
+// per-object profiling
+int Profiling = FALSE;  // TRUE: count activations and cycles per object
+static THREAD_LOCAL unsigned long long EvtCount = 0;  // # of activations (early() and late())
+#ifdef PDES
+static unsigned long long EvtCountPar = 0;  // # of activations in worker threads
+#endif
+static THREAD_LOCAL profdata *prof_cur = NULL;  // profiling data of the running object
+static THREAD_LOCAL unsigned long long prof_t0;  // when prof_cur has been entered
 
 #ifdef EVENT_DEBUG 
 // true if Run command is in execution
@@ -123,19 +205,47 @@ sim _sim;
 
 root *sim_ptr = &_sim;
 
-tim_typ SimTime; // Simulation clock
+THREAD_LOCAL tim_typ SimTime; // Simulation clock
 double SlotLength; // length of a slot in seconds
-double SimTimeReal;
-int TimeType; // early or late phase?
+THREAD_LOCAL double SimTimeReal;
+THREAD_LOCAL int TimeType; // early or late phase?
 
-static event *early_now = NULL;
-static event *late_now = NULL;
+static THREAD_LOCAL event *early_now = NULL;
+static THREAD_LOCAL event *late_now = NULL;
 
 static void ResetTime(void);
+static int run_revolution(int);
+static event *wake_pop(void);
+static void wake_shift(void);
 
 static int connect_flag = 0; // objects already connected?
 int already_connected(void) { return connect_flag;} // used by parse.c::stat()
 
+// count and optionally delete the events of a list
+static int flushlist(event *ev, int del, int i)
+{
+  int cnt = 0;
+  event *_ev;
+  while (ev){
+    cnt = cnt + 1;
+    _ev = ev->next;
+    ev->pprev = NULL;
+    if (del > 0) {
+      if ((ev->dyn == MAGICEVT) && (ev->dynchk == MAGICEVTCHK)){
+	dprintf("Dynamic event in timeslot %d: deleted.\n", i);
+	delete(ev);
+      } 
+      else if (ev->stat == 12345678) {
+	dprintf("Static event in timeslot %d: not deleted.\n", i);
+      } else {
+	dprintf("Unmarked event in timeslot %d: not deleted.\n", i);
+      }
+    }
+    ev = _ev;
+  }
+  return cnt;
+}
+
 int flushevents(int del)
 {
   int i,j;
@@ -143,31 +253,33 @@ int flushevents(int del)
   event *ev, *_ev;
   for (j = 0; j < 2; j++){
     for (i = 0; i < TIME_LEN; i++){
-      ev = (j == 0) ? eventsl[i] : eventse[i];
-      while (ev){
-	cnt = cnt + 1;
-	_ev = ev->next;
-	if (del > 0) {
-	  if ((ev->dyn == MAGICEVT) && (ev->dynchk == MAGICEVTCHK)){
-	    dprintf("Dynamic event in timeslot %d: deleted.\n", i);
-	    delete(ev);
-	  } 
-	  else if (ev->stat == 12345678) {
-	    dprintf("Static event in timeslot %d: not deleted.\n", i);
-	  } else {
-	    dprintf("Unmarked event in timeslot %d: not deleted.\n", i);
-	  }
-	}
-	ev = _ev;
-      }
+      cnt += flushlist((j == 0) ? eventsl[i] : eventse[i], del, i);
       if (j == 0)
 	eventsl[i] = NULL;
       else
 	eventse[i] = NULL;
     }
   }
+  for (i = 0; i < FAR_LEN; i++){
+    cnt += flushlist(wheele.far[i], del, -1);
+    cnt += flushlist(wheell.far[i], del, -1);
+    wheele.far[i] = wheell.far[i] = NULL;
+  }
+  cnt += flushlist(wheele.ovfl, del, -1);
+  cnt += flushlist(wheell.ovfl, del, -1);
+  wheele.ovfl = wheell.ovfl = NULL;
+  memset(eventmap, 0, sizeof(eventmap));
   timee = NULL;
   timel = NULL;
+  wake_shift();
+  for (_ev = NULL; wake_cnt > 0; ) {
+    ev = wake_pop();
+    ev->next = _ev;
+    _ev = ev;
+  }
+  cnt += flushlist(_ev, del, -1);
+  cnt += flushlist(timex, del, -1);
+  timex = NULL;
   early_now = NULL;
   late_now = NULL;
   return cnt;
@@ -180,6 +292,7 @@ void eache(
    check_evt(e, 1, Eache);
 #endif
 
+   e->rank = ++EvtRank;
    e->next = timee;
    timee = e;
 }
@@ -192,66 +305,516 @@ void eachl(
    check_evt(e, 1, Eachl);
 #endif
 
+   e->rank = ++EvtRank;
    e->next = timel;
    timel = e;
 }
 
-// try to delete an event from a list
-static int del_evt(
-   event *evt,  // the event
-   event **pp) // the list
+// register for activation in the late slot phase, if woken by wakel()
+void lazyl(
+   event *e)
+{
+   event **p;
+   unsigned int i;
+
+#ifdef EVENT_DEBUG
+   check_evt(e, 1, Lazyl);
+#endif
+
+   e->rank = ++EvtRank;
+   if (e->rank >= wake_evt_size) {
+      CHECK(p = new event *[2 * e->rank]);
+      for (i = 0; i < wake_evt_size; ++i)
+         p[i] = wake_evt[i];
+      delete[] wake_evt;
+      wake_evt = p;
+      wake_evt_size = 2 * e->rank;
+   }
+   wake_evt[e->rank] = e;
+}
+
+// register for activation at the end of every slot, after all late
+// activations of the slot (including eachl() and lazyl()): the object sees
+// the final state of the slot. The event is passed to late() (or its handler).
+// Not activated in the windows of a parallel run (see PDES).
+void slotend(
+   event *e)
+{
+#ifdef EVENT_DEBUG
+   check_evt(e, 1, Slotend);
+#endif
+
+   evt_link(&timex, e);
+}
+
+// remove an event registered by slotend(), also allowed during its activation
+void unslotend(
+   event *e)
+{
+   if (e->pprev != NULL)
+      evt_unlink(e);
+#ifdef EVENT_DEBUG
+   e->used = FALSE;
+#endif
+}
+
+// make room for rank r in the bit sets, in steps of 4096 ranks
+static void wake_grow(
+   unsigned int r)
 {
-   while ( *pp != NULL)
-   {
-      if ( *pp == evt) {
-         *pp = evt->next;
-         return 1;
+   unsigned int n, i;
+   unsigned long long *b, *m, *x, *y;
+
+   n = ((r >> 12) + 1) * 64;
+   CHECK(b = new unsigned long long[n]);
+   CHECK(x = new unsigned long long[n]);
+   CHECK(m = new unsigned long long[n / 64]);
+   CHECK(y = new unsigned long long[n / 64]);
+   memset(b, 0, n * sizeof(*b));
+   memset(x, 0, n * sizeof(*x));
+   memset(m, 0, n / 64 * sizeof(*m));
+   memset(y, 0, n / 64 * sizeof(*y));
+   for (i = 0; i < wake_words; ++i) {
+      b[i] = wake_bits[i];
+      x[i] = wake_next[i];
+   }
+   for (i = 0; i < wake_words / 64; ++i) {
+      m[i] = wake_sum[i];
+      y[i] = wake_nsum[i];
+   }
+   delete[] wake_bits;
+   delete[] wake_next;
+   delete[] wake_sum;
+   delete[] wake_nsum;
+   wake_bits = b;
+   wake_next = x;
+   wake_sum = m;
+   wake_nsum = y;
+   wake_words = n;
+}
+
+// woken events: set the bit of the rank
+static void wake_push(
+   event *evt)
+{
+   unsigned int r = evt->rank;
+
+   if ((r >> 6) >= wake_words)
+      wake_grow(EvtRank);
+   wake_bits[r >> 6] |= 1ULL << (r & 63);
+   wake_sum[r >> 12] |= 1ULL << ((r >> 6) & 63);
+   ++wake_cnt;
+}
+
+// end of the late phase: the events woken for the next slot are due
+static void wake_shift(void)
+{
+   unsigned int i, w;
+   unsigned long long m;
+
+   if (wake_ncnt == 0)
+      return;
+   for (i = 0; i < wake_words / 64; ++i) {
+      for (m = wake_nsum[i]; m != 0; m &= m - 1) {
+         w = i * 64 + __builtin_ctzll(m);
+         wake_bits[w] |= wake_next[w];
+         wake_next[w] = 0;
       }
-      pp = & (*pp)->next;
+      wake_sum[i] |= wake_nsum[i];
+      wake_nsum[i] = 0;
    }
-   return 0;
+   wake_cnt += wake_ncnt;
+   wake_ncnt = 0;
+}
+
+// highest rank woken (wake_cnt > 0)
+static inline unsigned int wake_top(void)
+{
+   unsigned int i = wake_words / 64;
+   unsigned int w;
+
+   while (wake_sum[--i] == 0)
+      ;
+   w = i * 64 + 63 - __builtin_clzll(wake_sum[i]);
+   return w * 64 + 63 - __builtin_clzll(wake_bits[w]);
+}
+
+// clear the bit of rank r, return the event
+static inline event *wake_take(
+   unsigned int r)
+{
+   if ((wake_bits[r >> 6] &= ~(1ULL << (r & 63))) == 0)
+      wake_sum[r >> 12] &= ~(1ULL << ((r >> 6) & 63));
+   --wake_cnt;
+   return wake_evt[r];
+}
+
+static event *wake_pop(void)
+{
+   return wake_take(wake_top());
+}
+
+// unalarml() / realarml() of an event woken by wakel(): clear its bit
+static void wake_remove(
+   event *evt)
+{
+   unsigned int r = evt->rank;
+   unsigned long long bit = 1ULL << (r & 63);
+
+   if (wake_bits[r >> 6] & bit)
+      wake_take(r);
+   else {
+      // woken for the next slot
+      if ((wake_next[r >> 6] &= ~bit) == 0)
+         wake_nsum[r >> 12] &= ~(1ULL << ((r >> 6) & 63));
+      --wake_ncnt;
+   }
+   evt->pprev = NULL;
+}
+
+// called by wakel() for an event registered by lazyl()
+void wake_insert(
+   event *evt)
+{
+   unsigned int r = evt->rank;
+
+   evt->pprev = &wake_mark;
+   if (TimeType == LATE && r >= wake_cursor) {
+      // late() of this slot is already over
+      if ((r >> 6) >= wake_words)
+         wake_grow(EvtRank);
+      wake_next[r >> 6] |= 1ULL << (r & 63);
+      wake_nsum[r >> 12] |= 1ULL << ((r >> 6) & 63);
+      ++wake_ncnt;
+   } else
+      wake_push(evt);
+}
+
+/*
+* timing wheel: put an event into calendar, far wheel or overflow list
+*/
+static void wheel_insert(
+   event *evt,
+   event **cal,  // the calendar
+   farwheel *w)  // and its far wheel
+{
+   event **e;
+   tim_typ rev;
+
+   // rev <= wheel_rev: registered at an earlier SimTime (see pdes_drain()),
+   // the far wheel position of this revolution has been cascaded already
+   if (evt->time - SimTime < TIME_LEN || (rev = evt->time / TIME_LEN) <= wheel_rev) {
+      e = cal + evt->time % TIME_LEN;
+      EVT_MARK(evt->time % TIME_LEN);
+   } else if (rev - wheel_rev <= FAR_LEN)
+      e = w->far + rev % FAR_LEN;
+   else
+      e = &w->ovfl;
+   evt_link(e, evt);
+}
+
+// called by alarme() / alarml() for events at least TIME_LEN slots ahead
+void alarmfar(
+   event *evt,
+   int phase)
+{
+   if (phase == EARLY)
+      wheel_insert(evt, eventse, &wheele);
+   else
+      wheel_insert(evt, eventsl, &wheell);
+}
+
+// move the far wheel position of revolution wheel_rev into the calendar
+static void wheel_cascade(
+   event **cal,
+   farwheel *w)
+{
+   event *p, *l;
+   event **e;
+
+   l = w->far[wheel_rev % FAR_LEN];
+   w->far[wheel_rev % FAR_LEN] = NULL;
+   while ((p = l) != NULL) {
+      l = p->next;
+      e = cal + p->time % TIME_LEN;
+      EVT_MARK(p->time % TIME_LEN);
+      evt_link(e, p);
+   }
+   // do this after emptying the wheel position, it can be refilled now
+   if (wheel_rev % FAR_LEN == 0) {
+      l = w->ovfl;
+      w->ovfl = NULL;
+      while ((p = l) != NULL) {
+         l = p->next;
+         wheel_insert(p, cal, w);
+      }
+   }
+}
+
+// cascade all revolutions up to the current one
+static inline void wheel_advance(void)
+{
+   while (wheel_rev < SimTime / TIME_LEN) {
+      ++wheel_rev;
+      wheel_cascade(eventse, &wheele);
+      wheel_cascade(eventsl, &wheell);
+   }
+}
+
+// take all events out of calendar and far wheel, return them as one list
+static event *wheel_collect(
+   event **cal,
+   farwheel *w)
+{
+   event *list = NULL;
+   event *p, *l;
+   int i;
+
+   for (i = 0; i < TIME_LEN + FAR_LEN + 1; ++i) {
+      if (i < TIME_LEN) {
+         l = cal[i];
+         cal[i] = NULL;
+      } else if (i < TIME_LEN + FAR_LEN) {
+         l = w->far[i - TIME_LEN];
+         w->far[i - TIME_LEN] = NULL;
+      } else {
+         l = w->ovfl;
+         w->ovfl = NULL;
+      }
+      while ((p = l) != NULL) {
+         l = p->next;
+         p->next = list;
+         list = p;
+      }
+   }
+   return list;
+}
+
+// re-register a list of events with the current backend
+static void wheel_distribute(
+   event *l,
+   event **cal,
+   farwheel *w)
+{
+   event *p;
+
+   while ((p = l) != NULL) {
+      l = p->next;
+      if (EventWheel)
+         wheel_insert(p, cal, w);
+      else {
+         evt_link(cal + p->time % TIME_LEN, p);
+         EVT_MARK(p->time % TIME_LEN);
+      }
+   }
+}
+
+// mark all non-empty calendar positions in the occupancy bitmap
+static void eventmap_rebuild(void)
+{
+   int i;
+
+   memset(eventmap, 0, sizeof(eventmap));
+   for (i = 0; i < TIME_LEN; ++i)
+      if (eventse[i] != NULL || eventsl[i] != NULL)
+         EVT_MARK(i);
+}
+
+/*
+* Find the first calendar position in [i, end) which holds events.
+* Bits of positions found empty are cleared on the way (the bitmap is
+* not updated when events are retracted or activated).
+* Returns end if there is none.
+*/
+static inline int next_busy(
+   int i,
+   int end)
+{
+   unsigned long long w;
+
+   while (i < end) {
+      if ((w = eventmap[i / EVT_MAP_BITS] >> (i % EVT_MAP_BITS)) == 0) {
+         i = (i / EVT_MAP_BITS + 1) * EVT_MAP_BITS;
+         continue;
+      }
+      if ((i += __builtin_ctzll(w)) >= end)
+         break;
+      if (eventse[i] != NULL || eventsl[i] != NULL)
+         return i;
+      eventmap[i / EVT_MAP_BITS] &= ~(1ULL << (i % EVT_MAP_BITS));
+      ++i;
+   }
+   return end;
 }
 
 /*
 * inactivate events - see comments above
 */
+/*
+* Profiling
+*/
+static inline unsigned long long prof_clock(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+   unsigned int lo, hi;
+   __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+   return ((unsigned long long) hi << 32) | lo;
+#else
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+// charge the elapsed cycles to the running object, continue with obj
+profdata *prof_enter(root *obj)
+{
+   profdata *prev = prof_cur;
+   unsigned long long t = prof_clock();
+
+   if (obj->prof == NULL) {
+      CHECK(obj->prof = new profdata);
+      memset(obj->prof, 0, sizeof(profdata));
+   }
+   if (prev != NULL)
+      prev->cycles += t - prof_t0;
+   prof_t0 = t;
+   prof_cur = obj->prof;
+   return prev;
+}
+
+// charge the elapsed cycles to the running object, return to prev
+void prof_leave(profdata *prev)
+{
+   unsigned long long t = prof_clock();
+
+   if (prof_cur != NULL)
+      prof_cur->cycles += t - prof_t0;
+   prof_t0 = t;
+   prof_cur = prev;
+}
+
+void prof_delete(profdata *pd)
+{
+   if (prof_cur == pd)
+      prof_cur = NULL;
+   delete pd;
+}
+
+// activate an event: its direct handler, if any, or obj->early() / obj->late()
+static inline void evt_early(event *p)
+{
+   ++EvtCount;
+   if (p->handler != NULL)
+      p->handler(p);
+   else
+      p->obj->early(p);
+}
+
+static inline void evt_late(event *p)
+{
+   ++EvtCount;
+   if (p->handler != NULL)
+      p->handler(p);
+   else
+      p->obj->late(p);
+}
+
+static inline void prof_early(event *p)
+{
+   profdata *prev = prof_enter(p->obj);
+   ++p->obj->prof->nearly;
+   evt_early(p);
+   prof_leave(prev);
+}
+
+static inline void prof_late(event *p)
+{
+   profdata *prev = prof_enter(p->obj);
+   ++p->obj->prof->nlate;
+   evt_late(p);
+   prof_leave(prev);
+}
+
 void unalarme(
    event *evt)
 {
+   char tim[24];
+
    if (evt->time < SimTime)
       errm1s("internal error: unalarme(): can't retract an activation request "
              "for a slot earlier than SimTime\n"
              "(has been requested by %s)", evt->obj->name);
-   if (del_evt(evt, eventse + evt->time % TIME_LEN) ||
-         del_evt(evt, &early_now)) {
+   if (evt->pprev != NULL) {
+      evt_unlink(evt);
 #ifdef EVENT_DEBUG
       evt->used = FALSE;
 #endif
 
       return ;
    }
-   errm1s2d("internal error: unalarme(): could not find event\n"
-            "\tobject name: %s\n\tevt->time: %u\n\tevt->key: %d\n",
-            evt->obj->name, evt->time, evt->key);
+   sprintf(tim, TIM_FMT, evt->time);
+   errm2s1d("internal error: unalarme(): could not find event\n"
+            "\tobject name: %s\n\tevt->time: %s\n\tevt->key: %d\n",
+            evt->obj->name, tim, evt->key);
 }
 void unalarml(
    event *evt)
 {
+   char tim[24];
+
+   if (evt->pprev == &wake_mark) {
+      // woken by wakel(), its time is not used
+      wake_remove(evt);
+      return ;
+   }
    if (evt->time < SimTime)
       errm1s("internal error: unalarml(): can't retract an activation request "
              "for a slot earlier than SimTime\n"
              "(has been requested by %s)", evt->obj->name);
-   if (del_evt(evt, eventsl + evt->time % TIME_LEN) ||
-         del_evt(evt, &late_now)) {
+   if (evt->pprev != NULL) {
+      evt_unlink(evt);
 #ifdef EVENT_DEBUG
       evt->used = FALSE;
 #endif
 
       return ;
    }
-   errm1s2d("internal error: unalarml(): could not find event\n"
-            "\tobject name: %s\n\tevt->time: %u\n\tevt->key: %d\n",
-            evt->obj->name, evt->time, evt->key);
+   sprintf(tim, TIM_FMT, evt->time);
+   errm2s1d("internal error: unalarml(): could not find event\n"
+            "\tobject name: %s\n\tevt->time: %s\n\tevt->key: %d\n",
+            evt->obj->name, tim, evt->key);
+}
+
+/*
+* move an event to a new activation time, it need not be registered yet
+*/
+void realarme(
+   event *evt,
+   tim_typ delta)
+{
+   if (evt->pprev != NULL) {
+      evt_unlink(evt);
+#ifdef EVENT_DEBUG
+      evt->used = FALSE;
+#endif
+   }
+   alarme(evt, delta);
+}
+
+void realarml(
+   event *evt,
+   tim_typ delta)
+{
+   if (evt->pprev == &wake_mark)
+      wake_remove(evt);
+   else if (evt->pprev != NULL) {
+      evt_unlink(evt);
+#ifdef EVENT_DEBUG
+      evt->used = FALSE;
+#endif
+   }
+   alarml(evt, delta);
 }
 
 /*
@@ -267,14 +830,33 @@ static void ResetTime(void)
    event **aux;
    static char errm[] = "ResetTime(): internal error: event list inconsistent";
 
-   CHECK(aux = new event * [TIME_LEN]);
-   for (i = 0; i < TIME_LEN; ++i)
-      aux[i] = NULL;
-
    // first inform all objects
 #ifndef USELUA
    broadc_restim();
 #endif
+   if (EventWheel) {
+      // take all events out, rebase them and register them again
+      event *le = wheel_collect(eventse, &wheele);
+      event *ll = wheel_collect(eventsl, &wheell);
+      for (i = 0; i < 2; ++i)
+         for (p = (i == 0) ? le : ll; p != NULL; p = p->next) {
+            if (p->time < SimTime)
+               errm0(errm);
+            p->time -= SimTime;
+         }
+      SimTime = 0;
+      SimTimeReal = 0;
+      wheel_rev = 0;
+      wheel_distribute(le, eventse, &wheele);
+      wheel_distribute(ll, eventsl, &wheell);
+      eventmap_rebuild();
+      return;
+   }
+
+   CHECK(aux = new event * [TIME_LEN]);
+   for (i = 0; i < TIME_LEN; ++i)
+      aux[i] = NULL;
+
    // then decrement activation times for all registered events,
    // and place events at new place in the calendar.
    for (i = 0; i < TIME_LEN; ++i) {
@@ -293,7 +875,8 @@ static void ResetTime(void)
 
    // write events back to the original calendar
    for (i = 0; i < TIME_LEN; ++i)
-      eventse[i] = aux[i];
+      if ((eventse[i] = aux[i]) != NULL)
+         eventse[i]->pprev = eventse + i;
 
    // now the same for the late events
    for (i = 0; i < TIME_LEN; ++i)
@@ -312,12 +895,128 @@ static void ResetTime(void)
          aux[p->time % TIME_LEN] = p;
    }
    for (i = 0; i < TIME_LEN; ++i)
-      eventsl[i] = aux[i];
+      if ((eventsl[i] = aux[i]) != NULL)
+         eventsl[i]->pprev = eventsl + i;
 
    // reset time
    SimTime = 0;
    SimTimeReal = 0;
+   wheel_rev = 0;
    delete[] aux;
+   eventmap_rebuild();
+}
+
+/*
+* select the event manager backend: EVT_CALENDAR or EVT_WHEEL
+* Pending events are moved to the new backend. Do not call during sim::run().
+*/
+void sim::SetEventManager(int mode)
+{
+   event *le, *ll;
+
+   if (mode != EVT_CALENDAR && mode != EVT_WHEEL)
+      errm1d("sim::SetEventManager(): unknown event manager %d", mode);
+   le = wheel_collect(eventse, &wheele);
+   ll = wheel_collect(eventsl, &wheell);
+   EventWheel = (mode == EVT_WHEEL);
+   wheel_rev = SimTime / TIME_LEN;
+   wheel_distribute(le, eventse, &wheele);
+   wheel_distribute(ll, eventsl, &wheell);
+}
+
+int sim::GetEventManager(void)
+{
+   return EventWheel ? EVT_WHEEL : EVT_CALENDAR;
+}
+
+/*
+* Turn skipping of empty slots on or off. Skipping only takes place while
+* no object is registered with eache() or eachl().
+*/
+void sim::SetSlotSkip(int on)
+{
+   SlotSkip = on;
+}
+
+int sim::GetSlotSkip(void)
+{
+   return SlotSkip;
+}
+
+/*
+* Number of activations since the start of the program, e.g. for
+* benchmarks (events/s)
+*/
+double sim::GetEventCount(void)
+{
+#ifdef PDES
+   return (double) (EvtCount + __atomic_load_n(&EvtCountPar, __ATOMIC_RELAXED));
+#else
+   return (double) EvtCount;
+#endif
+}
+
+#ifdef PDES
+// end of a parallel run: add the activations of a worker thread
+void evt_count_merge(void)
+{
+   __atomic_fetch_add(&EvtCountPar, EvtCount, __ATOMIC_RELAXED);
+   EvtCount = 0;
+}
+#endif
+
+/*
+* Switch the profiler on or off.
+*/
+void sim::SetProfile(int on)
+{
+   if ( !on && prof_cur != NULL)
+      prof_leave(NULL);
+   Profiling = on;
+}
+
+int sim::GetProfile(void)
+{
+   return Profiling;
+}
+
+/*
+* Profiling data of an object: PROF_EARLY, PROF_LATE, PROF_REC or PROF_CYCLES.
+*/
+double sim::GetProfileData(root *obj, int what)
+{
+   if (obj == NULL || obj->prof == NULL)
+      return 0.0;
+   switch (what) {
+   case PROF_EARLY:
+      return (double) obj->prof->nearly;
+   case PROF_LATE:
+      return (double) obj->prof->nlate;
+   case PROF_REC:
+      return (double) obj->prof->nrec;
+   case PROF_CYCLES:
+      return (double) obj->prof->cycles;
+   default:
+      errm1s1d("%s: GetProfileData(): invalid selector %d", name, what);
+   }
+   return 0.0;
+}
+
+void sim::ResetProfile(root *obj)
+{
+   if (obj != NULL && obj->prof != NULL)
+      memset(obj->prof, 0, sizeof(profdata));
+}
+
+/*
+* Name of a data class, for the statistics of its memory pool.
+* NULL, if type is not a valid data type.
+*/
+char *sim::GetPoolName(int type)
+{
+   if (type < 0 || type >= _end_type)
+      return NULL;
+   return typ2str((dat_typ) type);
 }
 
 #ifdef EVENT_DEBUG
@@ -333,6 +1032,10 @@ static char *getfunc(
       return "eache()";
    case Eachl:
       return "eachl()";
+   case Lazyl:
+      return "lazyl()";
+   case Slotend:
+      return "slotend()";
    }
    return "<unknown>";
 }
@@ -352,7 +1055,7 @@ void check_evt(
               "illegal event registration: DELTA == 0 while simulation running\n"
               "\tregistration with: %s\n"
               "\tobject name: %s\n"
-              "\tcurrent SimTime: %u\n",
+              "\tcurrent SimTime: " TIM_FMT "\n",
               getfunc(how), evt->obj->name, SimTime);
       errm0(err);
    }
@@ -362,9 +1065,9 @@ void check_evt(
               "illegal event registration: DOUBLE USAGE of an event structure\n"
               "\tregistration with: %s\n"
               "\tobject name: %s\n"
-              "\tcurrent SimTime: %u\n"
-              "\told request for activation at: %u\n"
-              "\tnew request for activation at: %u\n"
+              "\tcurrent SimTime: " TIM_FMT "\n"
+              "\told request for activation at: " TIM_FMT "\n"
+              "\tnew request for activation at: " TIM_FMT "\n"
               "\tevent->key: %d\n",
               getfunc(how), evt->obj->name, SimTime, evt->time, SimTime + delta, evt->key);
       errm0(err);
@@ -374,184 +1077,398 @@ void check_evt(
 }
 #endif
 
-void sim::ResetTime_(void)
+#ifdef PDES
+/*
+* Parallel simulation (see pdes.c): hand over the events of the running
+* thread to another thread
+*/
+void evt_take(
+   event **early,  // calendar and timing wheel
+   event **late,
+   event **each_e,  // eache() and eachl()
+   event **each_l,
+   event **wake)  // woken by wakel()
 {
-   ResetTime();
+   event *p;
+
+   *early = wheel_collect(eventse, &wheele);
+   *late = wheel_collect(eventsl, &wheell);
+   *each_e = timee;
+   *each_l = timel;
+   timee = timel = NULL;
+   *wake = NULL;
+   while (wake_cnt > 0) {
+      p = wake_pop();
+      p->next = *wake;
+      *wake = p;
+   }
 }
-static int SimStopCommand;
-// Stop current run of simulation
-void sim::stop(void)
+
+// merge two lists of eache() / eachl(), both ordered by decreasing rank
+static event *each_merge(
+   event *a,
+   event *b)
 {
-   SimStopCommand = 1;
+   event *head, **pp = &head;
+
+   while (a != NULL && b != NULL) {
+      if (a->rank > b->rank) {
+         *pp = a;
+         a = a->next;
+      } else {
+         *pp = b;
+         b = b->next;
+      }
+      pp = &(*pp)->next;
+   }
+   *pp = a != NULL ? a : b;
+   return head;
 }
-void sim::reset(int reset){}
-int sim::run(int slots){ return this->run(slots, slots - 1);}
-int sim::run(int slots, int dots)
+
+// take over events, the lists of eache() and eachl() are merged in the
+// order of registration
+void evt_give(
+   event *early,
+   event *late,
+   event *each_e,
+   event *each_l,
+   event *wake)
 {
-   event **pe, **plt;
-   event **end_mark;
    event *p;
-   int nSlots;
-   int nDots;  // distance between two dots
-   int nextDot; // when print next dot
-   int dotsPerLine; // dots on the current line
-   nSlots = slots;
-   nDots = dots;
-   nextDot = nSlots - nDots;
-   dotsPerLine = 0;
 
-#ifdef EVENT_DEBUG
+   wheel_rev = SimTime / TIME_LEN;
+   wheel_distribute(early, eventse, &wheele);
+   wheel_distribute(late, eventsl, &wheell);
+   timee = each_merge(timee, each_e);
+   timel = each_merge(timel, each_l);
+   while ((p = wake) != NULL) {
+      wake = p->next;
+      wake_push(p);
+   }
+}
 
-   _sim_run_flag = TRUE;
-#endif
+// simulate nSlots slots in the running thread
+void run_window(
+   int nSlots)
+{
+   while (nSlots > 0)
+      nSlots -= run_revolution(nSlots);
+}
 
-   SimStopCommand = 0;
-   // simulate the wished number of loops
-   while ((nSlots > 0) && (SimStopCommand == 0)) { // determine which slots to simulate during this loop
-      int aux;
-      aux = SimTime % TIME_LEN; // where to start to simulate
-      pe = eventse + aux;
-      plt = eventsl + aux;
-      aux = TIME_LEN - aux;  // how much to simulate at most
-      if (nSlots > aux) {
-         end_mark = pe + aux;
-         nSlots -= aux;
-      } else {
-         end_mark = pe + nSlots;
-         nSlots = 0;
-      }
+void sim::SetPartitions(int n, int lookahead)
+{
+   pdes_set(n, lookahead);
+}
 
-      // once over the calculated range of the calendar:
-      while (pe < end_mark) { // early slot phase
-         TimeType = EARLY;
-         // event triggered activation: take event list
-         if ((early_now = *pe) != NULL) { // mark list as empty
-            *pe = NULL;
-            // process now list entries
-            // warning: during processing of one entry it is possible
-            // that new events are generated (and they can be destined for
-            // the same hash position!)
-            do { // first delete the event from the chain in early_now:
-               // it could be tried to delete it yet
-               p = early_now;
-               early_now = early_now->next;
-               if (p->time == SimTime) { // the time is o.k. -> activate the object
-#ifdef EVENT_DEBUG
-                  p->used = FALSE;
-#endif
-#ifdef EVENT_LOG
+int sim::GetPartitions(void)
+{
+   return pdes_parts();
+}
 
-                  if (SimTime >= EVENT_LOG) {
-                     dprintf("%u: %s->earlyEvt(beg ... ", SimTime, p->obj->name);
-                     fflush(stdout);
-                  }
-#endif
-                  p->obj->early(p);
-#ifdef EVENT_LOG
+int sim::GetMaxPartitions(void)
+{
+   return PDES_MAX;
+}
+#else // PDES
+void sim::SetPartitions(int n, int)
+{
+   if (n != 1)
+      errm1s("%s: SetPartitions(): parallel simulation needs a kernel compiled with PDES", name);
+}
 
-                  if (SimTime >= EVENT_LOG)
-                     dprintf("end)\n");
-#endif
+int sim::GetPartitions(void)
+{
+   return 1;
+}
 
-               } else { // time is not o.k. -> leave the event in the list
-                  // (pe points to the head of the right hash position)
-                  p->next = *pe;
-                  *pe = p;
-               }
-            } while (early_now != NULL);
+int sim::GetMaxPartitions(void)
+{
+   return 1;
+}
+#endif // PDES
+
+void sim::ResetTime_(void)
+{
+   ResetTime();
+}
+static THREAD_LOCAL int SimStopCommand;
+
+/*
+* Simulate the slots from SimTime up to the end of the current calendar
+* revolution, at most nSlots. Returns the number of slots simulated, which
+* is less if sim::stop() has been called: the run stops at the end of the
+* slot calling it.
+*/
+static int run_revolution(
+   int nSlots)
+{
+   event **pe, **plt;
+   event **end_mark;
+   event *p, *each;
+   unsigned int rank;
+   int aux;
+
+   if (EventWheel)
+      wheel_advance();
+   aux = SimTime % TIME_LEN; // where to start to simulate
+   pe = eventse + aux;
+   plt = eventsl + aux;
+   aux = TIME_LEN - aux;  // how much to simulate at most
+   if (nSlots > aux)
+      nSlots = aux;
+   end_mark = pe + nSlots;
+
+   // once over the calculated range of the calendar:
+   while (pe < end_mark) {
+      // nobody wants to see empty slots: jump to the next one with events
+      if (SlotSkip && timee == NULL && timel == NULL && timex == NULL && wake_cnt == 0) {
+         int jump = next_busy(pe - eventse, end_mark - eventse) - (pe - eventse);
+         if (jump > 0) {
+            pe += jump;
+            plt += jump;
+#ifndef TIME64
+            // TIME_LEN does not divide 2^32: the wrap may lie within the jump
+            if ((tim_typ) (SimTime + jump) <= SimTime)
+               errm1s("%s: overflow of SimTime", _sim.name);
+#endif
+            SimTime += jump;
+            SimTimeReal = SimTime * SlotLength;
+            if (pe == end_mark)
+               break;
          }
-         ++pe;
-         // activation in each time slot:
-         if ((p = timee) != NULL) {
-            do {
+      }
+      // early slot phase
+      TimeType = EARLY;
+      // event triggered activation: take event list
+      if ((early_now = *pe) != NULL) { // mark list as empty
+         early_now->pprev = &early_now;
+         *pe = NULL;
+         // process now list entries
+         // warning: during processing of one entry it is possible
+         // that new events are generated (and they can be destined for
+         // the same hash position!)
+         do { // first delete the event from the chain in early_now:
+            // it could be tried to delete it yet
+            p = early_now;
+            evt_unlink(p);
+            if (p->time == SimTime) { // the time is o.k. -> activate the object
+#ifdef EVENT_DEBUG
+               p->used = FALSE;
+#endif
 #ifdef EVENT_LOG
+
                if (SimTime >= EVENT_LOG) {
-                  dprintf("%u: %s->earlyTim(beg ... ", SimTime, p->obj->name);
+                  dprintf(TIM_FMT ": %s->earlyEvt(beg ... ", SimTime, p->obj->name);
                   fflush(stdout);
                }
 #endif
-               p->obj->early(p);
+               RandCur = &p->obj->rng;
+               if (Profiling)
+                  prof_early(p);
+               else
+                  evt_early(p);
 #ifdef EVENT_LOG
 
                if (SimTime >= EVENT_LOG)
                   dprintf("end)\n");
 #endif
 
-            } while ((p = p->next) != NULL);
-         }
-
-         // now the same for the late slot phase
-         TimeType = LATE;
-         // event triggered activation:
-         // do not load late_now earlier: otherwise, calling alarml(..., 0) in
-         // the early phase (of the same slot) does not work
-         if ((late_now = *plt) != NULL) {
-            *plt = NULL;
-            do {
-               p = late_now;
-               late_now = late_now->next;
-               if (p->time == SimTime) {
-#ifdef EVENT_DEBUG
-                  p->used = FALSE;
-#endif
+            } else { // time is not o.k. -> leave the event in the list
+               // (pe points to the head of the right hash position)
+               evt_link(pe, p);
+            }
+         } while (early_now != NULL);
+      }
+      ++pe;
+      // activation in each time slot:
+      if ((p = timee) != NULL) {
+         do {
 #ifdef EVENT_LOG
-
-                  if (SimTime >= EVENT_LOG) {
-                     dprintf("%u: %s->lateEvt(beg ... ", SimTime, p->obj->name);
-                     fflush(stdout);
-                  }
+            if (SimTime >= EVENT_LOG) {
+               dprintf(TIM_FMT ": %s->earlyTim(beg ... ", SimTime, p->obj->name);
+               fflush(stdout);
+            }
 #endif
-                  p->obj->late(p);
+            RandCur = &p->obj->rng;
+            if (Profiling)
+               prof_early(p);
+            else
+               evt_early(p);
 #ifdef EVENT_LOG
 
-                  if (SimTime >= EVENT_LOG)
-                     dprintf("end)\n");
+            if (SimTime >= EVENT_LOG)
+               dprintf("end)\n");
 #endif
 
-               } else {
-                  p->next = *plt;
-                  *plt = p;
-               }
-            } while (late_now != NULL);
-         }
-         ++plt;
-         // each time slot
-         if ((p = timel) != NULL) {
-            do {
+         } while ((p = p->next) != NULL);
+      }
+
+      // now the same for the late slot phase
+      TimeType = LATE;
+      // event triggered activation:
+      // do not load late_now earlier: otherwise, calling alarml(..., 0) in
+      // the early phase (of the same slot) does not work
+      if ((late_now = *plt) != NULL) {
+         late_now->pprev = &late_now;
+         *plt = NULL;
+         do {
+            p = late_now;
+            evt_unlink(p);
+            if (p->time == SimTime) {
+#ifdef EVENT_DEBUG
+               p->used = FALSE;
+#endif
 #ifdef EVENT_LOG
+
                if (SimTime >= EVENT_LOG) {
-                  dprintf("%u: %s->lateTim(beg ... ", SimTime, p->obj->name);
+                  dprintf(TIM_FMT ": %s->lateEvt(beg ... ", SimTime, p->obj->name);
                   fflush(stdout);
                }
 #endif
-               p->obj->late(p);
+               RandCur = &p->obj->rng;
+               if (Profiling)
+                  prof_late(p);
+               else
+                  evt_late(p);
 #ifdef EVENT_LOG
 
                if (SimTime >= EVENT_LOG)
                   dprintf("end)\n");
 #endif
 
-            } while ((p = p->next) != NULL);
+            } else {
+               evt_link(plt, p);
+            }
+         } while (late_now != NULL);
+      }
+      ++plt;
+      // each time slot, merged with the events woken by wakel()
+      // (both in the order of registration)
+      p = timel;
+      while (p != NULL || wake_cnt != 0) {
+         if (wake_cnt != 0 && (rank = wake_top()) > (p != NULL ? p->rank : 0)) {
+            each = wake_take(rank);
+            each->pprev = NULL;
+         } else
+            each = p;
+         wake_cursor = each->rank;
+#ifdef EVENT_LOG
+         if (SimTime >= EVENT_LOG) {
+            dprintf(TIM_FMT ": %s->lateTim(beg ... ", SimTime, each->obj->name);
+            fflush(stdout);
          }
+#endif
+         RandCur = &each->obj->rng;
+         if (Profiling)
+            prof_late(each);
+         else
+            evt_late(each);
+#ifdef EVENT_LOG
 
-         if ( ++SimTime == 0)
-            errm1s("%s: overflow of SimTime", name);
+         if (SimTime >= EVENT_LOG)
+            dprintf("end)\n");
+#endif
 
-         SimTimeReal = SimTime * SlotLength; // issue: very expensive!
+         if (each == p)
+            p = p->next;
+      }
+      wake_cursor = WAKE_ANY;
+      // woken after their turn in this slot: activate in the next slot
+      wake_shift();
+      // end of the slot, see slotend()
+#ifdef PDES
+      if (CurPart < 0)
+#endif
+      for (p = timex; p != NULL; p = each) {
+         each = p->next;  // p may be removed by unslotend()
+         RandCur = &p->obj->rng;
+         if (Profiling)
+            prof_late(p);
+         else
+            evt_late(p);
       }
 
+      if (CNT_OVERFLOW( ++SimTime))
+         errm1s("%s: overflow of SimTime", _sim.name);
+
+      SimTimeReal = SimTime * SlotLength; // issue: very expensive!
+
+#ifdef PDES
+      // parallel windows are stopped at their end, see pdes.c
+      if (SimStopCommand && CurPart < 0)
+#else
+      if (SimStopCommand)
+#endif
+         return nSlots - (end_mark - pe);
+   }
+   return nSlots;
+}
+
+// Stop current run of simulation
+void sim::stop(void)
+{
+   SimStopCommand = 1;
+#ifdef PDES
+   pdes_stop();
+#endif
+}
+void sim::reset(int reset){}
+int sim::run(int slots){ return this->run(slots, slots - 1);}
+int sim::run(int slots, int dots)
+{
+   int nSlots;
+   int nDots;  // distance between two dots
+   int nextDot; // when print next dot
+   int dotsPerLine; // dots on the current line
+#ifdef PDES
+   int parallel = pdes_parts() > 1;  // distributed over threads
+#endif
+   nSlots = slots;
+   nDots = dots;
+   nextDot = nSlots - nDots;
+   dotsPerLine = 0;
+
+#ifdef EVENT_DEBUG
+
+   _sim_run_flag = TRUE;
+#endif
+
+   SimStopCommand = 0;
+#ifdef PDES
+   if (parallel)
+      pdes_begin();
+#endif
+   if (Profiling)
+      prof_enter(this);
+   // simulate the wished number of loops
+   while ((nSlots > 0) && (SimStopCommand == 0)) {
+#ifdef PDES
+      if (parallel)
+         nSlots -= pdes_window(nSlots);
+      else
+#endif
+         nSlots -= run_revolution(nSlots);
+
       // write outstanding dots if DOTS != 0
       while (nSlots <= nextDot) {
          putchar ('.');
          nextDot -= nDots;
          if ( ++dotsPerLine >= 50) {
-            dprintf("\t%u\n", SimTime);
+            dprintf("\t" TIM_FMT "\n", SimTime);
             dotsPerLine = 0;
          }
          fflush(stdout);
       }
    }
 
+#ifdef PDES
+   if (parallel)
+      pdes_end();
+#endif
+   hdrhist::refreshAll();   // exported quantiles
+   RandCur = &RandMaster;
+   if (prof_cur != NULL)
+      prof_leave(NULL);
    if (nDots != 0 && nextDot > 0)
       putchar ('\n');
    fflush(stdout);
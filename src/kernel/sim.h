@@ -3,11 +3,27 @@
 
 #include "defs.h"
 
-extern event	*eventse[TIME_LEN];
-extern event	*eventsl[TIME_LEN];
+extern THREAD_LOCAL event	*eventse[TIME_LEN];
+extern THREAD_LOCAL event	*eventsl[TIME_LEN];
 
 int flushevents(int);
 
+#ifdef PDES
+// parallel simulation, see pdes.c
+#define PDES_MAX (64)  // max. # of partitions
+void pdes_set(int, tim_typ);
+int pdes_parts(void);
+void pdes_begin(void);
+int pdes_window(int);
+void pdes_end(void);
+void pdes_stop(void);
+void pdes_forked(void);
+void evt_take(event **, event **, event **, event **, event **);
+void evt_give(event *, event *, event *, event *, event *);
+void run_window(int);
+void evt_count_merge(void);
+#endif
+
 class sim: public root { 
    typedef root baseclass;
 public:
@@ -19,8 +35,31 @@ public:
    void reset(int);
    void SetRand(int n){my_srand(n);}
    int GetRand(void){return my_rand();}
+   void SetRandGen(int n){my_randgen(n);}
+   int GetRandGen(void){return my_getrandgen();}
+   void SetRandKey(int n){my_randkey(n);}
+   int GetRandKey(void){return my_getrandkey();}
+   void NameRand(root *obj){rand_name(obj);}
    void ResetTime_(void);
+   int GetClockBits(void){return 8 * sizeof(tim_typ);}
    void SetSlotLength(double n){SlotLength=n;}
+   void SetEventManager(int);
+   int GetEventManager(void);
+   void SetSlotSkip(int);
+   int GetSlotSkip(void);
+   void SetProfile(int);
+   int GetProfile(void);
+   double GetProfileData(root *, int);
+   void ResetProfile(root *);
+   double ReleasePools(void){return release_pools();}
+   char *GetPoolName(int);
+   double GetPoolStat(int type, int what){return pool_stat((dat_typ) type, what);}
+   void ResetPoolStat(void){reset_pool_stat();}
+   void SetPoolHugepages(int on){pool_hugepages(on);}
+   void SetPartitions(int, int);
+   int GetPartitions(void);
+   int GetMaxPartitions(void);
+   double GetEventCount(void);
    virtual ~sim(void){}
 };
 
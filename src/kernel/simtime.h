@@ -0,0 +1,56 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+#ifndef _SIMTIME_H_
+#define _SIMTIME_H_
+
+//
+// Type of the simulation clock, included by defs.h. Modules which cannot
+// include defs.h (rstp) take the clock from here. TIME64 and PDES (see
+// defs.h) have to be given on the command line then (USERCFLAGS).
+//
+
+#ifdef PDES
+#define THREAD_LOCAL __thread
+#else // PDES
+#define THREAD_LOCAL
+#endif // PDES
+
+/*
+* Type of the simulation clock and of counters, see TIME64
+*/
+#ifdef TIME64
+typedef unsigned long long tim_typ;
+typedef unsigned long long cnt_typ;
+#define CNT_OVERFLOW(c) ((c), 0)
+#define TIM_FMT "%llu"
+#else // TIME64
+typedef unsigned int tim_typ;
+typedef unsigned int cnt_typ;
+#define CNT_OVERFLOW(c) ((c) == 0)
+#define TIM_FMT "%u"
+#endif // TIME64
+
+extern THREAD_LOCAL tim_typ SimTime; // simulation time
+extern THREAD_LOCAL double SimTimeReal;
+
+#endif // _SIMTIME_H_
@@ -0,0 +1,453 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+/*
+*	Binary event traces, see tracewr.h
+*
+*	The ring of a tracewr has one producer (the simulation) and one
+*	consumer (the writer thread): put() advances head, the writer thread
+*	advances tail. One writer thread serves the rings of all tracewr; it
+*	is started with the first tracewr of the process. The mutex protects
+*	the list of writers and the sleeping and waking up.
+*/
+
+#include "tracewr.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#ifdef	HAVE_LZ4
+#include <lz4.h>
+#endif
+#ifdef	HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+int	tracewr::TraceGen = 0;
+tracewr	*tracewr::all = NULL;
+int	tracewr::thread_gen = -1;
+pthread_t	tracewr::thread;
+pthread_mutex_t	tracewr::mtx = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t	tracewr::data = PTHREAD_COND_INITIALIZER;
+pthread_cond_t	tracewr::room = PTHREAD_COND_INITIALIZER;
+
+static	const char *trace_codecs[] = {"raw", "lz4", "zstd"};
+
+/*
+*	Is the codec compiled in?
+*/
+static	int	codec_ok(
+	int	codec)
+{
+	switch (codec) {
+	case TRACE_RAW:
+		return TRUE;
+#ifdef	HAVE_LZ4
+	case TRACE_LZ4:
+		return TRUE;
+#endif
+#ifdef	HAVE_ZSTD
+	case TRACE_ZSTD:
+		return TRUE;
+#endif
+	}
+	return FALSE;
+}
+
+/*
+*	Max. length of a compressed block
+*/
+static	size_t	codec_bound(
+	int	codec,
+	size_t	len)
+{
+	switch (codec) {
+#ifdef	HAVE_LZ4
+	case TRACE_LZ4:
+		return LZ4_compressBound(len);
+#endif
+#ifdef	HAVE_ZSTD
+	case TRACE_ZSTD:
+		return ZSTD_compressBound(len);
+#endif
+	}
+	return len;
+}
+
+/**********************************************************************/
+
+tracewr::tracewr(
+	char	*fn,
+	int	c)
+{
+	static	int	registered = FALSE;
+	trace_hdr	hdr;
+
+	if (c < TRACE_RAW || c > TRACE_ZSTD)
+		errm1d("tracewr: unknown codec %d", c);
+	if ( !codec_ok(c))
+		errm1s("tracewr: codec `%s' not compiled in (see src/kernel/tracewr.h)",
+			(char *) trace_codecs[c]);
+	fname = strsave(fn);
+	if ((fd = open(fname, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+		errm1s("tracewr: could not open file `%s' for writing", fname);
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+	hdr.version = TRACE_VERSION;
+	hdr.recsize = sizeof(trace_evt);
+	hdr.block = TRACE_BLOCK;
+	hdr.codec = c;
+	if (write_all(&hdr, sizeof(hdr)) != 0)
+		errm1s("tracewr: error writing file `%s'", fname);
+
+	codec = c;
+	gen = TraceGen;
+	ioerr = 0;
+	flushreq = FALSE;
+	head = tail = dropped = 0;
+	CHECK(ring = new trace_evt[TRACE_RING]);
+	CHECK(blk = new trace_evt[TRACE_BLOCK]);
+	zlen = codec_bound(codec, TRACE_BLOCK * sizeof(trace_evt));
+	CHECK(zbuf = new char[zlen]);
+
+	if ( !registered)
+	{	pthread_atfork(NULL, NULL, at_fork);
+		atexit(at_exit);
+		registered = TRUE;
+	}
+
+	pthread_mutex_lock(&mtx);
+	if (thread_gen != TraceGen)
+	{	if (pthread_create(&thread, NULL, run, NULL) != 0)
+		{	pthread_mutex_unlock(&mtx);
+			errm1s("tracewr: could not start writer thread for `%s'", fname);
+		}
+		pthread_detach(thread);
+		thread_gen = TraceGen;
+	}
+	next = all;
+	all = this;
+	pthread_mutex_unlock(&mtx);
+}
+
+tracewr::~tracewr()
+{
+	tracewr	**pp;
+
+	// write the rest, then take the writer out of the list: after the
+	// flush request is done, the writer thread does not hold on to it
+	pthread_mutex_lock(&mtx);
+	if (gen == TraceGen)
+	{	flushreq = TRUE;
+		pthread_cond_signal(&data);
+		while (flushreq)
+			pthread_cond_wait(&room, &mtx);
+	}
+	for (pp = &all; *pp != NULL; pp = &(*pp)->next)
+		if (*pp == this)
+		{	*pp = next;
+			break;
+		}
+	pthread_mutex_unlock(&mtx);
+
+	close(fd);
+	delete[] ring;
+	delete[] blk;
+	delete[] zbuf;
+	if (ioerr != 0)
+		errm2s("tracewr: error writing file `%s': %s", fname, strerror(ioerr));
+	delete[] fname;
+}
+
+/*
+*	Write all records put so far to the file.
+*/
+void	tracewr::flush(void)
+{
+	if (gen != TraceGen)
+		return;
+	pthread_mutex_lock(&mtx);
+	flushreq = TRUE;
+	pthread_cond_signal(&data);
+	while (flushreq)
+		pthread_cond_wait(&room, &mtx);
+	pthread_mutex_unlock(&mtx);
+	if (ioerr != 0)
+		errm2s("tracewr: error writing file `%s': %s", fname, strerror(ioerr));
+}
+
+/*
+*	The ring is full: wait for the writer thread
+*/
+void	tracewr::wait_room(void)
+{
+	pthread_mutex_lock(&mtx);
+	while (head - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) >= TRACE_RING)
+	{	pthread_cond_signal(&data);
+		pthread_cond_wait(&room, &mtx);
+	}
+	pthread_mutex_unlock(&mtx);
+}
+
+/*
+*	A block is complete
+*/
+void	tracewr::kick(void)
+{
+	pthread_mutex_lock(&mtx);
+	pthread_cond_signal(&data);
+	pthread_mutex_unlock(&mtx);
+}
+
+/*
+*	Writer thread of all writers: writes complete blocks, and the rest
+*	on flush. A writer is not removed from the list while the thread
+*	writes one of its blocks, see ~tracewr().
+*/
+void	*tracewr::run(
+	void	*)
+{
+	tracewr	*w;
+	unsigned long long	avail;
+	int	n, err, busy;
+
+	pthread_mutex_lock(&mtx);
+	for (;;)
+	{	busy = FALSE;
+		for (w = all; w != NULL; w = w->next)
+		{	if (w->gen != TraceGen)
+				continue;	// inherited by a forked child
+			avail = __atomic_load_n(&w->head, __ATOMIC_ACQUIRE) - w->tail;
+			if (avail >= TRACE_BLOCK || (avail > 0 && w->flushreq))
+			{	n = avail >= TRACE_BLOCK ? TRACE_BLOCK : (int) avail;
+				pthread_mutex_unlock(&mtx);
+				err = w->write_block(w->tail, n);
+				pthread_mutex_lock(&mtx);
+				if (err != 0 && w->ioerr == 0)
+					w->ioerr = err;
+				__atomic_store_n(&w->tail, w->tail + n, __ATOMIC_RELEASE);
+				pthread_cond_broadcast(&room);
+				busy = TRUE;
+			}
+			else if (w->flushreq)
+			{	w->flushreq = FALSE;
+				pthread_cond_broadcast(&room);
+			}
+		}
+		if ( !busy)
+			pthread_cond_wait(&data, &mtx);
+	}
+	return NULL;
+}
+
+/*
+*	Write n records starting at ring index 'from'. Returns errno or 0.
+*/
+int	tracewr::write_block(
+	unsigned long long from,
+	int	n)
+{
+	trace_blk	b;
+	unsigned	i, k;
+	size_t	len;
+	const void	*p;
+
+	// take the records out of the ring (it may wrap)
+	i = from & (TRACE_RING - 1);
+	k = TRACE_RING - i;
+	if (k >= (unsigned) n)
+		memcpy(blk, ring + i, n * sizeof(trace_evt));
+	else
+	{	memcpy(blk, ring + i, k * sizeof(trace_evt));
+		memcpy(blk + k, ring, (n - k) * sizeof(trace_evt));
+	}
+
+	b.nrec = n;
+	b.rawlen = n * sizeof(trace_evt);
+	b.codec = TRACE_RAW;
+	b.len = b.rawlen;
+	p = blk;
+	len = 0;
+	switch (codec) {
+#ifdef	HAVE_LZ4
+	case TRACE_LZ4:
+		len = LZ4_compress_default((const char *) blk, zbuf, b.rawlen, zlen);
+		break;
+#endif
+#ifdef	HAVE_ZSTD
+	case TRACE_ZSTD:
+		len = ZSTD_compress(zbuf, zlen, blk, b.rawlen, 1);
+		if (ZSTD_isError(len))
+			len = 0;
+		break;
+#endif
+	}
+	if (len > 0 && len < b.rawlen)
+	{	b.codec = codec;
+		b.len = len;
+		p = zbuf;
+	}
+
+	if (write_all(&b, sizeof(b)) != 0 || write_all(p, b.len) != 0)
+		return errno != 0 ? errno : EIO;
+	return 0;
+}
+
+int	tracewr::write_all(
+	const void	*buf,
+	size_t	len)
+{
+	const char	*p = (const char *) buf;
+	ssize_t	n;
+
+	while (len > 0)
+	{	if ((n = write(fd, p, len)) < 0)
+		{	if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		p += n;
+		len -= n;
+	}
+	return 0;
+}
+
+/*
+*	In a forked child, only the simulation thread exists: disable all
+*	writers inherited. The writer thread may have held the mutex at the
+*	fork; a writer created in the child starts a new writer thread.
+*/
+void	tracewr::at_fork(void)
+{
+	++TraceGen;
+	pthread_mutex_init(&mtx, NULL);
+	pthread_cond_init(&data, NULL);
+	pthread_cond_init(&room, NULL);
+}
+
+void	tracewr::at_exit(void)
+{
+	tracewr	*w;
+
+	for (w = all; w != NULL; w = w->next)
+		if (w->gen == TraceGen)
+			w->flush();
+}
+
+/**********************************************************************/
+
+tracerd::tracerd(
+	char	*fn)
+{
+	fname = strsave(fn);
+	if ((fp = fopen(fname, "rb")) == NULL)
+		errm1s("tracerd: could not open file `%s'", fname);
+	if (fread(&hdr, sizeof(hdr), 1, fp) != 1 ||
+			memcmp(hdr.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0)
+		errm1s("tracerd: `%s' is not a trace file", fname);
+	if (hdr.version != TRACE_VERSION || hdr.recsize != sizeof(trace_evt) ||
+			hdr.block == 0 || hdr.block > TRACE_BLOCK)
+		errm1s("tracerd: unsupported format of trace file `%s'", fname);
+
+	CHECK(blk = new trace_evt[hdr.block]);
+	zlen = hdr.block * sizeof(trace_evt);
+	zlen = codec_bound(TRACE_LZ4, zlen) > codec_bound(TRACE_ZSTD, zlen) ?
+		codec_bound(TRACE_LZ4, zlen) : codec_bound(TRACE_ZSTD, zlen);
+	CHECK(zbuf = new char[zlen]);
+	nblk = pos = 0;
+	nread = 0;
+	time = delay = 0.0;
+	vci = NILVCI;
+	len = kind = 0;
+}
+
+tracerd::~tracerd()
+{
+	fclose(fp);
+	delete[] blk;
+	delete[] zbuf;
+	delete[] fname;
+}
+
+/*
+*	Read the next record. Returns FALSE at the end of the file.
+*/
+int	tracerd::read(void)
+{
+	trace_evt	*e;
+
+	while (pos >= nblk)
+		if ( !read_block())
+			return FALSE;
+	e = blk + pos++;
+	time = (double) e->time;
+	delay = (double) e->delay;
+	vci = e->vci;
+	len = e->len;
+	kind = e->kind;
+	++nread;
+	return TRUE;
+}
+
+int	tracerd::read_block(void)
+{
+	trace_blk	b;
+	size_t	n;
+
+	if (fread(&b, sizeof(b), 1, fp) != 1)
+		return FALSE;	// end of file
+	if (b.nrec > hdr.block || b.rawlen != b.nrec * sizeof(trace_evt) ||
+			b.len > zlen)
+		errm1s("tracerd: corrupt block in `%s'", fname);
+	if ( !codec_ok(b.codec))
+		errm2s("tracerd: `%s': codec `%s' not compiled in", fname,
+			(char *) (b.codec <= TRACE_ZSTD ? trace_codecs[b.codec] : "?"));
+
+	if (b.codec == TRACE_RAW)
+	{	if (b.len != b.rawlen || fread(blk, 1, b.len, fp) != b.len)
+			errm1s("tracerd: truncated file `%s'", fname);
+	}
+	else
+	{	if (fread(zbuf, 1, b.len, fp) != b.len)
+			errm1s("tracerd: truncated file `%s'", fname);
+		n = 0;
+		switch (b.codec) {
+#ifdef	HAVE_LZ4
+		case TRACE_LZ4:
+			n = LZ4_decompress_safe(zbuf, (char *) blk, b.len, b.rawlen);
+			break;
+#endif
+#ifdef	HAVE_ZSTD
+		case TRACE_ZSTD:
+			n = ZSTD_decompress(blk, b.rawlen, zbuf, b.len);
+			if (ZSTD_isError(n))
+				n = 0;
+			break;
+#endif
+		}
+		if (n != b.rawlen)
+			errm1s("tracerd: corrupt block in `%s'", fname);
+	}
+	nblk = b.nrec;
+	pos = 0;
+	return TRUE;
+}
@@ -0,0 +1,198 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+#ifndef	_TRACEWR_H_
+#define	_TRACEWR_H_
+
+#include "defs.h"
+#include <pthread.h>
+
+/*
+*	Binary event traces.
+*
+*	A tracewr collects fixed size records (time, delay, VCI or connection
+*	ID, length, kind) of one object. put() only stores the record in a
+*	ring buffer; one writer thread, shared by all tracewr of the process,
+*	takes the records out in blocks of TRACE_BLOCK records, compresses
+*	them optionally and writes them to the files. The simulation waits
+*	only if a ring is full.
+*
+*	File layout: trace_hdr, then blocks, each a trace_blk followed by
+*	its (compressed) records. The codec is stored per block: blocks
+*	which do not get smaller are stored raw.
+*
+*	Codecs: TRACE_RAW, TRACE_LZ4 (compile with -DHAVE_LZ4, link -llz4)
+*	and TRACE_ZSTD (-DHAVE_ZSTD, -lzstd). tracerd reads all codecs
+*	compiled in.
+*
+*	In child processes (sim:branch(), replications), records of writers
+*	inherited are dropped, since the files belong to the parent; writers
+*	created in the child get a writer thread of their own. Writers not
+*	deleted are flushed at exit.
+*/
+
+#define	TRACE_RING	(1 << 16)	// records per ring, power of two
+#define	TRACE_BLOCK	(1 << 12)	// records per block, divides TRACE_RING
+#define	TRACE_MAGIC	"YATSTRC"
+#define	TRACE_VERSION	(2)	// 2: 64 bit delay
+
+struct	trace_evt {
+  unsigned long long time;	// SimTime of the event
+  unsigned long long delay;	// transfer delay (or IAT), slots
+  int		vci;		// VCI or connection ID, NILVCI: none
+  unsigned int	len;		// length in bytes or cells, 0: none
+  unsigned short kind;		// TREC_xxx
+  unsigned short spare;
+  unsigned int	spare2;
+};
+
+struct	trace_hdr {
+  char		magic[8];
+  unsigned int	version;
+  unsigned int	recsize;	// sizeof(trace_evt)
+  unsigned int	block;		// max. records per block
+  unsigned int	codec;		// codec requested
+  unsigned long long spare;
+};
+
+struct	trace_blk {
+  unsigned int	nrec;		// records in the block
+  unsigned int	codec;		// codec of the block
+  unsigned int	rawlen;		// bytes uncompressed
+  unsigned int	len;		// bytes stored
+};
+
+//tolua_begin
+enum {
+  TRACE_RAW = 0,
+  TRACE_LZ4 = 1,
+  TRACE_ZSTD = 2
+};
+
+enum {
+  TREC_ARRIVAL = 1,		// arrival at a sink, delay: IAT
+  TREC_DELAY = 2,		// transfer delay of a cell or frame
+  TREC_PDU = 3,			// delay of a TCP PDU
+  TREC_SDU = 4			// delay of a TCP SDU
+};
+
+class	tracewr {
+public:
+  tracewr(char *fname, int codec = TRACE_RAW);
+  ~tracewr();
+  void flush(void);
+  double getRecords(void) {return (double) head;}
+  double getDropped(void) {return (double) dropped;}
+  int getCodec(void) {return codec;}
+  //tolua_end
+
+  inline void put(
+	int	kind,
+	tim_typ	delay,
+	int	vci,
+	unsigned len)
+  {
+    trace_evt	*e;
+
+    if (gen != TraceGen) {	// forked child
+      ++dropped;
+      return;
+    }
+    if (head - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) >= TRACE_RING)
+      wait_room();
+    e = ring + (head & (TRACE_RING - 1));
+    e->time = SimTime;
+    e->delay = delay;
+    e->vci = vci;
+    e->len = len;
+    e->kind = (unsigned short) kind;
+    e->spare = 0;
+    __atomic_store_n(&head, head + 1, __ATOMIC_RELEASE);
+    if ((head & (TRACE_BLOCK - 1)) == 0)
+      kick();
+  }
+
+  static int	TraceGen;	// incremented in forked children
+
+private:
+  void	wait_room(void);
+  void	kick(void);
+  int	write_block(unsigned long long, int);
+  int	write_all(const void *, size_t);
+  static void *run(void *);
+  static void at_fork(void);
+  static void at_exit(void);
+
+  char		*fname;
+  int		fd;
+  int		codec;
+  int		gen;		// TraceGen at creation
+  int		ioerr;		// errno of the writer thread, 0: o.k.
+  int		flushreq;	// flush() waits for the writer thread
+  unsigned long long head;	// written by put()
+  unsigned long long tail;	// written by the writer thread
+  unsigned long long dropped;
+  trace_evt	*ring;
+  trace_evt	*blk;		// block taken out of the ring
+  char		*zbuf;		// compressed block
+  size_t	zlen;
+  tracewr	*next;		// all writers of the process
+  static tracewr *all;
+
+  // the writer thread of all writers, protected by mtx
+  static int	thread_gen;	// TraceGen of the running thread, -1: none
+  static pthread_t thread;
+  static pthread_mutex_t mtx;
+  static pthread_cond_t data;	// signalled by put() and flush()
+  static pthread_cond_t room;	// signalled by the writer thread
+}; //tolua_export
+
+//tolua_begin
+class	tracerd {
+public:
+  tracerd(char *fname);
+  ~tracerd();
+  int read(void);		// next record to the fields below, FALSE: EOF
+  double getRecords(void) {return (double) nread;}
+  int getCodec(void) {return hdr.codec;}
+  double time;			// fields of the last record read
+  double delay;
+  int vci;
+  int len;
+  int kind;
+  //tolua_end
+
+private:
+  int	read_block(void);
+
+  char		*fname;
+  FILE		*fp;
+  trace_hdr	hdr;
+  trace_evt	*blk;
+  char		*zbuf;
+  size_t	zlen;
+  unsigned	nblk;		// records in blk
+  unsigned	pos;		// next record in blk
+  unsigned long long nread;
+}; //tolua_export
+
+#endif	// _TRACEWR_H_
@@ -7,6 +7,8 @@ extern "C" {
 #include "stdlib.h"
 #include "stdio.h"
 #include "stdarg.h"
+#include "unistd.h"
+#include "sys/wait.h"
 #include "lua.h"
 #include "lualib.h"
 #include "lauxlib.h"
@@ -38,6 +40,51 @@ void delete_object(root *obj)
    delete(obj);
 }
 
+//////////////////////////////////////////////////////////////////////
+// Process control for parallel replications (see yats/replica.lua)
+static int procstat = 0;
+
+// Start a worker process: returns 0 in the worker, its pid in the parent
+int forkproc(void)
+{
+  int pid;
+  // do not let the worker inherit buffered output
+  fflush(NULL);
+  pid = fork();
+#ifdef PDES
+  // the threads of parallel simulation are not inherited
+  if (pid == 0)
+    pdes_forked();
+#endif
+  return pid;
+}
+
+// Wait for any worker to terminate: returns its pid or -1 if there is none
+int waitproc(void)
+{
+  int pid, status;
+  if ((pid = waitpid(-1, &status, 0)) < 0)
+    return -1;
+  if (WIFEXITED(status))
+    procstat = WEXITSTATUS(status);
+  else
+    procstat = -1;
+  return pid;
+}
+
+// Exit status of the worker returned by the last waitproc(), -1: killed
+int procstatus(void)
+{
+  return procstat;
+}
+
+// Terminate a worker without running the exit handlers of the parent
+void exitproc(int code)
+{
+  fflush(NULL);
+  _exit(code);
+}
+
 #if 0
 void start_lua(char *fname)
 {
@@ -77,11 +124,43 @@ void start_lua(char *fname)
 #endif
 //////////////////////////////////////////////////////////////////////
 // lua1out and luaxout: Lua Object base classes
+//
+// The dispatch functions (__YATSEARLY, __YATSLATE, __YATSREC) are looked
+// up by act() of the first Lua object and then kept as references in the
+// registry; refresh_callbacks() (called by sim:run()) looks them up again,
+// so that redefined functions are used by the next run. Per event we only
+// need a lua_rawgeti() instead of a lookup in the global table. The
+// userdata of the object and of the event come from tolua's cache.
+static int ref_early = LUA_NOREF;
+static int ref_late = LUA_NOREF;
+static int ref_rec = LUA_NOREF;
+
+static void resolve_callback(int *ref, const char *fname)
+{
+  luaL_unref(WL, LUA_REGISTRYINDEX, *ref);
+  lua_getglobal(WL, fname);
+  *ref = luaL_ref(WL, LUA_REGISTRYINDEX);
+}
+
+// Look up the dispatch functions (again)
+void refresh_callbacks(void)
+{
+  resolve_callback(&ref_early, "__YATSEARLY");
+  resolve_callback(&ref_late, "__YATSLATE");
+  resolve_callback(&ref_rec, "__YATSREC");
+}
+
+static int act_callbacks(void)
+{
+  if (ref_early == LUA_NOREF)
+    refresh_callbacks();
+  return 0;
+}
+
 static void callback_early(root *obj, event *ev, const char *cl)
 {
   // Call a lua routine: _YATSEARLY(yatsobj, event)
-  lua_pushstring(WL, "__YATSEARLY");
-  lua_gettable(WL, LUA_GLOBALSINDEX);
+  lua_rawgeti(WL, LUA_REGISTRYINDEX, ref_early);
   // yatsobj on stack
   tolua_pushusertype(WL, obj, cl);
   // ev on stack
@@ -92,9 +171,8 @@ static void callback_early(root *obj, event *ev, const char *cl)
 
 static void callback_late(root *obj, event *ev, const char *cl)
 {
-  // Call a lua routine: _YATSEARLY(yatsobj, event)
-  lua_pushstring(WL, "__YATSLATE");
-  lua_gettable(WL, LUA_GLOBALSINDEX);
+  // Call a lua routine: _YATSLATE(yatsobj, event)
+  lua_rawgeti(WL, LUA_REGISTRYINDEX, ref_late);
   // yatsobj on stack
   tolua_pushusertype(WL, obj, cl);
   // ev on stack
@@ -106,9 +184,8 @@ static void callback_late(root *obj, event *ev, const char *cl)
 static rec_typ callback_rec(root *obj, data *pd, int i, const char *cl)
 {
   rec_typ rv;
-  // Call a lua routine: _YATSEARLY(yatsobj, event)
-  lua_pushstring(WL, "__YATSREC");
-  lua_gettable(WL, LUA_GLOBALSINDEX);
+  // Call a lua routine: _YATSREC(yatsobj, data, input)
+  lua_rawgeti(WL, LUA_REGISTRYINDEX, ref_rec);
   // yatsobj on stack
   tolua_pushusertype(WL, obj, cl);
   // pd on stack
@@ -128,6 +205,11 @@ lua1out::lua1out(void)
   debug("Constructor: lua1out\n");
 }
 
+int lua1out::act(void)
+{
+  return act_callbacks();
+}
+
 void lua1out::early(event *ev)
 {
   callback_early(this, ev, "lua1out");
@@ -143,6 +225,11 @@ rec_typ lua1out::REC(data *pd, int i)
   return callback_rec(this, pd, i, "lua1out");
 }
 
+int luaxout::act(void)
+{
+  return act_callbacks();
+}
+
 void luaxout::early(event *ev)
 {
   callback_early(this, ev, "luaxout");
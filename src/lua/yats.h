@@ -15,11 +15,17 @@ extern lua_State *WL;
 void delete_object(root *);
 void workerentry(void);
 void workerexit(void);
+int forkproc(void);
+int waitproc(void);
+int procstatus(void);
+void exitproc(int);
+void refresh_callbacks(void);
 class lua1out: public in1out
 {
 public:
    lua1out(void);
    ~lua1out(){};
+   int act(void);
    void early(event *);
    void late(event *);
    rec_typ REC(data *, int);
@@ -31,6 +37,7 @@ class luaxout: public inxout
 public:
    luaxout(void){}
    ~luaxout(){}
+   int act(void);
    void early(event *);
    void late(event *);
    rec_typ REC(data *, int);
@@ -109,7 +109,7 @@ void	ip2atm::early(event *)
 	// send cell
 	suc->rec(new cell(vci), shand);
 
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( ++counter))
 		errm1s("%s: overflow of departs", name);
 
 	if (++send_cnt < b_len)
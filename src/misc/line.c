@@ -47,6 +47,9 @@
 *
 * The object holds cells in an own queue, therefore an object is registered only once
 * at the kernel.
+*
+* Lines decouple the partitions of a parallel simulation (PDES): a line can
+* belong to another partition than its predecessor, the delay is the lookahead.
 */
 
 #include "line.h"
@@ -59,7 +62,7 @@ line::~line()
 {
 }
 
-line::lineItem *line::lineItemPool = NULL;
+THREAD_LOCAL line::lineItem *line::lineItemPool = NULL;
 
 
 // Initialisation by Lua
@@ -96,6 +99,15 @@ rec_typ line::REC( // REC is a macro normally expanding to rec (for debugging)
 {
    lineItem *pi;
 
+#ifdef PDES
+   // sent from another partition: the thread of our partition
+   // calls us again in its next window (see pdes.c)
+   if (PDES_REMOTE(this)) {
+      pdes_post(this, pd, 0);
+      return ContSend;
+   }
+#endif
+
    if ((pi = lineItemPool) == NULL)
       CHECK(pi = new lineItem); // The operator new is not overloaded,
    // but after a short time we should have enough
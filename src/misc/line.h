@@ -60,10 +60,10 @@ class line: public in1out
 	 data *item;  // the data item to be queued
       };
    
-   static lineItem *lineItemPool; // Our own pool of lineItems.
+   static THREAD_LOCAL lineItem *lineItemPool; // Our own pool of lineItems.
    // LineItmes are allocated via standard new,
    // but never given back (are never deleted).
-   // The pool is shared by all lines.
+   // The pool is shared by all lines (of a thread, see PDES).
    
 
    uqueue q;  // system queue
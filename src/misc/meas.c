@@ -45,6 +45,15 @@
 *
 *	If VCI=-1, all cells are included in measurement
 *
+*	With a relative precision hist_prec > 0 (Lua: hist=0.01), all transfer
+*	times are additionally collected in a log-linear histogram (hdrhist),
+*	which provides quantiles independent of maxtim. maxtim may be 0 then.
+*	The exported P50, P99 and P999 are updated at least at the end of
+*	every sim::run() (see hdrhist.h).
+*
+*	With a trace writer (Lua: trace="file"), every transfer time is
+*	written as a TREC_DELAY record to a binary trace (see tracewr.h).
+*
 *	Commands:
 *		<Name>->Count
 *			return cell count
@@ -62,12 +71,20 @@
 
 meas::meas()
 {
+  dist = NULL;
+  hist = NULL;
+  hist_prec = 0.0;
+  trace = NULL;
 }
 
 meas::~meas()
 {
   if (dist)
     delete dist;
+  if (hist)
+    delete hist;
+  if (trace)
+    delete trace;
 }
 /*
 *	Cell has arrived.
@@ -81,9 +98,10 @@ rec_typ	meas::REC(	// REC is a macro normally expanding to rec (for debugging)
 	tim_typ	dt;
 
 	typecheck(pd, inp_type);
+	traincheck(pd);
 
 	if (vci == NILVCI || ((cell *) pd)->vci == vci)
-	{	if ( ++counter == 0)
+	{	if ( CNT_OVERFLOW( ++counter))
 			errm1s("%s: overflow of arrivals", name);
 		dt = SimTime - pd->time;
 		if (dt < (unsigned) maxtim)
@@ -92,6 +110,12 @@ rec_typ	meas::REC(	// REC is a macro normally expanding to rec (for debugging)
 		}
 		else if ( ++greater_cnt == 0)
 			errm1s("%s: overflow of greater_cnt", name);
+		if (hist && hist->add(dt) == 0)
+			errm1s("%s: overflow of hist", name);
+		if (trace)
+			trace->put(TREC_DELAY, dt,
+				typequery(pd, CellType) ? ((cell *) pd)->vci : NILVCI,
+				typequery(pd, FrameType) ? ((frame *) pd)->frameLen : 0);
 	}
 
 	if (suc != NULL)
@@ -123,6 +147,8 @@ int	meas::command(
 	{	greater_cnt = 0;
 		for (i = 0; i < maxtim; ++i)
 			dist[i] = 0;
+		if (hist)
+			hist->reset();
 	}
 	else	return FALSE;
 
@@ -135,6 +161,12 @@ int	meas::command(
 int	meas::export(
 	exp_typ	*msg)
 {
+	if (hist)
+		hist->refresh();
 	return	baseclass::export(msg) ||
-		intArray1(msg, "Dist", (int *) dist, maxtim, 0);	// IAT table
+		intArray1(msg, "Dist", (int *) dist, maxtim, 0) ||	// IAT table
+		(hist && intArray1(msg, "Hist", (int *) hist->counts, hist->nbuckets, 0)) ||
+		(hist && doubleScalar(msg, "P50", &hist->pq[0])) ||
+		(hist && doubleScalar(msg, "P99", &hist->pq[1])) ||
+		(hist && doubleScalar(msg, "P999", &hist->pq[2]));
 }
@@ -30,6 +30,8 @@
 #define	_MEAS_H_
 
 #include "in1out.h"
+#include "hdrhist.h"
+#include "tracewr.h"
 
 //tolua_begin
 class	meas:	public	in1out {
@@ -45,6 +47,8 @@ class	meas:	public	in1out {
     int i;
     greater_cnt = 0;
     for (i=0; i < maxtim; i++) dist[i] = 0;
+    if (hist)
+      hist->reset();
   }
   int act(void){
     int i;
@@ -55,12 +59,17 @@ class	meas:	public	in1out {
     CHECK(dist = new unsigned int[maxtim]);
     for (i = 0; i < maxtim; ++i)
       dist[i] = 0;
+    if (hist_prec > 0.0)
+      CHECK(hist = new hdrhist(hist_prec));
     return 0;
   }
   dat_typ	inp_type;		// type of input data
   
   int		maxtim;		/* max. cell transfer time */
   unsigned	greater_cnt;	/* counter for not registered times */
+  double	hist_prec;	/* relative precision of hist, 0: no hist */
+  hdrhist	*hist;		/* log-linear CTD histogram, or NULL */
+  tracewr	*trace;		/* binary trace of the CTDs, or NULL */
   //tolua_end
   unsigned	*dist;		/* CTDs */
 }; //tolua_export
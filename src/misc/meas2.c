@@ -69,6 +69,11 @@
 *		ms->MeanIAT
 *		ms->MaxIAT
 *		ms->MinIAT
+*
+*	With a relative precision hist_prec > 0 (Lua: hist=0.01), CTDs and IATs
+*	are additionally collected in log-linear histograms (hdrhist), which
+*	provide quantiles independent of MAXCTD and MAXIAT. The exported
+*	CTDp50 ... IATp999 are updated at least at the end of every sim::run().
 */
 
 #include "meas2.h"
@@ -79,6 +84,10 @@ meas2::~meas2()
     delete ctd_dist;
   if (iat_dist)
     delete iat_dist;
+  if (ctd_hist)
+    delete ctd_hist;
+  if (iat_hist)
+    delete iat_hist;
 }
 
 int meas2::act(void)
@@ -92,6 +101,11 @@ int meas2::act(void)
   for (i = 0; i < iat_max; ++i)
     iat_dist[i] = 0;
   
+  if (hist_prec > 0.0) {
+    CHECK(ctd_hist = new hdrhist(hist_prec));
+    CHECK(iat_hist = new hdrhist(hist_prec));
+  }
+
   ctd_overfl = 0;
   iat_overfl = 0;
   last_time = 0;
@@ -174,10 +188,11 @@ rec_typ	meas2::REC(	// REC is a macro normally expanding to rec (for debugging)
 	tim_typ	tim;
 
 	typecheck(pd, inp_type);	// input data type check
+	traincheck(pd);
 
 	if (vci == NILVCI || ((cell *) pd)->vci == vci)
 	{	//	Cell count
-		if ( ++counter == 0)
+		if ( CNT_OVERFLOW( ++counter))
 			errm1s("%s: overflow of counter", name);
 
 		//	Cell Transfer Delay
@@ -188,6 +203,8 @@ rec_typ	meas2::REC(	// REC is a macro normally expanding to rec (for debugging)
 		}
 		else if ( ++ctd_overfl == 0)
 			errm1s("%s: overflow of ctd_overfl", name);
+		if (ctd_hist && ctd_hist->add(tim) == 0)
+			errm1s("%s: overflow of ctd_hist", name);
 
 		//	Inter Arrival Time
 		tim = SimTime - last_time;
@@ -198,6 +215,8 @@ rec_typ	meas2::REC(	// REC is a macro normally expanding to rec (for debugging)
 		}
 		else if ( ++iat_overfl == 0)
 			errm1s("%s: overflow of iat_overfl", name);
+		if (iat_hist && iat_hist->add(tim) == 0)
+			errm1s("%s: overflow of iat_hist", name);
 
 	}
 
@@ -292,9 +311,21 @@ int	meas2::command(
 int	meas2::export(
 	exp_typ	*msg)
 {
+	if (ctd_hist)
+		ctd_hist->refresh();
+	if (iat_hist)
+		iat_hist->refresh();
 	return	baseclass::export(msg)  ||
 		intArray1(msg, "IAT", (int *) iat_dist, iat_max, 0) ||	// IAT table
 		intArray1(msg, "CTD", (int *) ctd_dist, ctd_max, 0) ||	// CTD table
 		intScalar(msg, "CTDover", (int *) &ctd_overfl) ||
-		intScalar(msg, "IATover", (int *) &iat_overfl);
+		intScalar(msg, "IATover", (int *) &iat_overfl) ||
+		(ctd_hist && intArray1(msg, "CTDHist", (int *) ctd_hist->counts, ctd_hist->nbuckets, 0)) ||
+		(ctd_hist && doubleScalar(msg, "CTDp50", &ctd_hist->pq[0])) ||
+		(ctd_hist && doubleScalar(msg, "CTDp99", &ctd_hist->pq[1])) ||
+		(ctd_hist && doubleScalar(msg, "CTDp999", &ctd_hist->pq[2])) ||
+		(iat_hist && intArray1(msg, "IATHist", (int *) iat_hist->counts, iat_hist->nbuckets, 0)) ||
+		(iat_hist && doubleScalar(msg, "IATp50", &iat_hist->pq[0])) ||
+		(iat_hist && doubleScalar(msg, "IATp99", &iat_hist->pq[1])) ||
+		(iat_hist && doubleScalar(msg, "IATp999", &iat_hist->pq[2]));
 }
@@ -30,13 +30,14 @@
 #define	_MEAS2_H_
 
 #include "in1out.h"
+#include "hdrhist.h"
 
 //tolua_begin
 class	meas2:	public	in1out {
   typedef	in1out	baseclass;
   
 public:
-  meas2(){}
+  meas2(){ctd_dist = iat_dist = NULL; ctd_hist = iat_hist = NULL; hist_prec = 0.0;}
   ~meas2();
   int act(void);
   int getCTD(int i){return this->ctd_dist[i];}
@@ -47,6 +48,9 @@ public:
   int		iat_max;		// max inter arrival time
   unsigned	iat_overfl;		// overflow of IAT
   unsigned	ctd_overfl;		// overflow of CTD
+  double	hist_prec;		// relative precision of histograms, 0: none
+  hdrhist	*ctd_hist;		// log-linear CTD histogram, or NULL
+  hdrhist	*iat_hist;		// log-linear IAT histogram, or NULL
   //tolua_end
   unsigned	*ctd_dist;		// CTDs 
   unsigned	*iat_dist;		// IATs 
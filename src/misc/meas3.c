@@ -73,6 +73,9 @@
 *   // if ERANGE given: out-of-range cells or frames cause an error.
 *   //  otherwise: only the overall counter is incremented
 *   // if OUT is omitted, then the device is a sink
+*  // Lua only: hist=<relative precision>
+*   // CTDs and IATs (if measured) are additionally collected in log-linear
+*   // histograms (hdrhist), unscaled and independent of the ranges given.
 *
 * Commands:
 *  // the following variables actually are exported, i.e. they can be visualised
@@ -102,6 +105,10 @@
 *  ms->MeanIAT(i)  // current cumulative mean IAT value
 *  ms->MaxIAT(i)  // largest encountered IAT
 *  ms->MinIAT(i)  // smallest encountered IAT
+*  ms->CTDHist(i, j) // bucket j of the CTD histogram (see hdrhist.h)
+*  ms->IATHist(i, j) // bucket j of the IAT histogram
+*  ms->CTDp50(i), ms->CTDp99(i), ms->CTDp999(i) // quantiles of the CTD histogram
+*  ms->IATp50(i), ms->IATp99(i), ms->IATp999(i) // quantiles of the IAT histogram
 *
 *  Classical commands:
 *  ms->ResStats
@@ -156,6 +163,23 @@ meas3::~meas3()
     }
     delete iat_dist;
   }
+
+  if (ctd_hist) {
+    for (idx = 0; idx < idx_max; ++idx)
+      delete ctd_hist[idx];
+    delete[] ctd_hist;
+    delete[] ctd_hcounts;
+    for (idx = 0; idx < 3; ++idx)
+      delete[] ctd_pq[idx];
+  }
+  if (iat_hist) {
+    for (idx = 0; idx < idx_max; ++idx)
+      delete iat_hist[idx];
+    delete[] iat_hist;
+    delete[] iat_hcounts;
+    for (idx = 0; idx < 3; ++idx)
+      delete[] iat_pq[idx];
+  }
   
   delete counters;
   delete counters_byte;
@@ -240,6 +264,31 @@ int meas3::act(void)
       iat_dist = NULL;
    }
 
+   ctd_hist = iat_hist = NULL;
+   ctd_hcounts = iat_hcounts = NULL;
+   if (hist_prec > 0.0 && doMeanCTD) {
+      CHECK(ctd_hist = new hdrhist * [idx_max]);
+      CHECK(ctd_hcounts = new int * [idx_max]);
+      for (i = 0; i < 3; ++i)
+         CHECK(ctd_pq[i] = new double [idx_max]);
+      for (idx = 0; idx < idx_max; ++idx) {
+         CHECK(ctd_hist[idx] = new hdrhist(hist_prec));
+         ctd_hcounts[idx] = (int *) ctd_hist[idx]->counts;
+         ctd_hist[idx]->setQuantileOut(&ctd_pq[0][idx], &ctd_pq[1][idx], &ctd_pq[2][idx]);
+      }
+   }
+   if (hist_prec > 0.0 && doMeanIAT) {
+      CHECK(iat_hist = new hdrhist * [idx_max]);
+      CHECK(iat_hcounts = new int * [idx_max]);
+      for (i = 0; i < 3; ++i)
+         CHECK(iat_pq[i] = new double [idx_max]);
+      for (idx = 0; idx < idx_max; ++idx) {
+         CHECK(iat_hist[idx] = new hdrhist(hist_prec));
+         iat_hcounts[idx] = (int *) iat_hist[idx]->counts;
+         iat_hist[idx]->setQuantileOut(&iat_pq[0][idx], &iat_pq[1][idx], &iat_pq[2][idx]);
+      }
+   }
+
    CHECK(counters = new unsigned int [idx_max]);
    for (idx = 0; idx < idx_max; ++idx)
       counters[idx] = 0;
@@ -335,6 +384,9 @@ rec_typ meas3::REC( // REC is a macro normally expanding to rec (for debugging)
          maxCTD[idx] = tim;
       meanCTD[idx] = ((cnt - 1) * meanCTD[idx] + tim) / (double) cnt;
 
+      if (ctd_hist && ctd_hist[idx]->add(tim) == 0)
+         errm1s1d("%s: overflow of ctd_hist[%d]", name, idx);
+
       if (ctd_dist) { // detailed distribution
          if ((tim /= (tim_typ) ctd_div) < (tim_typ) ctd_min) {
             if ( ++ctd_underfl[idx] == 0)
@@ -362,6 +414,9 @@ rec_typ meas3::REC( // REC is a macro normally expanding to rec (for debugging)
          maxIAT[idx] = tim;
       meanIAT[idx] = ((cnt - 1) * meanIAT[idx] + tim) / (double) cnt;
 
+      if (iat_hist && iat_hist[idx]->add(tim) == 0)
+         errm1s1d("%s: overflow of iat_hist[%d]", name, idx);
+
       if (iat_dist) { // detailed distribution
          if ((tim /= (tim_typ) iat_div) < (tim_typ) iat_min) {
             if ( ++iat_underfl[idx] == 0)
@@ -378,7 +433,7 @@ rec_typ meas3::REC( // REC is a macro normally expanding to rec (for debugging)
    }
 
 xit:  // for out-of-range data objects we directly jump here
-   if ( ++counter == 0)
+   if ( CNT_OVERFLOW( ++counter))
       errm1s("%s: overflow of counter", name);
 
    if (suc != NULL)
@@ -425,6 +480,10 @@ int meas3::command(
             maxIAT[idx] = 0;
             meanIAT[idx] = 0.0;
          }
+         if (ctd_hist)
+            ctd_hist[idx]->reset();
+         if (iat_hist)
+            iat_hist[idx]->reset();
          counters[idx] = 0;
          counters_byte[idx] = 0;
       }
@@ -466,6 +525,13 @@ void meas3::late(event *evt)
 int meas3::export(
    exp_typ *msg)
 {
+  int idx;
+  for (idx = 0; idx < idx_max; ++idx) {
+     if (ctd_hist)
+        ctd_hist[idx]->refresh();
+     if (iat_hist)
+        iat_hist[idx]->refresh();
+  }
   return (baseclass::export(msg) ||
           intScalar(msg, "Count_byte", (int *) &counter_byte) ||
           doubleScalar(msg, "FrameRate", (double *) &FrameRate) ||
@@ -474,13 +540,25 @@ int meas3::export(
           (ctd_dist && intArray2(msg, "CTD", (int **) ctd_dist, idx_max, idx_min, ctd_max, ctd_min)) ||
           (ctd_overfl && intArray1(msg, "CTDover", (int *) ctd_overfl, idx_max, idx_min)) ||
           (ctd_underfl && intArray1(msg, "CTDunder", (int *) ctd_underfl, idx_max, idx_min)) ||
+#ifndef TIME64 // tim_typ arrays are no int arrays
           (minCTD && intArray1(msg, "MinCTD", (int *) minCTD, idx_max, idx_min)) ||
           (maxCTD && intArray1(msg, "MaxCTD", (int *) maxCTD, idx_max, idx_min)) ||
+#endif
           (meanCTD && doubleArray1(msg, "MeanCTD", meanCTD, idx_max, idx_min)) ||
           (iat_dist && intArray2(msg, "IAT", (int **) iat_dist, idx_max, idx_min, iat_max, iat_min)) ||
           (iat_overfl && intArray1(msg, "IATover", (int *) iat_overfl, idx_max, idx_min)) ||
           (iat_underfl && intArray1(msg, "IATunder", (int *) iat_underfl, idx_max, idx_min)) ||
+#ifndef TIME64
           (minIAT && intArray1(msg, "MinIAT", (int *) minIAT, idx_max, idx_min)) ||
           (maxIAT && intArray1(msg, "MaxIAT", (int *) maxIAT, idx_max, idx_min)) ||
-          (meanIAT && doubleArray1(msg, "MeanIAT", meanIAT, idx_max, idx_min)));
+#endif
+          (meanIAT && doubleArray1(msg, "MeanIAT", meanIAT, idx_max, idx_min)) ||
+          (ctd_hist && intArray2(msg, "CTDHist", ctd_hcounts, idx_max, idx_min, ctd_hist[0]->nbuckets, 0)) ||
+          (ctd_hist && doubleArray1(msg, "CTDp50", ctd_pq[0], idx_max, idx_min)) ||
+          (ctd_hist && doubleArray1(msg, "CTDp99", ctd_pq[1], idx_max, idx_min)) ||
+          (ctd_hist && doubleArray1(msg, "CTDp999", ctd_pq[2], idx_max, idx_min)) ||
+          (iat_hist && intArray2(msg, "IATHist", iat_hcounts, idx_max, idx_min, iat_hist[0]->nbuckets, 0)) ||
+          (iat_hist && doubleArray1(msg, "IATp50", iat_pq[0], idx_max, idx_min)) ||
+          (iat_hist && doubleArray1(msg, "IATp99", iat_pq[1], idx_max, idx_min)) ||
+          (iat_hist && doubleArray1(msg, "IATp999", iat_pq[2], idx_max, idx_min)));
 }
@@ -30,6 +30,7 @@
 #define _MEAS3_H_
 
 #include "in1out.h"
+#include "hdrhist.h"
 
 //tolua_begin
 typedef enum {
@@ -42,7 +43,7 @@ class meas3: public in1out
 
    public:
 
-      meas3() : evtStatTimer(this, keyStatTimer) {};
+      meas3() : evtStatTimer(this, keyStatTimer) {hist_prec = 0.0;};
       ~meas3();
       event evtStatTimer;       // Statistics Timer
 
@@ -86,6 +87,10 @@ class meas3: public in1out
       int getMinIAT(int i){ return this->minIAT[i];}
       int getMaxIAT(int i){ return this->maxIAT[i];}
       double getMeanIAT(int i){ return this->meanIAT[i];}
+
+      double hist_prec; // relative precision of histograms, 0: none
+      hdrhist *getCTDHist(int i){ return (ctd_hist && i >= 0 && i < idx_max) ? ctd_hist[i] : NULL;}
+      hdrhist *getIATHist(int i){ return (iat_hist && i >= 0 && i < idx_max) ? iat_hist[i] : NULL;}
 //tolua_end
       
       int command(char *, tok_typ *);
@@ -113,6 +118,13 @@ class meas3: public in1out
       double *meanIAT;
 
       tim_typ *last_time; // time of last arrival
+
+      hdrhist **ctd_hist; // log-linear CTD histograms, or NULL
+      hdrhist **iat_hist; // log-linear IAT histograms, or NULL
+      int **ctd_hcounts; // their counters, for export
+      int **iat_hcounts;
+      double *ctd_pq[3]; // their p50, p99, p99.9 per index, for export
+      double *iat_pq[3];
 };  //tolua_export
 
 
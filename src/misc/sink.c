@@ -54,7 +54,7 @@ rec_typ	sink::REC(	// REC is a macro normally expanding to rec (for debugging)
 {
 	typecheck(d, DataType);
 
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( ++counter))
 		errm1s("%s: overflow of arrivals", name);
 	delete d;
 
@@ -36,53 +36,103 @@
 *	A sink:	- count incomming cells
 *		- write IATs to a trace file (ASCII)
 *
-*	SinkTrace sink: FILE="trace.dat";
+*	SinkTrace sink: [FORMAT="raw"|"lz4"|"zstd",] FILE="trace.dat";
+*
+*	With FORMAT, the IATs are written as TREC_ARRIVAL records to a binary
+*	trace (see tracewr.h) instead, together with the VCI of cells and the
+*	length of frames.
+*
+*	Lua: yats.sinktrace{file = "iat.dat"} or
+*	     yats.sinktrace{trace = {file = "iat.trc", codec = "lz4"}}
 */
 
-#include "in1out.h"
-
-class	sinktr:	public	in1out {
-typedef	in1out	baseclass;
+#include "sinktrac.h"
 
-public:
-	void	init(void);
-	rec_typ	REC(data *, int);	// REC is a macro normally expanding to rec (for debugging)
+CONSTRUCTOR(SinkTrace, sinktrace);
 
-	char	*filnam;
-	FILE	*filfp;
+sinktrace::sinktrace()
+{
+	filnam = NULL;
+	filfp = NULL;
+	trace = NULL;
+	lastArrival = 0;
+}
 
-	tim_typ	lastArrival;
-};
+sinktrace::~sinktrace()
+{
+	if (trace)
+		delete trace;
+	if (filfp)
+		fclose(filfp);
+	if (filnam)
+		delete filnam;
+}
 
+int	sinktrace::act(void)
+{
+	if (trace == NULL && filfp == NULL)
+		errm1s("%s: neither trace file nor binary trace given", name);
+	return 0;
+}
 
-CONSTRUCTOR(SinkTrace, sinktr);
+void	sinktrace::setFile(
+	char	*fn)
+{
+	if (filfp)
+		fclose(filfp);
+	if (filnam)
+		delete filnam;
+	filnam = strsave(fn);
+	if ((filfp = fopen(filnam, "w")) == NULL)
+		errm2s("%s: could not open file `%s' for writing", name, filnam);
+}
 
-void	sinktr::init(void)
+void	sinktrace::init(void)
 {
+	char	*s;
+	int	codec;
+
 	skip(CLASS);
 	name = read_id(NULL);
 	skip(':');
+	codec = -1;
+	if (test_word("FORMAT"))
+	{	s = read_string("FORMAT");
+		if (strcmp(s, "raw") == 0)
+			codec = TRACE_RAW;
+		else if (strcmp(s, "lz4") == 0)
+			codec = TRACE_LZ4;
+		else if (strcmp(s, "zstd") == 0)
+			codec = TRACE_ZSTD;
+		else	syntax2s("%s: unknown FORMAT `%s'", name, s);
+		delete s;
+		skip(',');
+	}
 	filnam = read_string("FILE");
-	if ((filfp = fopen(filnam, "w")) == NULL)
+	if (codec >= 0)
+		CHECK(trace = new tracewr(filnam, codec));
+	else if ((filfp = fopen(filnam, "w")) == NULL)
 		syntax2s("%s: could not open file `%s' for writing", name, filnam);
 
 	stdinp();
-	lastArrival = 0;
 }
 
-rec_typ	sinktr::REC(	// REC is a macro normally expanding to rec (for debugging)
+rec_typ	sinktrace::REC(	// REC is a macro normally expanding to rec (for debugging)
 	data	*d,
 	int	)
 {
 	typecheck(d, DataType);
 
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( ++counter))
 		errm1s("%s: overflow of arrivals", name);
-	delete d;
-
-	if (fprintf(filfp, "%u\n", SimTime - lastArrival) < 1)
+	if (trace)
+		trace->put(TREC_ARRIVAL, SimTime - lastArrival,
+			typequery(d, CellType) ? ((cell *) d)->vci : NILVCI,
+			typequery(d, FrameType) ? ((frame *) d)->frameLen : 0);
+	else if (fprintf(filfp, TIM_FMT "\n", SimTime - lastArrival) < 1)
 		errm2s("%s: error writing file `%s'", name, filnam);
 	lastArrival = SimTime;
+	delete d;
 
 	return ContSend;
 }
@@ -0,0 +1,61 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*     Copyright (C) 1995-1997	Chair for Telecommunications
+*				Dresden University of Technology
+*				D-01062 Dresden
+*				Germany
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+**************************************************************************
+*
+*	Module author:		Matthias Baumann, TUD
+*	Creation:		March 1997
+*
+*************************************************************************/
+#ifndef	_SINKTRAC_H_
+#define	_SINKTRAC_H_
+
+#include "in1out.h"
+#include "tracewr.h"
+
+//tolua_begin
+class	sinktrace:	public	in1out {
+typedef	in1out	baseclass;
+
+public:
+	sinktrace();
+	~sinktrace();
+	int	act(void);
+	void	setFile(char *);	// ASCII trace of the IATs
+	tracewr	*trace;		// binary trace, or NULL
+//tolua_end
+
+	void	init(void);
+	rec_typ	REC(data *, int);	// REC is a macro normally expanding to rec (for debugging)
+
+	char	*filnam;
+	FILE	*filfp;
+
+	tim_typ	lastArrival;
+};  //tolua_export
+
+#endif	// _SINKTRAC_H_
@@ -73,7 +73,7 @@ rec_typ	xx2snk::REC(	// REC is a macro normally expanding to rec (for debugging)
 
 	typecheck(pd, CellSeqType);
 
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( ++counter))
 		errm1s("%s: overflow of counter", name);
 
 	if (pc->burst_no != burst_no)
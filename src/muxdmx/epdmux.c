@@ -101,7 +101,7 @@ void	muxEPD::late(event *)
 	n = inp_ptr - inp_buff;
 	while (n != 0)
 	{	if (n > 1)
-			p = inp_buff + (my_rand() % n);
+			p = inp_buff + my_randn(n);
 		else	p = inp_buff;
 
 		if (typequery(p->pdata, AAL5CellType))
@@ -142,7 +142,9 @@ void	muxEPD::late(event *)
 	inp_ptr = inp_buff;
 
 	if (q.getlen() != 0)
-		alarme( &std_evt, 1);
+	{	alarme( &std_evt, 1);
+		wakel( &event_each);
+	}
 }
 
 
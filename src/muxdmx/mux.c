@@ -83,6 +83,10 @@
 * can be reused by derived classes (loss is - hopefully - rare, so that the function call will
 * not decrease performance).
 *  Matthias Baumann
+*
+* late() is no longer called in each slot, but only if woken by rec() or if cells are
+* still queued (lazyl() / wakel()). Derived classes have to wake late() themselves if
+* it has more to do than processing the arrivals.
 */
 
 
@@ -111,7 +115,7 @@ int mux::act(void){
   CHECK(inp_buff = new inpstruct[ninp]);
   inp_ptr = inp_buff;
   
-  eachl( &event_each);	// event initialized by mux::mux()
+  lazyl( &event_each);	// event initialized by mux::mux(), woken by rec()
   return 0;
 }
 
@@ -124,8 +128,10 @@ rec_typ mux::REC( // REC is a macro normally expanding to rec (for debugging)
    data *pd,
    int i)
 {
+   traincheck(pd);
    inp_ptr->inp = i;
    (inp_ptr++)->pdata = pd;
+   wakel( &event_each);
 
    return ContSend;
 }
@@ -145,7 +151,7 @@ void mux::late(event *)
    if ((n = inp_ptr - inp_buff) != 0) {
       do {
          if (n > 1)
-            p = inp_buff + (my_rand() % n);
+            p = inp_buff + my_randn(n);
          else
             p = inp_buff;
          if (q.enqueue(p->pdata) == FALSE) // buffer overflow
@@ -160,6 +166,9 @@ void mux::late(event *)
    // -> see early()
    if (old_q_len != 0)
       alarme( &std_evt, 1);
+   // as long as cells are queued, we have to come again
+   if (q.getlen() != 0)
+      wakel( &event_each);
 }
 
 /*
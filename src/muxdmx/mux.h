@@ -76,7 +76,7 @@ class mux: public in1out
       queue q;   // system queue
 //tolua_end
 	
-      event event_each;   // event for the late() method (called in each slot)
+      event event_each;   // event for the late() method (called if woken, see wakel())
 
       int doParseBufSiz;   // TRUE: parse the buffer size in init()
       // can be turned off by derived classes, e.g. muxWFQ
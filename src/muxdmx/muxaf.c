@@ -89,7 +89,7 @@ void muxAF::late(event *) {
     inpstruct *p;
     for (;;) {
       if (n > 1)
-        p = inp_buff + (my_rand() % n);
+        p = inp_buff + my_randn(n);
       else
         p = inp_buff;
       if (q.enqueue(p->pdata) == FALSE) // buffer overflow
@@ -119,6 +119,7 @@ void muxAF::early(event *) {
   if ((p = q.dequeue()) != NULL) {
     served = TRUE;
     q.setmax(q_lo);
+    wakel( &event_each);  // late() has to reset served
     suc->rec(p, shand);
   }
   alarme( &std_evt, active);
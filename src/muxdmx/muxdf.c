@@ -90,7 +90,7 @@ void muxDF::late(event *) {
     inpstruct *p;
     for (;;) {
       if (n > 1)
-        p = inp_buff + (my_rand() % n);
+        p = inp_buff + my_randn(n);
       else
         p = inp_buff;
       if (q.enqueue(p->pdata) == FALSE) // buffer overflow
@@ -97,7 +97,7 @@ void muxDist::late(event *) {
   if ((n = inp_ptr - inp_buff) != 0) {
     for (;;) {
       if (n > 1)
-        p = inp_buff + (my_rand() % n);
+        p = inp_buff + my_randn(n);
       else
         p = inp_buff;
       if (q.enqueue(p->pdata) == FALSE) 
@@ -112,7 +112,7 @@ void muxDist::late(event *) {
 
   // serve one cell, if server is free:
   if (serving == FALSE && q.getlen() != 0) {
-    alarme( &std_evt, table[my_rand() % RAND_MODULO]);
+    alarme( &std_evt, table[my_randn(RAND_MODULO)]);
     serving = TRUE;
   }
 }
@@ -121,5 +121,7 @@ void muxDist::early(event *)
 {
   suc->rec(q.dequeue(), shand);
   serving = FALSE;
+  if (q.getlen() != 0)
+    wakel( &event_each);  // serve the next one in late()
 }
 
@@ -154,7 +154,7 @@ void muxWFQ::late(event *)
   n = inp_ptr - inp_buff;
   while (n > 0) {
     if (n > 1)
-      p = inp_buff + my_rand() % n;
+      p = inp_buff + my_randn(n);
     else
       p = inp_buff;
 
@@ -185,8 +185,10 @@ void muxWFQ::late(event *)
 
   inp_ptr = inp_buff;
 
-  if ( !sortq.isEmpty())
+  if ( !sortq.isEmpty()) {
     alarme( &std_evt, 1);
+    wakel( &event_each);
+  }
 }
 
 /*
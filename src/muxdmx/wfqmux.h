@@ -70,6 +70,7 @@
 * mean cell distance and queue size as well the per-VC queue itself.
 * The sort queue at the mux output does not contain cells, but the wfqpar
 * structures of those VC which currently have a cell in their queue.
+* It is a binary heap (see pqueue.h), so that a cell costs O(log(active VCs)).
 * Therefore the information whether a queue containes cells also says
 * whether this VC currently in the sort queue (used in late() where incomming
 * cells are put into the right queues).
@@ -86,6 +87,7 @@
 
 #include "mux.h"
 #include "oqueue.h"
+#include "pqueue.h"
 
 //tolua_begin
 class wfqpar: public ino {
@@ -121,8 +123,8 @@ public:
   void restim(void);
 
   tim_typ spacTime; // the central WFQ variable "Spacing Time"
-  uoqueue sortq;  // the output sort queue
   //tolua_end
+  pqueue<root> sortq;  // the output sort queue
   wfqpar **partab; // per VC a data structure
   int *qLenVCI; // per VC: input queue length
   //tolua_begin
@@ -72,13 +72,11 @@ void	muxAsyncDF::late(
         inpstruct       *p;
 	int		n;
 
-	needToSchedule = TRUE;
-
         n = inp_ptr - inp_buff;
         for (;;)
         {       // random choice between arrivals
 		if (n > 1)
-			p = inp_buff + (my_rand() % n);
+			p = inp_buff + my_randn(n);
 		else    p = inp_buff;
 
 		if (server)
@@ -84,13 +84,11 @@ int muxBase::act(void)
 rec_typ muxBase::REC( // REC is a macro normally expanding to rec (for debugging)
   data *pd,
   int i) {
+  traincheck(pd);
   inp_ptr->inp = i;
   (inp_ptr++)->pdata = pd;
 
-  if (needToSchedule) {
-    needToSchedule = FALSE;
-    alarml( &evtLate, 0);
-  }
+  wakel( &evtLate);
 
   return ContSend;
 }
@@ -61,11 +61,10 @@ public:
   int ninp;     // # of inputs
   int max_vci;  
   int max_inprio;
-  event evtLate;  // event for the late() method (called if arrival)
+  event evtLate;  // event for the late() method (woken by arrivals, see wakel())
 
   queue q;   // system queue, does *not* include server
 
-  int needToSchedule;  // TRUE: first arrival during this time step: activate late()
   tim_typ serviceTime;  // length of one output time slot (in simulation time steps)
   //tolua_end
   unsigned int *lost;  /* one loss counter per input line */
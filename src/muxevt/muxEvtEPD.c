@@ -127,6 +127,7 @@ rec_typ	muxEvtEPD::REC(	// REC is a macro normally expanding to rec (for debuggi
 	data	*pd,
 	int	iKey)
 {
+	traincheck(pd);
 	if (typequery(pd, AAL5CellType))
 	{	// AAL5 cell
 		inp_ptr->inp = iKey;
@@ -138,10 +139,7 @@ rec_typ	muxEvtEPD::REC(	// REC is a macro normally expanding to rec (for debuggi
 	}
 
 	// wake up late() if necessary
-	if (needToSchedule)
-	{	needToSchedule = FALSE;
-		alarml( &evtLate, 0);
-	}
+	wakel( &evtLate);
 
 	return ContSend;
 }
@@ -155,13 +153,11 @@ void	muxEvtEPD::late(event *)
 	aal5Cell	*pc;
 	inpstruct	*p;
 
-	needToSchedule = TRUE;
-
 	//	process all arrivals in random order, first non-AAL5
 	if ((n = inp_ptr_CBR - inp_buff_CBR) != 0)
 	{	for (;;)
 		{	if (n > 1)
-				p = inp_buff_CBR + (my_rand() % n);
+				p = inp_buff_CBR + my_randn(n);
 			else	p = inp_buff_CBR;
 
 			if ( !processItem(p->pdata, &qCBR))
@@ -177,7 +173,7 @@ void	muxEvtEPD::late(event *)
 	if ((n = inp_ptr - inp_buff) != 0)
 	{	for (;;)
 		{	if (n > 1)
-				p = inp_buff + (my_rand() % n);
+				p = inp_buff + my_randn(n);
 			else	p = inp_buff;
 
 			vc = (pc = (aal5Cell *)p->pdata)->vci;	// data type has been tested in rec()
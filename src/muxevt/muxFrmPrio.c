@@ -62,6 +62,16 @@
 *
 * NOTE: The object performs no classification regarding frame format. It silently assumes
 *       that the frame's vlanPriority field is set.
+*
+* Fluid background load (asynchronous mode only):
+* Fluid sources (fluidsrc) send rate changes (data class fluid) instead of frames. The
+* fluid of each priority is an aggregate rate, its backlog is drained analytically with
+* the service rate, higher priorities first. Frames see the fluid backlog of their own and
+* higher priorities ahead of them and are served with the capacity left over by the fluid:
+* service time = (backlog + frame bits) / (servicerate - fluid rate of priorities >= prio).
+* The service time is fixed when the service starts. If the fluid takes the full capacity,
+* the frame waits in the server until the next rate change. Frames do not slow down the
+* fluid (background much larger than foreground).
 */
 
 #include "muxFrmPrio.h"
@@ -78,6 +88,8 @@ muxFrmPrio::~muxFrmPrio()
   delete[] qByteLens;
   delete[] lostPRIO;
   delete[] inpPrioBuf;
+  delete[] fluidRate;
+  delete[] fluidBack;
 }
 int muxFrmPrio::act(void)
 {
@@ -101,6 +113,12 @@ int muxFrmPrio::act(void)
      lostPRIO[i] = 0;
   CHECK(inpPrioBuf = new inpPrioStruct[ninp]);
   inpPrioPtr = inpPrioBuf;
+  CHECK(fluidRate = new double[nprio]);
+  CHECK(fluidBack = new double[nprio]);
+  for (i = 0; i < nprio; ++i)
+     fluidRate[i] = fluidBack[i] = 0.0;
+  fluidOn = FALSE;
+  fluidTime = SimTime;
   counter = 0;
   return 0;
 }
@@ -113,6 +131,7 @@ inline data *muxFrmPrio::dequeuePrio()
    for (i = nprio - 1; i >= 0; --i)
       if ( !prioQ[i].isEmpty()) {
 	 --qLens[i];
+	 serverPrio = i;
 	 return prioQ[i].dequeue();
       }
    return NULL;
@@ -127,13 +146,11 @@ void muxFrmPrio::late(event *)
    int  n;
    tim_typ tim;
 
-   needToSchedule = TRUE;
-   
    n = inpPrioPtr - inpPrioBuf;
    // random choice between arrivals
    for (;;) {       
       if (n > 1)
-	 p = inpPrioBuf + (my_rand() % n);
+	 p = inpPrioBuf + my_randn(n);
       else
 	 p = inpPrioBuf;
       
@@ -164,11 +181,16 @@ void muxFrmPrio::late(event *)
 	    // In async mode the queues are serviced according to a given bitrate.
 	    // The frame length plays a role.
 	    server = p->pdata;
-	    serverState = serverServing;
-	    tim = (tim_typ) (p->pdata->pdu_len() * 8 / serviceRate + 0.5);
-	    if (tim < 1)
-	       tim = 1;
-	    alarme( &std_evt, tim);
+	    if (fluidOn) {
+	       serverPrio = p->prio;
+	       fluidService();
+	    } else {
+	       serverState = serverServing;
+	       tim = (tim_typ) (p->pdata->pdu_len() * 8 / serviceRate + 0.5);
+	       if (tim < 1)
+		  tim = 1;
+	       alarme( &std_evt, tim);
+	    }
 	 }
       } else {
 	 if (prioQ[p->prio].enqueue(p->pdata)){
@@ -204,7 +226,9 @@ void muxFrmPrio::early(event *) {
       ++counter;
       suc->rec(server, shand);
       server = dequeuePrio();
-      if (server){
+      if (server && fluidOn)
+	 fluidService();
+      else if (server){
 	 if (syncMode){
 	    tim = serviceTime;
 	 } else {
@@ -222,6 +246,62 @@ void muxFrmPrio::early(event *) {
    }
 }
 
+//
+// Drain the fluid backlogs up to now. With absolute priorities, the fluid
+// of the priorities >= p forms a single fluid queue with the sum of their rates
+// as input and the service rate as output.
+//
+void muxFrmPrio::fluidAdvance(void)
+{
+   double lambda, dt;
+   int i;
+   if (SimTime == fluidTime)
+      return;
+   dt = (double) (SimTime - fluidTime);
+   lambda = 0.0;
+   for (i = nprio - 1; i >= 0; --i) {
+      lambda += fluidRate[i];
+      fluidBack[i] += (lambda - serviceRate) * dt;
+      if (fluidBack[i] < 0.0)
+	 fluidBack[i] = 0.0;
+   }
+   fluidTime = SimTime;
+}
+
+//
+// Start serving the item in the server with the capacity left over by the fluid.
+// Blocks the server, if there is none.
+//
+void muxFrmPrio::fluidService(void)
+{
+   double rest;
+   tim_typ tim;
+   int i;
+   fluidAdvance();
+   rest = serviceRate;
+   for (i = nprio - 1; i >= serverPrio; --i)
+      rest -= fluidRate[i];
+   if (rest <= 0.0) {
+      // wait for the next rate change
+      serverState = serverBlocked;
+      return;
+   }
+   tim = (tim_typ) ((fluidBack[serverPrio] + server->pdu_len() * 8) / rest + 0.5);
+   if (tim < 1)
+      tim = 1;
+   serverState = serverServing;
+   alarme( &std_evt, tim);
+}
+
+double muxFrmPrio::getFluidBacklog(int prio)
+{
+   if (fluidOn)
+      fluidAdvance();
+   if (prio == nprio - 1)
+      return fluidBack[prio];
+   return fluidBack[prio] - fluidBack[prio + 1];
+}
+
 int muxFrmPrio::export(exp_typ *msg) 
 {
    return baseclass::export(msg) ||
@@ -233,6 +313,24 @@ int muxFrmPrio::export(exp_typ *msg)
 rec_typ muxFrmPrio::REC(data *pd, int iKey) 
 {
    int inprio, prio;
+   if (pd->type == FluidType) {
+      // rate change of a fluid flow: takes effect immediately
+      if (syncMode)
+	 errm1s("%s: fluid input needs mode \"async\"", name);
+      inprio = ((fluid *) pd)->prioCodePoint;
+      if (inprio < 0 || inprio >= max_inprio)
+	 errm1s2d("%s: illegal INPRIO=%d received on input %d", name, inprio, iKey);
+      if ( !fluidOn) {
+	 fluidOn = TRUE;
+	 fluidTime = SimTime;
+      }
+      fluidAdvance();
+      fluidRate[priorities[inprio]] += ((fluid *) pd)->delta;
+      delete pd;
+      if (serverState == serverBlocked)
+	 fluidService();
+      return ContSend;
+   }
    typecheck_i(pd, FrameType, iKey);
    // The mux takes it's input priority directly from the rame
    inprio = ((frame *) pd)->prioCodePoint;
@@ -247,10 +345,7 @@ rec_typ muxFrmPrio::REC(data *pd, int iKey)
    inpPrioPtr->inp = iKey;
    (inpPrioPtr++)->prio = prio;
    
-   if (needToSchedule) {
-      needToSchedule = FALSE;
-      alarml( &evtLate, 0);
-   }
+   wakel( &evtLate);
    
    return ContSend;
 }
@@ -43,6 +43,8 @@ public:
   void early(event *);
   void late(event *);
   data *dequeuePrio();
+  void fluidAdvance(void);
+  void fluidService(void);
   int export(exp_typ *);
   //tolua_begin
 
@@ -73,6 +75,18 @@ public:
   void setPrio(int inprio, int prio){priorities[inprio] = prio;}
   int getPrio(int inprio){return priorities[inprio];}
   int getLossPRIO(int trc){return this->lostPRIO[trc];}
+
+  /** Get the fluid backlog
+   * @param prio priority 0 to nprio
+   * @return fluid queued with this priority in bits
+   */
+  double getFluidBacklog(int prio);
+
+  /** Get the fluid rate
+   * @param prio priority 0 to nprio
+   * @return sum of fluid input rates of this priority in bits per slot
+   */
+  double getFluidRate(int prio){return fluidRate[prio];}
   int nprio;           // # of queues
   double serviceRate;  // bitrate on output
   int act(void);       // init finalizer
@@ -88,12 +102,19 @@ public:
 
   inpPrioStruct *inpPrioBuf;
   inpPrioStruct *inpPrioPtr;
+  int serverPrio;       // priority of the item in the server
+
+  int fluidOn;          // fluid input seen
+  double *fluidRate;    // fluid input rate per priority (bits per slot)
+  double *fluidBack;    // fluid backlog of the priorities >= p (bits)
+  tim_typ fluidTime;    // fluidBack is valid for this time
 
   //tolua_begin
   typedef enum {
      serverIdling, 
      serverSyncing, 
-     serverServing
+     serverServing,
+     serverBlocked
   } serverState_t;
   serverState_t serverState;
   int maxArrPrio;
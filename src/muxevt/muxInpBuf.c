@@ -218,11 +218,7 @@ rec_typ	muxInpBuf::REC(
 			case serverStopped:
 				// since we can send at earliest next step (1 step service),
 				// we can activate late() already for this slot
-				if (needToSchedule)
-				{	needToSchedule = FALSE;
-					alarml( &std_evt, 0);
-//printf("%s: %d: start was scheduled! \n",name, SimTime);
-				}
+				wakel( &std_evt);
 				// until there we remain in serverStopped and go
 				// then to serving or idling
 				break;
@@ -246,6 +242,8 @@ rec_typ	muxInpBuf::REC(
 		return StopSend;
 	}
 
+	traincheck(pd);
+
 	// try to enqueue arrival
 	int	res;
 	if (byteBuffer)
@@ -287,10 +285,7 @@ rec_typ	muxInpBuf::REC(
 	{	// in case the server is idling, we have to decide
 		// during late() who to serve next (perhaps we get
 		// more arrivals during this time step)
-		if (needToSchedule)
-		{	needToSchedule = FALSE;
-			alarml( &std_evt, 0);
-		}
+		wakel( &std_evt);
 	}
 
 	if (doStartStop && (byteBuffer ? (qLenBytes[iKey] >= pi->bSize) : (pi->q.isFull())))
@@ -318,8 +313,6 @@ void	muxInpBuf::late(
 
 
 //printf("%s: %d: in late arrived \n",name, SimTime);
-	needToSchedule = TRUE;
-
 	// decide on who to serve next (if any),
 	// that's difficult. For a first version, we do it by chance.
 	n = 0;
@@ -335,7 +328,7 @@ void	muxInpBuf::late(
 
 	if (n == 1)
 		i = candidates[0];
-	else	i = candidates[my_rand() % n];
+	else	i = candidates[my_randn(n)];
 
 	server = inpStructs[i].q.dequeue();
 	--qLen[i];
@@ -423,10 +416,7 @@ void	muxInpBuf::early(
 	{	// Relaxation completed, look for next data in late().
 		// We don't look for data here for reasons of fairness- perhaps
 		// there are still data arriving during this step.
-		if (needToSchedule)
-		{	needToSchedule = FALSE;
-			alarml( &std_evt, 0);
-		}
+		wakel( &std_evt);
 	}
 	else	serverState = serverStopped;
 }
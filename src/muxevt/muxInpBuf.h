@@ -39,7 +39,6 @@ public:
 		muxInpBuf():	evtServ(this, keyEvtServ), evtStart(this, keyEvtStart)
 		{	sendingAllowed = ContSend;
 			serverState = serverIdling;
-			needToSchedule = TRUE;
 		}
 	void	init();
 	rec_typ	REC(data *, int);
@@ -65,7 +64,6 @@ public:
 	rec_typ	sendingAllowed;		// are we allowed to send (if we wish so)?
 	int	*candidates;		// inputs which have sth queued (used in late())
 	data	*server;		// holds the data item in service
-	int	needToSchedule;		// TRUE: late() isn't yet scheduled
 	int	doStartStop;		// TRUE: use start-stop protocol on inputs
 	tim_typ	relaxTime;		// time steps to relax between two services
 	tim_typ	serviceTime;		// constant service time. if 0 then use serviceStepsPerByte
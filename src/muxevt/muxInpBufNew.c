@@ -334,7 +334,7 @@ void	muxInpBuf::late(
 
 	if (n == 1)
 		i = candidates[0];
-	else	i = candidates[my_rand() % n];
+	else	i = candidates[my_randn(n)];
 
 	server = inpStructs[i].q.dequeue();
 	--qLen[i];
@@ -114,12 +114,10 @@ void muxPrio::late(event *)
   inpPrioStruct *p;
   int  n;
 
-  needToSchedule = TRUE;
-
   n = inpPrioPtr - inpPrioBuf;
   for (;;) {       // random choice between arrivals
     if (n > 1)
-      p = inpPrioBuf + (my_rand() % n);
+      p = inpPrioBuf + my_randn(n);
     else
       p = inpPrioBuf;
 
@@ -213,10 +211,7 @@ rec_typ muxPrio::REC(data *pd, int iKey)
   inpPrioPtr->inp = iKey;
   (inpPrioPtr++)->prio = prio;
 
-  if (needToSchedule) {
-    needToSchedule = FALSE;
-    alarml( &evtLate, 0);
-  }
+  wakel( &evtLate);
 
   return ContSend;
 }
@@ -116,13 +116,11 @@ void	muxSyncAF::late(
 	int		n;
 	int		dd;
 
-	needToSchedule = TRUE;
-
         n = inp_ptr - inp_buff;
         for (;;)
         {       // random choice between arrivals
 		if (n > 1)
-			p = inp_buff + (my_rand() % n);
+			p = inp_buff + my_randn(n);
 		else    p = inp_buff;
 
 		switch (serverState) {
@@ -162,7 +162,7 @@ rec_typ	lb::REC(	// REC is a macro normally expanding to rec (for debugging)
 	//	test on overflow
 	if (lb_siz + lb_inc > lb_max)
 	{	//	overflow -> discard cell
-		if ( ++counter == 0)
+		if ( CNT_OVERFLOW( ++counter))
 			errm1s("%s: overflow of counter", name);
 		delete pd;
 		return ContSend;
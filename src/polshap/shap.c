@@ -89,7 +89,7 @@ rec_typ	shap::REC(	// REC is a macro normally expanding to rec (for debugging)
 		{	if (q.enqueue(pd))
 				alarme( &std_evt, next_time - SimTime);
 			else	// no buffer space -> "hard" spacing
-			{	if ( ++counter == 0)
+			{	if ( CNT_OVERFLOW( ++counter))
 					errm1s("%s: overflow of counter", name);
 				delete pd;
 			}
@@ -97,7 +97,7 @@ rec_typ	shap::REC(	// REC is a macro normally expanding to rec (for debugging)
 	}
 	else	//	queue has not been empty. queue cell or discard it.
 	{	if ( !q.enqueue(pd))	// buffer full
-		{	if ( ++counter == 0)
+		{	if ( CNT_OVERFLOW( ++counter))
 				errm1s("%s: overflow of counter", name);
 			delete pd;
 		}
@@ -118,7 +118,7 @@ rec_typ	shap2::REC(	// REC is a macro normally expanding to rec (for debugging)
 				alarme( &std_evt, next_time - SimTime);
 			}
 			else	// no buffer space -> "hard" spacing
-			{	if ( ++counter == 0)
+			{	if ( CNT_OVERFLOW( ++counter))
 					errm1s("%s: overflow of counter", name);
 				delete pd;
 			}
@@ -126,7 +126,7 @@ rec_typ	shap2::REC(	// REC is a macro normally expanding to rec (for debugging)
 	}
 	else	//	queue has not been empty. queue cell or discard it.
 	{	if (q_len >= q_max)	// buffer full
-		{	if ( ++counter == 0)
+		{	if ( CNT_OVERFLOW( ++counter))
 				errm1s("%s: overflow of counter", name);
 			delete pd;
 		}
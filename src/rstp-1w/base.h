@@ -177,7 +177,11 @@ typedef enum {
 
 #ifdef __LINUX__
 #ifdef USELUA
+#ifdef PDES
+extern __thread double SimTimeReal; /* thread-local in the kernel, see PDES in defs.h */
+#else
 extern double SimTimeReal;
+#endif
 /* #define stp_trace(F, B...) printf("%f:" F "\n", SimTimeReal, ##B)  */
 #define stp_trace(F, B...)
 #else
@@ -173,12 +173,10 @@ typedef enum {
 
 #ifdef __LINUX__
 #ifdef USELUA
-extern double SimTimeReal;
-typedef unsigned int tim_typ; 
-extern tim_typ SimTime;
-#define stp_trace(F, B...) printf("STP ITRACE %d (%.3f):" F "\n", SimTime, SimTimeReal, ##B) 
-#define stp_warn(F, B...) printf("STP IWARN %d (%.3f):" F "\n", SimTime, SimTimeReal, ##B) 
-#define stp_error(F, B...) printf("STP IERROR %d (%.3f):" F "\n", SimTime, SimTimeReal, ##B) \
+#include "simtime.h"	/* tim_typ, SimTime and SimTimeReal of the kernel */
+#define stp_trace(F, B...) printf("STP ITRACE " TIM_FMT " (%.3f):" F "\n", SimTime, SimTimeReal, ##B) 
+#define stp_warn(F, B...) printf("STP IWARN " TIM_FMT " (%.3f):" F "\n", SimTime, SimTimeReal, ##B) 
+#define stp_error(F, B...) printf("STP IERROR " TIM_FMT " (%.3f):" F "\n", SimTime, SimTimeReal, ##B) \
                            exit(0);
 #else
 extern char* sprint_time_stump (void);
@@ -75,7 +75,7 @@ void	bssrc::early(event *)
 	suc->rec(new cell(vci), shand);
 
 	//	count cells
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( ++counter))
 		errm1s("%s: overflow of departs", name);
 
 	//	when to send next cell?
@@ -113,7 +113,7 @@ int bssrc::act(void)
 
 
 	//	start phase choosen by chance
-	pos = my_rand() % (int) (ex * delta + es);
+	pos = my_randn((int) (ex * delta + es));
 	if (pos < ex * delta)
 	{	//	start with burst
 		state = pos / delta + 1;
@@ -169,7 +169,7 @@ void	bssrc::init(void)
 	dist_silence = get_geo1_handler(es);
 
 	//	start phase choosen by chance
-	pos = my_rand() % (int) (ex * delta + es);
+	pos = my_randn((int) (ex * delta + es));
 	if (pos < ex * delta)
 	{	//	start with burst
 		state = pos / delta + 1;
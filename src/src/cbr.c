@@ -53,7 +53,7 @@ cbrsrc::~cbrsrc()
 
 void	cbrsrc::early(event *)
 {
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( ++counter))
 		errm1s("%s: overflow of departs", name);
 
 	suc->rec(new cell(vci), shand);
@@ -38,7 +38,7 @@ typedef	in1out	baseclass;
 public:
 	cbrsrc();
 	~cbrsrc();
-	int act(void) {alarme(&std_evt, my_rand() % delta);return 0;}
+	int act(void) {alarme(&std_evt, my_randn(delta));return 0;}
 	int	delta;
 //tolua_end
 	
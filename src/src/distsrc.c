@@ -55,16 +55,16 @@ distsrc::~distsrc()
 
 void distsrc::early(event *)
 {
-  if ( ++counter == 0)
+  if ( CNT_OVERFLOW( ++counter))
     errm1s("%s: overflow of counter", name);
   suc->rec(new cell(vci), shand);
   // next registration
-  alarme( &std_evt, table[my_rand() % RAND_MODULO]);
+  alarme( &std_evt, table[my_randn(RAND_MODULO)]);
 }
 
 int distsrc::act(void)
 {
   // first registration
-  alarme( &std_evt, table[my_rand() % RAND_MODULO]);
+  alarme( &std_evt, table[my_randn(RAND_MODULO)]);
   return 0;
 }
@@ -119,7 +119,7 @@ void	filsrc::init(void)
 void	filsrc::early(
 	event	*)
 {
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( ++counter))
 		errm1s("%s: overflow of Count", name);
 
 	suc->rec(new cell(vci), shand);
@@ -150,7 +150,7 @@ void	filsrc::rd_file(void)
 
 	if (fil_pos >= fil_len)
 	{	if ( ++rep_cnt >= rep_max)
-		{	fprintf(stderr, "%s: warning: stopped at SimTime = %d\n",
+		{	fprintf(stderr, "%s: warning: stopped at SimTime = " TIM_FMT "\n",
 					name, SimTime);
 			return;		// do not register again
 		}
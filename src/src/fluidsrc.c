@@ -0,0 +1,97 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+
+/*
+*	Fluid source: aggregate of NSRC on/off sources with exponentially
+*	distributed on and off durations (means EB and ES slots), each with
+*	RATE bits per slot in the on state. No frames are sent, only the
+*	changes of the aggregate rate (data class fluid), whenever a source
+*	switches. With EB = 0, all sources are always on (constant rate).
+*	The successor has to be fluid-aware (muxFrmPrio in async mode).
+*/
+
+#include "fluidsrc.h"
+#include <math.h>
+
+fluidsrc::fluidsrc(void)
+{
+}
+
+fluidsrc::~fluidsrc(void)
+{
+}
+
+int fluidsrc::act(void)
+{
+  int i;
+
+  // start in the stationary state
+  non = 0;
+  for (i = 0; i < nsrc; ++i)
+    if (eb <= 0.0 || uniform() * (eb + es) < eb)
+      ++non;
+  sent = 0.0;
+  running = FALSE;
+  alarme( &std_evt, 1);
+  return 0;
+}
+
+//
+// Early event: a source switches, announce the new rate
+//
+void fluidsrc::early(event *)
+{
+  double off, on, u;
+  tim_typ tim;
+
+  if (running) {
+    // rates of the transitions on -> off and off -> on (per slot)
+    off = non / eb;
+    on = (nsrc - non) / es;
+    if (uniform() * (off + on) < off)
+      --non;
+    else
+      ++non;
+  }
+  running = TRUE;
+
+  suc->rec(new fluid(non * rate - sent, prioCodePoint), shand);
+  sent = non * rate;
+
+  // count rate changes
+  if (CNT_OVERFLOW( ++counter))
+    errm1s("%s: overflow of departs", name);
+
+  // next transition after an exponentially distributed time
+  if (eb <= 0.0)
+    return;
+  off = non / eb;
+  on = (nsrc - non) / es;
+  do
+    u = uniform();
+  while (u <= 0.0);
+  tim = (tim_typ) ceil( -log(u) / (off + on));
+  if (tim < 1)
+    tim = 1;
+  alarme( &std_evt, tim);
+}
@@ -0,0 +1,48 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+#ifndef	_FLUIDSRC_H_
+#define	_FLUIDSRC_H_
+
+#include "in1out.h"
+//tolua_begin
+class	fluidsrc: public	in1out {
+typedef	in1out baseclass;
+
+public:	
+  fluidsrc(void);
+  ~fluidsrc(void);
+  void early(event *);
+  int act(void);
+  int getOn(void) {return non;}
+  double getRate(void) {return non * rate;}
+  int nsrc;	/* number of on/off sources */
+  double rate;	/* rate of a source in the on state (bits per slot) */
+  double eb;	/* mean on duration (slots), 0: always on */
+  double es;	/* mean off duration (slots) */
+  int prioCodePoint;	/* priority of the flow */
+  //tolua_end
+  int non;	/* sources in the on state */
+  double sent;	/* rate announced to the successor */
+  int running;	/* first rate has been sent */
+}; //tolua_export
+#endif	// _FLUIDSRC_H_
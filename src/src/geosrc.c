@@ -60,7 +60,7 @@ geosrc::~geosrc()
 */
 void	geosrc::early(event *)
 {
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( ++counter))
 		errm1s("%s: overflow of departs", name);
 
 	suc->rec(new cell(vci), shand);
@@ -138,17 +138,17 @@ int gmdpsrc::act(void)
   //
   tim = 0;
   for (;;) {
-    state = my_rand() % n_stat;
+    state = my_randn(n_stat);
     if (delta[state] != 0)
       break;
     //tim += geo1_rand(dists[state]);
-    tim += tables[state][my_rand() % RAND_MODULO];
+    tim += tables[state][my_randn(RAND_MODULO)];
   }
 
   // cell_cnt = geo1_rand(dists[state]);
-  cell_cnt = tables[state][my_rand() % RAND_MODULO];
+  cell_cnt = tables[state][my_randn(RAND_MODULO)];
 	
-  alarme( &std_evt, tim + (my_rand() % delta[state]));
+  alarme( &std_evt, tim + my_randn(delta[state]));
   return 0;
 }
 #if 0
@@ -272,17 +272,17 @@ void	gmdp::init(void)
 	*/
 	tim = 0;
 	for (;;)
-	{	state = my_rand() % n_stat;
+	{	state = my_randn(n_stat);
 		if (delta[state] != 0)
 			break;
 		//tim += geo1_rand(dists[state]);
-		tim += tables[state][my_rand() % RAND_MODULO];
+		tim += tables[state][my_randn(RAND_MODULO)];
 	}
 
 	//cell_cnt = geo1_rand(dists[state]);
-	cell_cnt = tables[state][my_rand() % RAND_MODULO];
+	cell_cnt = tables[state][my_randn(RAND_MODULO)];
 	
-	alarme( &std_evt, tim + (my_rand() % delta[state]));
+	alarme( &std_evt, tim + my_randn(delta[state]));
 }
 #endif
 /*
@@ -299,7 +299,7 @@ void gmdpsrc::early(event *)
   suc->rec(new cell(vci), shand);
   
   // count cells
-  if (++counter == 0)
+  if (CNT_OVERFLOW( ++counter))
     errm1s("%s: overflow of departs", name);
   
   //	when to send next cell?
@@ -313,7 +313,7 @@ void gmdpsrc::early(event *)
     st = state;
     for (;;) {
       // get and transform r.n.
-      r = my_rand() % RAND_MODULO;
+      r = my_randn(RAND_MODULO);
       p = trafo[st];
       for (st = 0; st < n_stat; ++st)
 	if (r < p[st])
@@ -327,14 +327,14 @@ void gmdpsrc::early(event *)
       // in case of a state with zero bit rate, look ahead to find 
       // next cell
       // t += geo1_rand(dists[st]);
-      t += tables[st][my_rand() % RAND_MODULO];
+      t += tables[st][my_randn(RAND_MODULO)];
       if ( ++trials >= TRIAL_MAX)
 	errm1s2d("%s: gmdp::early(): could not leave state no. %d "
 		 "after TRIAL_MAX=%d attempts", name, st + 1, TRIAL_MAX);
     }
     // non zero bit rate state reached
     // cell_cnt = geo1_rand(dists[st]);
-    cell_cnt = tables[st][my_rand() % RAND_MODULO];
+    cell_cnt = tables[st][my_randn(RAND_MODULO)];
     state = st;
     tim = t + delta[st];
   }
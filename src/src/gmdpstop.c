@@ -83,7 +83,7 @@ void gmdpstop::early(event *)
   chkStartStop(send_state = suc->rec(new cell(vci), shand));
 
   //  Count cells
-  if (++counter == 0)
+  if (CNT_OVERFLOW( ++counter))
     errm1s("%s: overflow of departs", name);
 
   // When to send next cell?
@@ -97,7 +97,7 @@ void gmdpstop::early(event *)
     st = state;
     for (;;) {
       // Get and transform r.n.
-      r = my_rand() % RAND_MODULO;
+      r = my_randn(RAND_MODULO);
       p = trafo[st];
       for (st = 0; st < n_stat; ++st)
 	if (r < p[st])
@@ -111,14 +111,14 @@ void gmdpstop::early(event *)
       //  In case of a state with zero bit rate, look ahead to find
       //  next cell
       // t += geo1_rand(dists[st]);
-      t += tables[st][my_rand() % RAND_MODULO];
+      t += tables[st][my_randn(RAND_MODULO)];
       if (++trials >= TRIAL_MAX)
 	errm1s2d("%s: gmdp::early(): could not leave state no. %d "
 		 "after TRIAL_MAX=%d attempts", name, st + 1, TRIAL_MAX);
     }
     // Non zero bit rate state reached
     // cell_cnt = geo1_rand(dists[st]);
-    cell_cnt = tables[st][my_rand() % RAND_MODULO];
+    cell_cnt = tables[st][my_randn(RAND_MODULO)];
     state = st;
     tim = t + delta[st];
   }
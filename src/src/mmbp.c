@@ -75,7 +75,7 @@ void mmbpsrc::early(event *)
   suc->rec(new cell(vci), shand);
 
   // count cells
-  if (++counter == 0)
+  if (CNT_OVERFLOW( ++counter))
     errm1s("%s: overflow of departs", name);
 
   // determine spacing to next cell
@@ -207,13 +207,13 @@ void	modBP::init(void)
 	*/
 	tim = 0;
 	for (;;)
-	{	state = my_rand() % n_stat;
+	{	state = my_randn(n_stat);
 		if (edtables[state] != NULL)
 			break;		// we have found a state with non-zero bit rate
-		tim += tables[state][my_rand() % RAND_MODULO];
+		tim += tables[state][my_randn(RAND_MODULO)];
 	}
 
-	time_left = tables[state][my_rand() % RAND_MODULO];
+	time_left = tables[state][my_randn(RAND_MODULO)];
 	// the first cell distance is chosen to ed[state]+1
 	if (time_left > ((int)ed[state]) + 1)
 		time_left -= ((int)ed[state]) + 1;
@@ -237,11 +237,11 @@ void	modBP::early(event *)
 	suc->rec(new cell(vci), shand);
 
 	//	count cells
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( ++counter))
 		errm1s("%s: overflow of departs", name);
 
 	//	when would we like to send next cell ?
-	next_distance = edtables[state][my_rand() % RAND_MODULO];
+	next_distance = edtables[state][my_randn(RAND_MODULO)];
 
 	//	is this instance still inside off the current phase ?
 	if (next_distance <= (tim_typ) time_left)
@@ -256,7 +256,7 @@ void	modBP::early(event *)
 		st = state;
 		for (;;)
 		{	//	get and transform r.n.: transition to next state
-			r = my_rand() % RAND_MODULO;
+			r = my_randn(RAND_MODULO);
 			p = trafo[st];
 			for (st = 0; st < n_stat; ++st)
 				if (r < p[st])
@@ -266,8 +266,8 @@ void	modBP::early(event *)
 
 			if (edtables[st] != NULL)	// a state with non-zero bit rate
 			{	// we have to check whether we really can send a cell
-				time_left = tables[st][my_rand() % RAND_MODULO];
-				next_distance = edtables[st][my_rand() % RAND_MODULO];
+				time_left = tables[st][my_randn(RAND_MODULO)];
+				next_distance = edtables[st][my_randn(RAND_MODULO)];
 				if (next_distance <= (tim_typ) time_left)
 				{	// the state duration is long enough
 					time_left -= next_distance;
@@ -282,7 +282,7 @@ void	modBP::early(event *)
 			}
 
 			else	//	case of a state with zero bit rate
-			{	tim += tables[st][my_rand() % RAND_MODULO];
+			{	tim += tables[st][my_randn(RAND_MODULO)];
 			}
 
 			// avoid endless loops
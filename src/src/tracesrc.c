@@ -0,0 +1,287 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+
+/*
+*	Trace source: replays a recorded trace file, which is mapped into
+*	memory (files larger than the address space of 32 bit systems are not
+*	supported).
+*
+*	Formats:
+*	TRACE_IAT32	32 bit IATs as written by the old filsrc, sends cells
+*	TRACE_IAT64	64 bit IATs, sends cells
+*	TRACE_FRAME	records struct trace_rec (IAT, length, VLAN ID, priority,
+*			drop precedence), sends frames
+*	All values in host byte order. An IAT is the distance to the previous
+*	record in slots; records with IAT 0 are sent in the same slot. The
+*	first record is sent wait + IAT slots (at least one) after the start.
+*
+*	The kernel reads ahead of the current record: the next 'ahead' bytes
+*	are advised to the kernel (MADV_WILLNEED), the pages already replayed
+*	are dropped from the mapping. With 'prefetch', a thread additionally
+*	touches the pages ahead, so that page faults are served by the thread
+*	rather than by the simulation.
+*/
+
+#include "tracesrc.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+
+#define	TRACE_CHUNK	(1 << 20)	// granularity of advising, bytes
+
+tracesrc::tracesrc()
+{
+	fil_name = NULL;
+	fd = -1;
+	base = NULL;
+	len = 0;
+	nrec = 0;
+	pos = 0;
+	pf_running = FALSE;
+	pf_stop = FALSE;
+}
+
+tracesrc::~tracesrc()
+{
+	// no thread in a child process of sim:snapshot()
+	if (pf_running && pf_pid == getpid())
+	{	pf_stop = TRUE;
+		pthread_join(pf_tid, NULL);
+	}
+	if (base != NULL)
+		munmap((void *) base, len);
+	if (fd >= 0)
+		close(fd);
+	delete[] fil_name;
+}
+
+/*
+*	Map the trace file
+*/
+void	tracesrc::openTrace(
+	const char *fname,
+	int	fmt)
+{
+	struct	stat st;
+	void	*p;
+
+	if (base != NULL)
+		errm1s("%s: trace file already opened", name);
+	switch (fmt) {
+	case TRACE_IAT32:	recsiz = 4; break;
+	case TRACE_IAT64:	recsiz = 8; break;
+	case TRACE_FRAME:	recsiz = sizeof(trace_rec); break;
+	default:		errm1s("%s: unknown trace format", name);
+	}
+	format = fmt;
+	CHECK(fil_name = new char[strlen(fname) + 1]);
+	strcpy(fil_name, fname);
+
+	if ((fd = ::open(fil_name, O_RDONLY)) < 0)
+		errm2s("%s: could not open file \"%s\"", name, fil_name);
+	if (fstat(fd, &st) != 0)
+		errm2s("%s: could not get the size of file \"%s\"", name, fil_name);
+	if (st.st_size < (off_t) recsiz || st.st_size % recsiz != 0)
+		errm2s("%s: \"%s\": bad file format", name, fil_name);
+	if ((unsigned long long) st.st_size > (size_t) -1)
+		errm2s("%s: \"%s\": file too large for this system", name, fil_name);
+	len = (size_t) st.st_size;
+	nrec = len / recsiz;
+	if ((p = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+		errm2s("%s: could not map file \"%s\"", name, fil_name);
+	base = (const unsigned char *) p;
+	madvise(p, len, MADV_SEQUENTIAL);
+}
+
+int	tracesrc::act(void)
+{
+	if (base == NULL)
+		errm1s("%s: no trace file", name);
+	if (start < 0 || start >= (double) nrec)
+		errm1s("%s: start has to be smaller than the number of records", name);
+	pos = (unsigned long long) start;
+	rep_cnt = 0;
+	cursor = pos * recsiz;
+	adv_pos = drop_pos = 0;
+	advise();
+
+	if (prefetch && !pf_running)
+	{	pf_stop = FALSE;
+		if (pthread_create(&pf_tid, NULL, prefetcher, this) != 0)
+			errm1s("%s: can't create the prefetch thread", name);
+		pf_running = TRUE;
+		pf_pid = getpid();
+	}
+
+	if (wait == 0)
+		late(NULL);	// late() comprises the first alarme()
+	else	alarml( &std_evt, wait);
+	return 0;
+}
+
+/*
+*	Waiting time expired: register for the first record
+*/
+void	tracesrc::late(
+	event	*)
+{
+	tim_typ	iat;
+
+	if (fetch( &iat))
+		alarme( &std_evt, iat > 0 ? iat : 1);
+}
+
+/*
+*	Send the records of this slot, register for the next one
+*/
+void	tracesrc::early(
+	event	*)
+{
+	tim_typ	iat;
+
+	do {
+		emit();
+		if ( !fetch( &iat))
+			return;		// do not register again
+	} while (iat == 0);
+	alarme( &std_evt, iat);
+}
+
+/*
+*	IAT of the current record, FALSE: end of the trace
+*/
+int	tracesrc::fetch(
+	tim_typ	*iat)
+{
+	const unsigned char *p;
+	unsigned long long v;
+
+	if (pos >= nrec)
+	{	if (rep_max != 0 && ++rep_cnt >= rep_max)
+		{	fprintf(stderr, "%s: warning: stopped at SimTime = " TIM_FMT "\n",
+					name, SimTime);
+			return FALSE;
+		}
+		pos = 0;
+		cursor = 0;
+		adv_pos = drop_pos = 0;
+		advise();
+	}
+	p = base + pos * recsiz;
+	switch (format) {
+	case TRACE_IAT32:	v = *(const unsigned int *) p; break;
+	case TRACE_IAT64:	v = *(const unsigned long long *) p; break;
+	default:		v = ((const trace_rec *) p)->iat; break;
+	}
+	if (v != (tim_typ) v)
+		errm1s("%s: IAT too large for the simulation clock (see TIME64)", name);
+	*iat = (tim_typ) v;
+	return TRUE;
+}
+
+/*
+*	Send the current record
+*/
+void	tracesrc::emit(void)
+{
+	const trace_rec *r;
+	frame	*pf;
+
+	if ( CNT_OVERFLOW( ++counter))
+		errm1s("%s: overflow of departs", name);
+
+	if (format == TRACE_FRAME)
+	{	r = (const trace_rec *) (base + pos * recsiz);
+		pf = new frame(r->len, connID);
+		if (r->vlan != 0)
+		{	pf->tpid = 0x8100;
+			pf->vlanId = r->vlan;
+			pf->vlanPriority = r->prio;
+		}
+		pf->dropPrecedence = r->dp;
+		suc->rec(pf, shand);
+	}
+	else	suc->rec(new cell(vci), shand);
+
+	++pos;
+	if ((cursor += recsiz) >= adv_next)
+		advise();
+}
+
+/*
+*	Read ahead of the cursor, drop the pages behind it
+*/
+void	tracesrc::advise(void)
+{
+	size_t	lim, beg, done;
+	size_t	pg = (size_t) sysconf(_SC_PAGESIZE);
+
+	lim = cursor + (ahead > 0 ? (size_t) ahead : TRACE_CHUNK);
+	if (lim > len)
+		lim = len;
+	if (adv_pos < cursor)
+		adv_pos = cursor;
+	if (adv_pos < lim)
+	{	beg = adv_pos & ~(pg - 1);
+		madvise((void *) (base + beg), lim - beg, MADV_WILLNEED);
+		adv_pos = lim;
+	}
+	done = cursor & ~(pg - 1);
+	if (done > drop_pos)
+	{	madvise((void *) (base + drop_pos), done - drop_pos, MADV_DONTNEED);
+		drop_pos = done;
+	}
+	adv_next = cursor + TRACE_CHUNK;
+}
+
+/*
+*	Prefetch thread: touch the pages up to 'ahead' bytes beyond the cursor
+*/
+void	*tracesrc::prefetcher(
+	void	*arg)
+{
+	tracesrc *ts = (tracesrc *) arg;
+	struct	timespec pause = {0, 1000000};	// 1 ms
+	size_t	pf_pos = 0, cur, lim, win;
+	size_t	pg = (size_t) sysconf(_SC_PAGESIZE);
+	unsigned char sum = 0;
+
+	win = ts->ahead > 0 ? (size_t) ts->ahead : TRACE_CHUNK;
+	while ( !ts->pf_stop)
+	{	cur = ts->cursor;
+		// started behind, or the cursor went back (next repetition)
+		if (pf_pos < cur || pf_pos > cur + win + pg)
+			pf_pos = cur & ~(pg - 1);
+		lim = cur + win < ts->len ? cur + win : ts->len;
+		if (pf_pos >= lim)
+		{	nanosleep( &pause, NULL);
+			continue;
+		}
+		for ( ; pf_pos < lim && !ts->pf_stop; pf_pos += pg)
+			sum += ts->base[pf_pos];
+	}
+	ts->pf_sum = sum;	// keep the reads
+	return NULL;
+}
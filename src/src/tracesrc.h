@@ -0,0 +1,98 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+
+#ifndef	_TRACESRC_H_
+#define	_TRACESRC_H_
+
+#include "in1out.h"
+#include <pthread.h>
+#include <sys/types.h>
+
+/*
+*	Record of a frame trace (format TRACE_FRAME), 16 bytes, host byte order
+*/
+struct	trace_rec {
+	unsigned long long iat;	// slots since the previous record
+	unsigned int	len;	// frame length (bytes)
+	unsigned short	vlan;	// VLAN ID, 0: untagged
+	unsigned char	prio;	// VLAN priority
+	unsigned char	dp;	// drop precedence
+};
+
+//tolua_begin
+enum {
+	TRACE_IAT32 = 0,	// 32 bit IATs (the files of filsrc), sends cells
+	TRACE_IAT64 = 1,	// 64 bit IATs, sends cells
+	TRACE_FRAME = 2		// struct trace_rec, sends frames
+};
+
+class	tracesrc:	public	in1out {
+typedef	in1out	baseclass;
+
+public:	
+	tracesrc();
+	~tracesrc();
+	
+	int act(void);
+	void openTrace(const char *fname, int fmt);
+	double getRecords(void) {return (double) nrec;}
+	double getPosition(void) {return (double) pos;}
+
+	int	format;		// TRACE_IAT32, TRACE_IAT64 or TRACE_FRAME
+	int	connID;		// connection ID of the frames
+	int	rep_max;	// # of passes through the file, 0: endless
+	double	start;		// first record
+	tim_typ	wait;		// delay of the first record
+	int	prefetch;	// TRUE: prefetch thread
+	double	ahead;		// bytes read ahead of the current record
+//tolua_end
+
+	void	early(event *);
+	void	late(event *);
+
+private:
+	int	fetch(tim_typ *);
+	void	emit(void);
+	void	advise(void);
+	static	void	*prefetcher(void *);
+
+	char	*fil_name;
+	int	fd;
+	const unsigned char *base;	// the mapped file
+	size_t	len;			// its length
+	size_t	recsiz;			// length of a record
+	unsigned long long nrec;	// # of records
+	unsigned long long pos;		// current record
+	int	rep_cnt;
+	size_t	adv_pos;		// end of the range advised so far
+	size_t	adv_next;		// advise again at this offset
+	size_t	drop_pos;		// pages below are dropped
+	volatile size_t cursor;		// current offset, for the prefetcher
+	volatile int	pf_stop;
+	int	pf_running;
+	pthread_t pf_tid;
+	pid_t	pf_pid;			// process which started the thread
+	unsigned char pf_sum;
+};  //tolua_export
+
+#endif	// _TRACESRC_H_
@@ -81,7 +81,7 @@ void	xx2::early(event *)
 	suc->rec(new cellSeq(vci, burst_number, burst_len, sequence_number), shand);
 
 	//	count cells
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( ++counter))
 		errm1s("%s: overflow of departs", name);
 
 	//	when to send next cell?
@@ -93,7 +93,7 @@ void	xx2::early(event *)
 		{	//	synchronize to the beginning of the last window
 			tim -= tim % delta;
 			//	chose a random phase
-			tim += my_rand() % delta;
+			tim += my_randn(delta);
 		}
 
 		++sequence_number;
@@ -109,7 +109,7 @@ void	xx2::early(event *)
 		{	//	synchronize to the beginning of the last window
 			tim -= tim % delta;
 			//	random phase
-			tim += my_rand() % delta;
+			tim += my_randn(delta);
 		}
 
 		sequence_number = 0;
@@ -68,19 +68,65 @@ confidObj::confidObj()
   vectLen = vectGran;
   CHECK(values = new double [vectLen]);
   nVals = 0;
+  stream = FALSE;
+  nBatch = 32;
+  maxLag = 10;
+  bMeans = lagFirst = lagLast = lagSum = NULL;
+  nb = 0;
+  bSize = 1;
 }
 
 confidObj::~confidObj()
 {
   delete[] values;
+  delete[] bMeans;
+  delete[] lagFirst;
+  delete[] lagLast;
+  delete[] lagSum;
+}
+
+int confidObj::act(void)
+{
+  if (stream){
+    if (nBatch < 2)
+      errm1s("%s: at least 2 batches required", name);
+    if (maxLag < 1)
+      errm1s("%s: maxLag must be >= 1", name);
+    CHECK(bMeans = new double [2 * nBatch]);
+    CHECK(lagFirst = new double [maxLag]);
+    CHECK(lagLast = new double [maxLag]);
+    CHECK(lagSum = new double [maxLag]);
+  }
+  flush();
+  return 0;
+}
+
+void confidObj::flush(void)
+{
+  int k;
+
+  nVals = 0;
+  if (stream){
+    wMean = wM2 = wMin = wMax = wSum = wSumQ = 0.0;
+    nb = 0;
+    bSize = 1;
+    bAcc = 0.0;
+    bCnt = 0;
+    for (k = 0; k < maxLag; ++k)
+      lagSum[k] = 0.0;
+  }
 }
 
 void confidObj::add(double v)
 {
+  if (stream){
+    addStream(v);
+    return;
+  }
   values[nVals++] = v;
   if (nVals >= vectLen){
     double *tmp;
-    vectLen += vectGran;
+    vectLen *= 2;	// geometric growth: constant copying costs per value
     CHECK(tmp = new double [vectLen]);
     for (int i = 0; i < nVals; ++i)
       tmp[i] = values[i];
@@ -89,6 +135,57 @@ void confidObj::add(double v)
   }
 }
 
+//
+// Streaming mode: update all statistics with v in constant time
+//
+void confidObj::addStream(double v)
+{
+  double d;
+  int k, m;
+
+  // products with the previous values
+  m = nVals < maxLag ? nVals : maxLag;
+  for (k = 1; k <= m; ++k)
+    lagSum[k - 1] += lagLast[(nVals - k) % maxLag] * v;
+  if (nVals < maxLag)
+    lagFirst[nVals] = v;
+  lagLast[nVals % maxLag] = v;
+
+  // Welford
+  ++nVals;
+  d = v - wMean;
+  wMean += d / nVals;
+  wM2 += d * (v - wMean);
+  if (nVals == 1 || v < wMin)
+    wMin = v;
+  if (nVals == 1 || v > wMax)
+    wMax = v;
+  wSum += v;
+  wSumQ += v * v;
+
+  // batch means
+  bAcc += v;
+  if (++bCnt == bSize){
+    bMeans[nb++] = bAcc / bSize;
+    bAcc = 0.0;
+    bCnt = 0;
+    if (nb == 2 * nBatch){
+      // merge neighbours: the batch size doubles
+      for (k = 0; k < nBatch; ++k)
+	bMeans[k] = 0.5 * (bMeans[2 * k] + bMeans[2 * k + 1]);
+      nb = nBatch;
+      bSize *= 2;
+    }
+  }
+}
+
+double confidObj::getVal(int i)
+{
+  if (stream)
+    errm1s("%s: no values stored in streaming mode", name);
+  return values[i];
+}
+
 double confidObj::getMean(double *pv)
 {
   double pm;
@@ -131,6 +228,8 @@ double confidObj::getMin(void)
 		
   if(nVals <= 0)
     min = 0;
+  else if (stream)
+    min = wMin;
   else if(nVals == 1)
     min = values[0];
   else {
@@ -150,6 +249,8 @@ double confidObj::getMax(void)
 		
   if(nVals <= 0)
     max = 0;
+  else if (stream)
+    max = wMax;
   else {
     max = values[0];
     for(i=1; i < nVals; i++)
@@ -168,10 +269,14 @@ double confidObj::getFairInd(void)
   
   sum = sum_q = 0.0;
   
-  for(i=0; i< nVals; i++){
-    sum += values[i];
-    sum_q += values[i]*values[i];
-  }
+  if (stream){
+    sum = wSum;
+    sum_q = wSumQ;
+  } else
+    for(i=0; i< nVals; i++){
+      sum += values[i];
+      sum_q += values[i]*values[i];
+    }
   
   if(nVals > 0)
     fairind = sum / (nVals*sum_q) *sum;
@@ -188,9 +293,14 @@ double confidObj::getCorr(int lag, int batchsize)
 {
   int i,k;
   int Nb;
-  double n,nq, covariance, variance, variance_x, variance_y;
-  double sum_x, sum_xq, sum_y, sum_yq, sum_xy;
   double *vals;
+  double c;
+
+  if (stream){
+    if (batchsize <= 1)
+      return corrStream(lag);
+    return corr(bMeans, nb, lag);
+  }
 
   // number of batches
   Nb = (int) nVals/batchsize;
@@ -207,9 +317,19 @@ double confidObj::getCorr(int lag, int batchsize)
       vals[i] /= batchsize;
     }		
   
-  n = Nb - lag;
-  nq = n*n;
-  
+  c = corr(vals, Nb, lag);
+  delete[] vals;
+  return c;
+}
+
+//
+// Autocorrelation of vals[0 ... Nb-1] at lag
+//
+double confidObj::corr(double *vals, int Nb, int lag)
+{
+  int i;
+  double sum_x, sum_xq, sum_y, sum_yq, sum_xy;
+
   sum_x = sum_xq = 0.0;
   sum_y = sum_yq = 0.0;
   sum_xy = 0.0;
@@ -219,10 +339,46 @@ double confidObj::getCorr(int lag, int batchsize)
   for(i=0; i< Nb-lag; i++){
     sum_x += vals[i];
     sum_xq += vals[i]*vals[i];
-    sum_y += vals[i+1];
-    sum_yq += vals[i+1]*vals[i+1];
-    sum_xy += vals[i]*vals[i+1];
+    sum_y += vals[i+lag];
+    sum_yq += vals[i+lag]*vals[i+lag];
+    sum_xy += vals[i]*vals[i+lag];
+  }
+
+  return corrSums(Nb - lag, sum_x, sum_xq, sum_y, sum_yq, sum_xy);
+}
+
+//
+// Streaming mode: autocorrelation of the values at lag, from the running
+// sums minus the first and last lag values
+//
+double confidObj::corrStream(int lag)
+{
+  double sum_x, sum_xq, sum_y, sum_yq, v;
+  int j;
+
+  if (lag < 1 || lag > maxLag || lag >= nVals)
+    errm1s2d("%s: lag %d not available (maxLag=%d)", name, lag, maxLag);
+
+  // x: all values but the last lag ones, y: all but the first lag ones
+  sum_x = sum_y = wSum;
+  sum_xq = sum_yq = wSumQ;
+  for (j = 1; j <= lag; ++j){
+    v = lagLast[(nVals - j) % maxLag];
+    sum_x -= v;
+    sum_xq -= v * v;
+    v = lagFirst[j - 1];
+    sum_y -= v;
+    sum_yq -= v * v;
   }
+  return corrSums(nVals - lag, sum_x, sum_xq, sum_y, sum_yq, lagSum[lag - 1]);
+}
+
+double confidObj::corrSums(double n, double sum_x, double sum_xq,
+			   double sum_y, double sum_yq, double sum_xy)
+{
+  double nq, covariance, variance, variance_x, variance_y;
+
+  nq = n*n;
   
   // calculate the covariance;
   covariance = (sum_xy / n) / sum_y - sum_x / nq;
@@ -246,19 +402,6 @@ double confidObj::getCorr(int lag, int batchsize)
   
   if(variance < 0)
     errm1s("%s: internal error: variance of counting process < 0", name);
-  /*
-    fprintf(stderr,"sum_x: %g\n",sum_x);
-    fprintf(stderr,"sum_y: %g\n",sum_y);      
-    fprintf(stderr,"sum_xq: %g\n",sum_xq);
-    fprintf(stderr,"sum_yq: %g\n",sum_yq);
-    fprintf(stderr,"sum_xy: %g\n",sum_xy);      
-    fprintf(stderr,"n: %g\n",n);
-    fprintf(stderr,"nq: %g\n",nq);      
-    fprintf(stderr,"variance_x: %g\n",variance_x);
-    fprintf(stderr,"variance_y: %g\n",variance_y);
-    fprintf(stderr,"variance: %g\n",variance); 
-    fprintf(stderr,"covariance: %g\n",covariance);   
-  */
 
   if(variance == 0)
     return 1.0;
@@ -271,6 +414,11 @@ void confidObj::meanVar(double *pm, double *pv)
   double mean, s2;
   int i;
   
+  if (stream){
+    *pm = wMean;
+    *pv = nVals > 1 ? wM2 / (nVals - 1) : 0.0;
+    return;
+  }
   mean = 0.0;
   for (i = 0; i < nVals; ++i)
     mean += values[i];
@@ -293,8 +441,22 @@ void confidObj::calcConf(double lev, double *pm, double *pw)
     *pm = *pw = 0.0;
   }
   else if (nVals == 1){
-    *pm = values[0];
+    *pm = stream ? wMean : values[0];
     *pw = 0.0;
+  } else if (stream && bSize > 1){
+    // batch means, mean of all values (includes the incomplete batch)
+    double bm;
+    int i;
+    bm = 0.0;
+    for (i = 0; i < nb; ++i)
+      bm += bMeans[i];
+    bm /= nb;
+    s2 = 0.0;
+    for (i = 0; i < nb; ++i)
+      s2 += (bMeans[i] - bm) * (bMeans[i] - bm);
+    s2 /= nb - 1;
+    *pm = wMean;
+    *pw = studentDist(lev, nb - 1) * sqrt(s2) / sqrt(nb);
   } else {
     meanVar(pm, &s2);
     *pw = studentDist(lev, nVals - 1) * sqrt(s2) / sqrt(nVals);
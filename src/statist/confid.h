@@ -58,6 +58,16 @@
 *	double	x->Up(double)		// level given, may differ from LEVEL
 *	double	x->Width(double)	// level given, may differ from LEVEL
 *       double x->FairInd     	        // Fairnessindex (Jain)
+*
+*	Streaming mode (stream = 1, set before the first value):
+*	No values are stored, memory is constant. Mean and variance are
+*	updated with Welford's method, the values go into batch means whose
+*	batch size doubles whenever 2 * nBatch batches are complete. The
+*	confidence interval is calculated from the batch means (from the
+*	values as long as the batch size is 1). getCorr(lag, 1) gives the
+*	autocorrelation of the values (lag <= maxLag), getCorr(lag, b) for
+*	b > 1 the one of the batch means, b is ignored. getVal() is not
+*	available.
 */
 
 #include "defs.h"
@@ -68,10 +78,13 @@ class	confidObj: public root {
 public:
   confidObj();
   ~confidObj();
+  int act(void);
   void add(double v);
-  void flush(void) {nVals = 0;}
+  void flush(void);
   int getLen(void) {return nVals;}
-  double getVal(int i){return values[i];}
+  double getVal(int i);
+  int getBatchSize(void) {return bSize;}
+  int getBatches(void) {return nb;}
   double getMean(double *pv=0);
   double getVar(double *pm=0);
   double getLo(double);
@@ -85,12 +98,31 @@ public:
   void	calcConf(double, double *, double *);
   double studentDist(double, int);
   void meanVar(double *, double *);
+  void addStream(double v);
+  double corr(double *, int, int);
+  double corrStream(int);
+  double corrSums(double, double, double, double, double, double);
 
   double *values;
+  // streaming mode
+  double wMean, wM2;		// Welford: mean, sum of squared deviations
+  double wMin, wMax;
+  double wSum, wSumQ;		// for FairInd and the autocorrelation
+  double *bMeans;		// batch means, nb <= 2 * nBatch
+  double bAcc;			// sum of the current batch
+  int bCnt;			// values in the current batch
+  double *lagFirst;		// the first maxLag values
+  double *lagLast;		// the last maxLag values (ring buffer)
+  double *lagSum;		// sums of x[i] * x[i + k], k = 1 ... maxLag
   //tolua_begin
   double level;
   int nVals;
   int vectLen;
   enum	{vectGran = 10};
+  int stream;		// TRUE: streaming mode
+  int nBatch;		// streaming: batches kept, nBatch ... 2 * nBatch
+  int maxLag;		// streaming: largest lag of getCorr(lag, 1)
+  int nb;		// streaming: complete batches
+  int bSize;		// streaming: current batch size
 };
 //tolua_end
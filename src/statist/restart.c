@@ -0,0 +1,146 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*     Copyright (C) 1995-1997	Chair for Telecommunications
+*				Dresden University of Technology
+*				D-01062 Dresden
+*				Germany
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+/*
+*	Importance watcher for RESTART, see restart.h
+*/
+
+#include "restart.h"
+#include "sim.h"
+
+restartObj::restartObj(): evt(this, 0)
+{
+  queues = NULL;
+  nqueues = 0;
+  thresh = NULL;
+  nthresh = 0;
+  depth = base = 0;
+  action = None;
+  active = FALSE;
+  evt.stat = 12345678;	// static event, see flushevents()
+}
+
+restartObj::~restartObj()
+{
+  stop();
+  delete[] queues;
+  delete[] thresh;
+}
+
+void restartObj::addQueue(queue *q)
+{
+  queue **p;
+  int i;
+
+  if (q == NULL)
+    errm1s("%s: no queue given", name);
+  CHECK(p = new queue *[nqueues + 1]);
+  for (i = 0; i < nqueues; ++i)
+    p[i] = queues[i];
+  p[nqueues++] = q;
+  delete[] queues;
+  queues = p;
+}
+
+void restartObj::addThreshold(int t)
+{
+  int *p;
+  int i;
+
+  if (nthresh > 0 && t <= thresh[nthresh - 1])
+    errm1s("%s: thresholds have to be increasing", name);
+  if (t < 1)
+    errm1s("%s: thresholds have to be >= 1", name);
+  CHECK(p = new int [nthresh + 1]);
+  for (i = 0; i < nthresh; ++i)
+    p[i] = thresh[i];
+  p[nthresh++] = t;
+  delete[] thresh;
+  thresh = p;
+}
+
+// threshold T[i], i = 1 ... nthresh
+int restartObj::getThreshold(int i)
+{
+  if (i < 1 || i > nthresh)
+    errm1s2d("%s: threshold %d does not exist (1 ... %d)", name, i, nthresh);
+  return thresh[i - 1];
+}
+
+int restartObj::getImportance(void)
+{
+  int i, imp = 0;
+
+  for (i = 0; i < nqueues; ++i)
+    imp += queues[i]->getlen();
+  return imp;
+}
+
+// What has to be done in the current state?
+int restartObj::check(void)
+{
+  int imp = getImportance();
+
+  if (base > 0 && imp < thresh[base - 1])
+    return Kill;
+  if (depth < nthresh && imp >= thresh[depth])
+    return Split;
+  if (depth > base && imp < thresh[depth - 1])
+    return Down;
+  return None;
+}
+
+void restartObj::start(void)
+{
+  if (nqueues == 0 || nthresh == 0)
+    errm1s("%s: queues and thresholds required", name);
+  if (!active) {
+    active = TRUE;
+    action = None;
+    slotend( &evt);
+  }
+}
+
+void restartObj::stop(void)
+{
+  if (active) {
+    active = FALSE;
+    unslotend( &evt);
+  }
+}
+
+//
+// End of each slot, after all late activations (see slotend()): stop the
+// simulation, if the trajectory has to split, end or change its weight
+//
+void restartObj::late(event *)
+{
+  if ((action = check()) != None)
+    _sim.stop();
+}
@@ -0,0 +1,84 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*     Copyright (C) 1995-1997	Chair for Telecommunications
+*				Dresden University of Technology
+*				D-01062 Dresden
+*				Germany
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+#ifndef	_RESTART_H_
+#define	_RESTART_H_
+
+/*
+*	Importance watcher for RESTART (importance splitting), see
+*	yats/restart.lua.
+*
+*	The importance is the sum of the lengths of the watched queues. It is
+*	compared with the thresholds T[1] < ... < T[n] at the end of each slot,
+*	after all late activations (see slotend()).
+*	The trajectory simulated by this process has the split depth 'depth'
+*	(the thresholds T[1] ... T[depth] have been crossed upwards, each
+*	crossing has split the trajectory), and was born at level 'base'
+*	(0: main trial, k: retrial of the split at T[k]). The simulation is
+*	stopped at the end of a slot with
+*		Kill:	importance < T[base], the retrial ends,
+*		Split:	importance >= T[depth + 1],
+*		Down:	importance < T[depth], depth > base.
+*	The reaction (fork, weights) is up to the Lua driver.
+*/
+
+#include "defs.h"
+#include "queue.h"
+
+//tolua_begin
+class	restartObj: public root {
+  typedef	root	baseclass;
+public:
+  restartObj();
+  ~restartObj();
+  void addQueue(queue *q);
+  void addThreshold(int t);
+  int getThreshold(int i);
+  int getImportance(void);
+  int check(void);
+  void start(void);
+  void stop(void);
+  //tolua_end
+  void late(event *);
+
+  queue **queues;
+  int nqueues;
+  int *thresh;
+  event evt;
+  //tolua_begin
+  enum {None = 0, Split, Kill, Down};
+  int nthresh;		// number of thresholds
+  int depth;		// split depth of this trajectory
+  int base;		// level of birth, 0: main trial
+  int action;		// reason of the last stop
+  int active;		// TRUE: watching
+};
+//tolua_end
+
+#endif	// _RESTART_H_
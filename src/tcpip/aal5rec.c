@@ -47,6 +47,7 @@
 *	AAL 5 receiver module.
 *
 *	AAL5Rec aal: OUT=tcp;
+*	Lua: yats.aal5rec{"aal", out = {"tcp", "in"}}, see yats/tcpip.lua.
 *
 *	Command:
 *		aal->ResetStat	// reset all statistics variables
@@ -61,7 +62,7 @@
 *
 *	Mechanism to detect cell and frame losses
 *	=========================================
-*	See AAL5Send in aal5send.c.
+*	See AAL5Send in aal5send.c. Cell trains (aal5Train) are taken as a whole.
 */
 
 
@@ -69,6 +70,30 @@
 
 CONSTRUCTOR(Aal5rec, aal5rec)
 
+aal5rec::aal5rec()
+{
+}
+
+aal5rec::~aal5rec()
+{
+	data	*pd;
+
+	while ((pd = q.dequeue()) != NULL)
+		delete pd;
+}
+
+int	aal5rec::act(void)
+{
+	last_cell = 0;
+	last_sdu = 0;	// remember last valid sdu sequence number
+	sdu_loss = 0;	// sdu loss
+	cell_loss = 0;	// cell loss
+	sdu_cnt = 0;	
+
+	delay_mean = 0.0;
+	return 0;
+}
+
 /********************************************************************/
 /*
 *	read definition statement
@@ -82,13 +107,7 @@ void	aal5rec::init(void)
 	output("OUT");
 	stdinp();
 
-	last_cell = 0;
-	last_sdu = 0;	// remember last valid sdu sequence number
-	sdu_loss = 0;	// sdu loss
-	cell_loss = 0;	// cell loss
-	sdu_cnt = 0;	
-
-	delay_mean = 0.0;
+	act();
 }
 
 /********************************************************************/
@@ -99,10 +118,13 @@ void	aal5rec::init(void)
 rec_typ	aal5rec::REC(data *pd, int)	// REC is a macro normally expanding to rec (for debugging)
 {
 	aal5Cell	*pc = (aal5Cell *) pd;
+	int		ncells = 1;
 
-	typecheck(pc, AAL5CellType);
+	if (pd->type == AAL5TrainType)	// a train is taken as a whole
+		ncells = ((aal5Train *) pd)->ncells;
+	else	typecheck(pc, AAL5CellType);
 
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( counter += ncells))
 		errm1s("%s: overflow of cell counter", name);
 
 	if( ++last_cell != pc->cell_seq)	// wrong cell (cell loss) -> empty queue
@@ -113,6 +135,7 @@ rec_typ	aal5rec::REC(data *pd, int)	// REC is a macro normally expanding to rec
 		while ((pd = q.dequeue()) != NULL)
 			delete pd;
 	}
+	last_cell += ncells - 1;	// the other cells of a train
 
 	//queue the cell
 	q.enqueue(pc);
@@ -123,11 +146,10 @@ rec_typ	aal5rec::REC(data *pd, int)	// REC is a macro normally expanding to rec
 		if(pc->first_cell == phead->cell_seq)	// SDU is valid, no pt=1 cell was lost
 		{	// forward data item embedded in last cell
 			if (pc->embedded)
-			{	suc->rec(pc->embedded, shand);
-				pc->embedded = NULL;	// this is important, otherwise pc->embedded
-							// is deleted by its receiver *and*
-							// when deleting pc !!
-			}
+				// take it out of pc, otherwise pc->embedded would be
+				// deleted by its receiver *and* when deleting pc !!
+				// (a copy if shared with a clone of pc)
+				suc->rec(pc->takeEmbedded(), shand);
 			else	errm1s("%s: no data item embedded in last cell of frame", name);
 			
 			// log the loss of AAL SDUs if any
@@ -136,9 +158,12 @@ rec_typ	aal5rec::REC(data *pd, int)	// REC is a macro normally expanding to rec
 
 			// log the delay of AAL SDU
 			++sdu_cnt;
-			delay = SimTime - phead->time;	// the delay spans from generating
+			delay = SimTime + ncells - 1 - phead->time;
+							// the delay spans from generating
 							// the first cell by the sender
 							// until delivering the frame to user
+							// (the last cell of a train comes
+							// ncells - 1 slots after its first)
 			delay_mean = (delay_mean * (sdu_cnt - 1) + delay) / sdu_cnt;
 		}
 
@@ -160,17 +185,21 @@ int	aal5rec::command(char *s, tok_typ *v)
 
 	v->tok = NILVAR;
 	if(strcmp(s, "ResetStat") == 0)		// resets the statistic
-	{	cell_loss = 0;
-		sdu_loss = 0;
-		sdu_cnt = 0;
-		counter = 0;
-		delay_mean = 0.0;
-	}
+		resetStat();
 	else	return FALSE;
 
 	return TRUE;
 }
 
+void	aal5rec::resetStat(void)
+{
+	cell_loss = 0;
+	sdu_loss = 0;
+	sdu_cnt = 0;
+	counter = 0;
+	delay_mean = 0.0;
+}
+
 
 /********************************************************************/
 /*
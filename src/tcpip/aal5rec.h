@@ -32,10 +32,19 @@
 #include "in1out.h"
 #include "queue.h"
 
+//tolua_begin
 class	aal5rec:	public in1out
 {
 typedef	in1out	baseclass;
 public:
+	aal5rec();
+	~aal5rec();
+	int	act(void);
+	void	resetStat(void);
+	int	getQLen(void) {return q.getlen();}
+	double	getSDUCount(void) {return (double) sdu_cnt;}
+	//tolua_end
+
 	void	init(void);
 	rec_typ	REC(data *, int);	// REC is a macro normally expanding to rec (for debugging)
 
@@ -44,15 +53,17 @@ public:
 
 	uqueue	q;			// queue to store cells until frame extraction
 
+	//tolua_begin
 	// Statistic	
 	int	cell_loss;		// detected cell loss
 	int	sdu_loss;		// detected loss of AAL SDUs
 	int	last_cell;		// sequence number of last cell
 	int	last_sdu;		// sequence number of last valid SDU
+	double	delay_mean;		// mean delay of AAL SDUs
+	//tolua_end
 	size_t	sdu_cnt;		// counter of AAL SDUs
 
 	tim_typ	delay;			// delay of AAL SDUs
-	double	delay_mean;		// mean delay of AAL SDUs
-};
+}; //tolua_export
 
 #endif	// _AAL5REC_H
@@ -54,6 +54,8 @@
 *	AAL5RecMult aal: COPYCID, COPYCLP=<int>, MAXVCI=<int>, OUT=tcp;
 *     	       COPYCID: copy the vci of cells into the frame cid
 *     	       COPYCLP: copy the clp bit of last cell into clp bit of frame
+*	Lua: yats.aal5recMult{"aal", maxvci = 10, copycid = true, copyclp = true,
+*		out = {"tcp", "in"}}, see yats/tcpip.lua.
 *
 *	Command:
 *		aal->ResetStat	// reset all statistics variables
@@ -68,7 +70,7 @@
 *
 *	Mechanism to detect cell and frame losses
 *	=========================================
-*	See AAL5Send in aal5send.c.
+*	See AAL5Send in aal5send.c. Cell trains (aal5Train) are taken as a whole.
 */
 
 
@@ -76,20 +78,81 @@
 
 CONSTRUCTOR(Aal5recMult, aal5recMult)
 
+aal5recMult::aal5recMult()
+{
+	doCopyCid = FALSE;
+	doCopyClp = FALSE;
+	maxvci = 0;
+	q_len = cell_loss = sdu_loss = last_cell = last_sdu = NULL;
+	first_cell = NULL;
+	sdu_cnt = cell_cnt = NULL;
+	delay_mean = NULL;
+}
+
+aal5recMult::~aal5recMult()
+{
+	int	i;
+
+	if (first_cell != NULL)
+		for (i = 0; i < maxvci; ++i)
+			if (first_cell[i] != NULL)
+				delete first_cell[i];
+	delete[] first_cell;
+	delete[] q_len;
+	delete[] cell_loss;
+	delete[] sdu_loss;
+	delete[] last_cell;
+	delete[] last_sdu;
+	delete[] sdu_cnt;
+	delete[] cell_cnt;
+	delete[] delay_mean;
+}
+
 /********************************************************************/
 /*
-*	read definition statement
+*	set up the tables for VCIs 0 ... maxvci - 1
 */
-void	aal5recMult::init(void)
+int	aal5recMult::act(void)
 {
 	int	i;
 
+	if (maxvci < 1)
+		errm1s("%s: invalid MAXVCI", name);
+
+	CHECK(last_cell = new int [maxvci]);
+	for (i = 0; i < maxvci; ++i)
+		last_cell[i] = 0;	// first expected cell: sequence # 1
+
+	CHECK(first_cell = new aal5Cell * [maxvci]);
+	for (i = 0; i < maxvci; ++i)
+		first_cell[i] = NULL;	// next cell is treated as beginning of frame
+
+	CHECK(last_sdu = new int [maxvci]);
+	for (i = 0; i < maxvci; ++i)
+		last_sdu[i] = 0;	// remember last valid sdu sequence number
+	CHECK(sdu_loss = new int [maxvci]);
+	CHECK(cell_loss = new int [maxvci]);
+	CHECK(sdu_cnt = new unsigned int [maxvci]);
+	CHECK(cell_cnt = new unsigned int [maxvci]);
+	CHECK(q_len = new int [maxvci]);
+	for (i = 0; i < maxvci; ++i)
+		q_len[i] = 0;
+	CHECK(delay_mean = new double [maxvci]);
+	resetStat();
+	return 0;
+}
+
+/********************************************************************/
+/*
+*	read definition statement
+*/
+void	aal5recMult::init(void)
+{
 	skip(CLASS);
 	name = read_id(NULL);
 	skip(':');
 	
 	// TEST Mue 13.1.98
-	doCopyCid = FALSE;
 	if (test_word("COPYCID"))
 	{	skip_word("COPYCID");
 		doCopyCid = TRUE;
@@ -98,7 +161,6 @@ void	aal5recMult::init(void)
 	// end TEST
 
 	// Mue 15.2.2000
-	doCopyClp = FALSE;
 	if (test_word("COPYCLP"))
 	{
       	    doCopyClp = read_int("COPYCLP");
@@ -113,36 +175,14 @@ void	aal5recMult::init(void)
 	output("OUT");
 	stdinp();
 
-	CHECK(last_cell = new int [maxvci]);
-	for (i = 0; i < maxvci; ++i)
-		last_cell[i] = 0;	// first expected cell: sequence # 1
-
-	CHECK(first_cell = new aal5Cell * [maxvci]);
-	for (i = 0; i < maxvci; ++i)
-		first_cell[i] = NULL;	// next cell is treated as beginning of frame
-
-	CHECK(last_sdu = new int [maxvci]);
-	for (i = 0; i < maxvci; ++i)
-		last_sdu[i] = 0;	// remember last valid sdu sequence number
-	CHECK(sdu_loss = new int [maxvci]);
-	for (i = 0; i < maxvci; ++i)
-		sdu_loss[i] = 0;	// sdu loss
-	CHECK(cell_loss = new int [maxvci]);
-	for (i = 0; i < maxvci; ++i)
-		cell_loss[i] = 0;	// cell loss
-	CHECK(sdu_cnt = new unsigned int [maxvci]);
-	for (i = 0; i < maxvci; ++i)
-		sdu_cnt[i] = 0;		// sdu counter
-	CHECK(cell_cnt = new unsigned int [maxvci]);
-	for (i = 0; i < maxvci; ++i)
-		cell_cnt[i] = 0;	// cell counter
-	CHECK(q_len = new int [maxvci]);
-	for (i = 0; i < maxvci; ++i)
-		q_len[i] = 0;
+	act();
+}
 
-	CHECK(delay_mean = new double [maxvci]);
-	for (i = 0; i < maxvci; ++i)
-		delay_mean[i] = 0.0;
+int	aal5recMult::chkvci(int vc)
+{
+	if (vc < 0 || vc >= maxvci)
+		errm1s2d("%s: VCI %d out of range (MAXVCI=%d)", name, vc, maxvci - 1);
+	return vc;
 }
 
 /********************************************************************/
@@ -155,16 +195,19 @@ rec_typ	aal5recMult::REC(data *pd, int)	// REC is a macro normally expanding to
 	aal5Cell	*pc = (aal5Cell *) pd;
 	aal5Cell	*pfirst;
 	int		vc;
+	int		ncells = 1;
 
-	typecheck(pd, AAL5CellType);
+	if (pd->type == AAL5TrainType)	// a train is taken as a whole
+		ncells = ((aal5Train *) pd)->ncells;
+	else	typecheck(pd, AAL5CellType);
 
 	vc = pc->vci;
 	if (vc < 0 || vc >= maxvci)
 		errm1s2d("%s: out-of-range VCI=%d received, MAXVCI=%d", name, vc, maxvci - 1);
 
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( counter += ncells))
 		errm1s("%s: overflow of cell counter", name);
-	if ( ++cell_cnt[vc] == 0)
+	if ( (cell_cnt[vc] += ncells) < (unsigned) ncells)
 		errm1s1d("%s: overflow of cell counter for VCI %d", name, vc);
 
 	if( ++last_cell[vc] != pc->cell_seq)
@@ -177,14 +220,15 @@ rec_typ	aal5recMult::REC(data *pd, int)	// REC is a macro normally expanding to
 			delete first_cell[vc];
 		pfirst = first_cell[vc] = pc;
 
-		q_len[vc] = 1;
+		q_len[vc] = ncells;
 	}
 	else
 	{	// expected cell arrived.
 		if ((pfirst = first_cell[vc]) == NULL)
 			pfirst = first_cell[vc] = pc;
-		++q_len[vc];
+		q_len[vc] += ncells;
 	}
+	last_cell[vc] += ncells - 1;	// the other cells of a train
 
 	if (pc->pt == 1)		// end of SAR-SDU. May be the first cell, too.
 	{	if(pc->first_cell == pfirst->cell_seq)
@@ -192,26 +236,27 @@ rec_typ	aal5recMult::REC(data *pd, int)	// REC is a macro normally expanding to
 			// forward data item embedded in last cell
 			if (pc->embedded)
 			{
+				// take it out of pc, otherwise pc->embedded would be
+				// deleted by its receiver *and* when deleting pc !!
+				// (a copy if shared with a clone of pc)
+				data	*pd = pc->takeEmbedded();
+
 				// TEST Mue, 13.1.98
 				if(doCopyCid)
 				{
-				   typecheck(pc->embedded, FrameType);
-				   ((frame *)pc->embedded)->connID = pc->vci;
+				   typecheck(pd, FrameType);
+				   ((frame *)pd)->connID = pc->vci;
 				}
 				// end TEST
 
 				// Mue, 15.2.2000
 				if(doCopyClp)
 				{
-				   typecheck(pc->embedded, FrameType);
-				   ((frame *)pc->embedded)->clp = pc->clp;
+				   typecheck(pd, FrameType);
+				   ((frame *)pd)->clp = pc->clp;
 				}
 
-			
-				suc->rec(pc->embedded, shand);
-				pc->embedded = NULL;	// this is important, otherwise pc->embedded
-							// is deleted by its receiver *and*
-							// when deleting pc !!
+				suc->rec(pd, shand);
 			}
 			else	errm1s("%s: no data item embedded in last cell of frame", name);
 			
@@ -221,10 +266,12 @@ rec_typ	aal5recMult::REC(data *pd, int)	// REC is a macro normally expanding to
 
 			// log the delay of AAL SDU
 			++sdu_cnt[vc];
-			tim_typ	delay = SimTime - pfirst->time;
+			tim_typ	delay = SimTime + ncells - 1 - pfirst->time;
 						// the delay spans from generating
 						// the first cell by the sender
 						// until delivering the frame to user
+						// (the last cell of a train comes
+						// ncells - 1 slots after its first)
 			delay_mean[vc] = (delay_mean[vc] * (sdu_cnt[vc] - 1) + delay) / sdu_cnt[vc];
 		}
 
@@ -255,20 +302,24 @@ int	aal5recMult::command(char *s, tok_typ *v)
 
 	v->tok = NILVAR;
 	if(strcmp(s, "ResetStat") == 0)		// resets the statistic
-	{	for (int i = 0; i < maxvci; ++i)
-		{	cell_loss[i] = 0;
-			cell_cnt[i] = 0;
-			sdu_loss[i] = 0;
-			sdu_cnt[i] = 0;
-			delay_mean[i] = 0.0;
-			counter = 0;
-		}
-	}
+		resetStat();
 	else	return FALSE;
 
 	return TRUE;
 }
 
+void	aal5recMult::resetStat(void)
+{
+	for (int i = 0; i < maxvci; ++i)
+	{	cell_loss[i] = 0;
+		cell_cnt[i] = 0;
+		sdu_loss[i] = 0;
+		sdu_cnt[i] = 0;
+		delay_mean[i] = 0.0;
+	}
+	counter = 0;
+}
+
 
 /********************************************************************/
 /*
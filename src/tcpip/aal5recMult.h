@@ -32,17 +32,35 @@
 #include "in1out.h"
 #include "queue.h"
 
+//tolua_begin
 class	aal5recMult:	public in1out
 {
 typedef	in1out	baseclass;
 public:
+	aal5recMult();
+	~aal5recMult();
+	int	act(void);
+	void	resetStat(void);
+	int	getQLen(int vc) {return q_len[chkvci(vc)];}
+	int	getCellLoss(int vc) {return cell_loss[chkvci(vc)];}
+	int	getSDULoss(int vc) {return sdu_loss[chkvci(vc)];}
+	double	getCellCount(int vc) {return (double) cell_cnt[chkvci(vc)];}
+	double	getSDUCount(int vc) {return (double) sdu_cnt[chkvci(vc)];}
+	double	getDelayMean(int vc) {return delay_mean[chkvci(vc)];}
+	//tolua_end
+
 	void	init(void);
 	rec_typ	REC(data *, int);	// REC is a macro normally expanding to rec (for debugging)
 
 	int	command(char *, tok_typ *);
 	int	export(exp_typ *);
+	int	chkvci(int);
 
+	//tolua_begin
 	int	maxvci;			// range of VCIs
+	int     doCopyCid;		// TRUE: copy VCI of cells into connection ID of packets
+	int     doCopyClp;		// TRUE: copy CLP bit of last cell (pt=1) into clp bit of packets
+	//tolua_end
 
 	// Statistic	
 	int	*q_len;
@@ -57,8 +75,6 @@ public:
 	unsigned int	*cell_cnt;		// counter of cells
 
 	double	*delay_mean;		// mean delay of AAL SDUs
-	int     doCopyCid;		// TRUE: copy VCI of cells into connection ID of packets
-	int     doCopyClp;		// TRUE: copy CLP bit of last cell (pt=1) into clp bit of packets
-};
+}; //tolua_export
 
 #endif	// _AAL5RECMULT_H
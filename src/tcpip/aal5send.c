@@ -86,6 +86,8 @@
 *     	             	{PRINTWARNING=0|1}   	// print warnings? default: 1
 *     	             	{COPYCLP=0|1}   	// copy CLP bit to cells? default: 0
 *     	             	{PT1CLP0=0|1}   	// set PT=1 cells (frame boundaries) to CLp=0 (high prio) default: 0
+*			{TRAIN=32,}		// send up to 32 cells of an SDU as one aal5Train,
+*						// default: 1 (single aal5Cells)
 *			OUTDATA=shap,		// where to send cells
 *			OUTCTRL=src->Start;	// control input of preceeding network object
 *
@@ -104,6 +106,11 @@
 *		aal->SDUCount		// # of AAL5 SDUs sent
 *		aal->DelCount		// # of input frames discarded due to start-stop violation
 *
+*	Lua: yats.aal5send{"aal", vci = 1 | maxcid = 100 [, copycid = true], buf = 100,
+*		bstart = 5, header = 8, printwarning = true, copyclp = false, pt1clp0 = false,
+*		train = 32, out = {{"shap", "in"}, {"src", "start"}}}, see yats/tcpip.lua.
+*	The commands are the methods resetStat(), setTransVCI(cid, vci), setTransCID(cid, newcid).
+*
 *	The source recognizes the start-stop protocol at input and output.
 *	The name of the data input is aal->Data, the control input is aal->Start.
 *	Incomming frames have to implement the interface for data item embedding.
@@ -119,30 +126,111 @@
 *	sequence number. If this holds then the frame has been transmitted succesfully and it can
 *	be extracted from the first cell. Otherwise, all cells in the queue are dropped. Thanks to the SDU
 *	sequence number, the number of lost SDU also can be detected.
+*
+*	Cell trains
+*	===========
+*	With TRAIN=n, up to n consecutive cells of an SDU are sent as one aal5Train (see data.h)
+*	in a single rec() call, the next transmission follows after as many slots as the train has
+*	cells. AAL5Rec and AAL5RecMult take trains directly. Objects which check for cells in
+*	typecheck() (Demux, priority and WFQ multiplexers, Meas with a VCI, ...) reject a train,
+*	and so do the generic multiplexers and measurements (Mux, Meas, Meas2) by traincheck()
+*	(see ino.h). Objects without per-cell accounting (Line, Sink) pass a train as one item.
+*	Feed the trains through an aal5split object in front of multiplexers and measurements.
 */
 
 #include "aal5send.h"
 
 CONSTRUCTOR(Aal5send, aal5send);
 
+aal5send::aal5send()
+{
+	vci = 0;
+	fixVCI = FALSE;
+	copyCID = FALSE;
+	maxcid = 1;
+	translationTabVCI = NULL;
+	translationTabCID = NULL;
+	cellSeqTab = sduSeqTab = NULL;
+	q_start = 0;
+	addHeader = 0;
+	printwarning = 1;	// default is printing
+	CopyClp = 0;		// no copy is default
+	Pt1Clp0 = 0;
+	train = 1;		// single cells is default
+	new_cid = -1;
+	NewClp = 0;  	// default is to set CLP bit to 0
+}
+
+aal5send::~aal5send()
+{
+	delete[] translationTabVCI;
+	delete[] translationTabCID;
+	delete[] cellSeqTab;
+	delete[] sduSeqTab;
+}
+
 /************************************************************************/
 /*
-*	read definition statement
+*	check the parameters (set by the definition statement or by Lua)
+*	and set up the tables and the state
 */
-void	aal5send::init(void)
+int	aal5send::act(void)
 {
 	int	i;
 
+	if (maxcid < 1)
+		errm1s("%s: invalid MAXCID", name);
+	if (q.getmax() < 1)
+		errm1s("%s: invalid BUF", name);
+	if (addHeader < 0)
+		errm1s("%s: invalid HEADER", name);
+	if (train < 1)
+		errm1s("%s: invalid TRAIN", name);
+
+	if ( !fixVCI && !copyCID)
+	{	CHECK(translationTabVCI = new int [maxcid]);
+		CHECK(translationTabCID = new int [maxcid]);
+		for (i = 0; i < maxcid; ++i)
+		{
+			translationTabVCI[i] = 0;
+			translationTabCID[i] = i;	// no change as default
+		}
+	}
+
+	CHECK(sduSeqTab = new int [maxcid]);
+	for (i = 0; i < maxcid; ++i)
+		sduSeqTab[i] = 0;
+	CHECK(cellSeqTab = new int [maxcid]);
+	for (i = 0; i < maxcid; ++i)
+		cellSeqTab[i] = 0;
+
+	curSduSeq = sduSeqTab;		// for safety, and in case of fixVCI
+	curCellSeq = cellSeqTab;	// for safety, and in case of fixVCI
+
+	del_cnt=0;			// counter of deleted frames,
+					// if preceeding object did not recognize the Stop signal
+
+	prec_state = ContSend;		// state of the preceeding object (Start-Stop-Protocol)
+	send_state = ContSend;		// necessary?
+					// YES, in case we get a frame and a start signal in the
+					// first slot (see rec(InpStart) - test on send_state).
+	
+	sdu_cnt = 0;
+	flen = 0;
+	last_tim = 0-1;
+	return 0;
+}
+
+/************************************************************************/
+/*
+*	read definition statement
+*/
+void	aal5send::init(void)
+{
 	skip(CLASS);
 	name = read_id(NULL);
 	skip(':');
 
-	vci = 0;
-	translationTabVCI = NULL;
-	translationTabCID = NULL;
-	
-	fixVCI = FALSE;
-
 	if (test_word("VCI"))
 	{	vci = read_int("VCI");		// reads the VCI for the connection
 		fixVCI = TRUE;
@@ -157,30 +245,12 @@ void	aal5send::init(void)
 
 		if (test_word("COPYCID"))
 		{	skip_word("COPYCID");
-			skip(',');	// translationTabVCI remains NULL
-		}
-		else
-		{	CHECK(translationTabVCI = new int [maxcid]);
-			CHECK(translationTabCID = new int [maxcid]);
-			for (int i = 0; i < maxcid; ++i)
-			{
-				translationTabVCI[i] = 0;
-				translationTabCID[i] = i;	// no change as default
-			}
+			copyCID = TRUE;		// translationTabVCI remains NULL
+			skip(',');
 		}
 	}
 	else	syntax0("`VCI', or `MAXCID' expected");
 
-	CHECK(sduSeqTab = new int [maxcid]);
-	for (i = 0; i < maxcid; ++i)
-		sduSeqTab[i] = 0;
-	CHECK(cellSeqTab = new int [maxcid]);
-	for (i = 0; i < maxcid; ++i)
-		cellSeqTab[i] = 0;
-
-	curSduSeq = sduSeqTab;		// for safety, and in case of fixVCI
-	curCellSeq = cellSeqTab;	// for safety, and in case of fixVCI
-
 	q.setmax(read_int("BUF"));	// length of input queue in numbers of frames
 	if (q.getmax() < 1)
 		syntax0("invalid BUF");
@@ -195,7 +265,6 @@ void	aal5send::init(void)
 			syntax0("invalid HEADER");
 		skip(',');
 	}
-	else	addHeader = 0;
 	
 	if (test_word("PRINTWARNING"))	// print out warnings?
 	{	printwarning = read_int("PRINTWARNING");
@@ -203,8 +272,6 @@ void	aal5send::init(void)
 			syntax0("PRINTWARNING must be 0 or 1");
 		skip(',');
 	}
-	else
-	   printwarning = 1;  // default is printing
 
 	if (test_word("COPYCLP"))	// copy CLP bit
 	{	CopyClp = read_int("COPYCLP");
@@ -212,8 +279,6 @@ void	aal5send::init(void)
 			syntax0("COPYCLP must be 0 or 1");
 		skip(',');
 	}
-	else
-	   CopyClp = 0;  // no copy is default
 
 	if (test_word("PT1CLP0"))	// set PT=1 cells to CLP=0
 	{	Pt1Clp0 = read_int("PT1CLP0");
@@ -221,8 +286,13 @@ void	aal5send::init(void)
 			syntax0("PT1CLP0 must be 0 or 1");
 		skip(',');
 	}
-	else
-	   Pt1Clp0 = 0;  // no copy is default
+
+	if (test_word("TRAIN"))		// send cell trains
+	{	train = read_int("TRAIN");
+		if (train < 1)
+			syntax0("invalid TRAIN");
+		skip(',');
+	}
 
  
 	output("OUTDATA", SucData);	// output DATA
@@ -232,19 +302,7 @@ void	aal5send::init(void)
 	input("Data", InpData);		// input DATA
 	input("Start", InpStart);	// input START
 
-	del_cnt=0;			// counter of deleted frames,
-					// if preceeding object did not recognize the Stop signal
-
-	prec_state = ContSend;		// state of the preceeding object (Start-Stop-Protocol)
-	send_state = ContSend;		// necessary?
-					// YES, in case we get a frame and a start signal in the
-					// first slot (see rec(InpStart) - test on send_state).
-	
-	sdu_cnt = 0;
-	flen = 0;
-	last_tim = 0-1;
-	new_cid = -1;
-	NewClp = 0;  	// default is to set CLP bit to 0
+	act();
 }
 
 /************************************************************************/
@@ -256,12 +314,12 @@ void	aal5send::init(void)
 void	aal5send::early(event *)
 {
 	aal5Cell	*pc;
-
-	pc = new aal5Cell(vci);		// get a new aal5cell
+	data	*pf = NULL;
+	int	ncells;
 
 	if(flen <= 0)
 	{	// start a new new SDU
-		data	*pf = q.first();
+		pf = q.first();
 		flen = pf->pdu_len() + 8 + addHeader;
 					// number of bytes we need in reallity to transmit
 					// given SDU (our trailer included)
@@ -283,11 +341,11 @@ void	aal5send::early(event *)
 			if (translationTabVCI)	// translationTabCID is used only together with this!
 			{
 				// we shall translate the layer-4 connection ID into a new VCI
-				pc->vci = vci = translationTabVCI[cid];	// correct VCI set above
+				vci = translationTabVCI[cid];
 				((frame *) pf)->connID = translationTabCID[cid];
 			}
 			else	// we shall use the layer-4 connection ID as VCI
-				pc->vci = vci = cid;	// correct also the VCI set above
+				vci = cid;
 			
 		} // different VCI's may arrive
 		else
@@ -298,7 +356,20 @@ void	aal5send::early(event *)
 		
 		} // else - a fixed VCI
 		  // else: nothing else to do, pointers point to first table entries, VCI unchanged
+	}
 
+	// the remaining cells of the SDU, at most 'train' of them in one go
+	ncells = (flen + 47) / 48;
+	if (ncells > train)
+		ncells = train;
+	if (Pt1Clp0 && ncells > 1 && 48 * ncells >= flen)
+		--ncells;	// the last cell gets another CLP: send it alone
+	if (train > 1)
+		pc = new aal5Train(vci, ncells);
+	else	pc = new aal5Cell(vci);		// get a new aal5cell
+
+	if (pf != NULL)
+	{	// first cell of the SDU
 		first_seq = pc->cell_seq = ++*curCellSeq;	// increase sequence number of cell
 						// store sequence number of first cell in SDU
 		pc->sdu_seq = ++*curSduSeq;	// sequence number of AAL SDU
@@ -307,8 +378,9 @@ void	aal5send::early(event *)
 	}
 	else	// not the first cell:	increase sequence number of cell
 		pc->cell_seq = ++*curCellSeq;
+	*curCellSeq += ncells - 1;	// the other cells of a train
 
-	if((flen -= 48) <= 0)	// last cell of frame, may equal the first one!
+	if((flen -= 48 * ncells) <= 0)	// last cell of frame, may equal the first one!
 	{	pc->pt = 1;
 		pc->first_cell = first_seq;	// this was the number of the first cell
 
@@ -328,8 +400,8 @@ void	aal5send::early(event *)
 	   pc->clp = 0;
 	chkStartStop(send_state = sucs[SucData]->rec(pc, shands[SucData]));	// send cell
 
-	// log the transmitted cell
-	if( ++counter == 0)
+	// log the transmitted cells
+	if( CNT_OVERFLOW( counter += ncells))
 		errm1s("%s: overflow of departs", name);
 	
 /*
@@ -339,7 +411,7 @@ void	aal5send::early(event *)
 */
 	
 	if (send_state == ContSend && q.getlen() != 0)
-		alarme(&std_evt, 1);
+		alarme(&std_evt, ncells);	// a train occupies ncells slots
 }
 
 
@@ -355,7 +427,7 @@ rec_typ aal5send::REC(data *pd, int key)	// REC is a macro normally expanding to
 		if(prec_state == StopSend) 	// preceeding object ignores stop signal
 		{	
 		     	if(printwarning)
-			   fprintf(stderr, "%s: preceeding object did not recognize the Stop signal, SimTime=%d\n",
+			   fprintf(stderr, "%s: preceeding object did not recognize the Stop signal, SimTime=" TIM_FMT "\n",
 					 name, SimTime);
 			delete pd;
 			if( ++del_cnt == 0)
@@ -395,6 +467,31 @@ void	aal5send::restim(void)
 	last_tim = 0-1;
 }
 
+void	aal5send::resetStat(void)
+{
+	del_cnt = 0;
+	sdu_cnt = 0;
+	counter = 0;
+}
+
+void	aal5send::setTransVCI(int cid, int vc)
+{
+	if (translationTabVCI == NULL)
+		errm1s("%s: no CID->VCI translation table available", name);
+	if (cid < 0 || cid >= maxcid)
+		errm1s2d("%s: out-of-range connection ID %d (MAXCID=%d)", name, cid, maxcid - 1);
+	translationTabVCI[cid] = vc;
+}
+
+void	aal5send::setTransCID(int cid, int newcid)
+{
+	if (translationTabCID == NULL)
+		errm1s("%s: no CID->CID translation table available", name);
+	if (cid < 0 || cid >= maxcid)
+		errm1s2d("%s: out-of-range connection ID %d (MAXCID=%d)", name, cid, maxcid - 1);
+	translationTabCID[cid] = newcid;
+}
+
 int	aal5send::command(char *s, tok_typ *v)
 {
 	if (baseclass::command(s, v))
@@ -402,10 +499,7 @@ int	aal5send::command(char *s, tok_typ *v)
 
 	v->tok = NILVAR;
 	if(strcmp(s, "ResetStat") == 0)		// resets the statistic
-	{	del_cnt = 0;
-		sdu_cnt = 0;
-		counter = 0;
-	}
+		resetStat();
 	else if (strcmp(s, "SetVCI") == 0)
 	{	//	xyz->SetVCI(cid, vci);
 		if (translationTabVCI == NULL)
@@ -32,10 +32,22 @@
 #include "inxout.h"
 #include "queue.h"
 
+//tolua_begin
 class	aal5send:	public inxout
 {
    typedef	inxout	baseclass;
  public:
+   aal5send();
+   ~aal5send();
+   int	act(void);
+   void	resetStat(void);
+   void	setTransVCI(int cid, int vci);	// translation connection ID -> VCI
+   void	setTransCID(int cid, int newcid);	// translation connection ID -> new ID
+   int	getQLen(void) {return q.getlen();}
+   double	getSDUCount(void) {return (double) sdu_cnt;}
+   double	getDelCount(void) {return (double) del_cnt;}
+   //tolua_end
+
    void	init(void);
    void	early(event *);
    rec_typ REC(data *, int);	// REC is a macro normally expanding to rec (for debugging)
@@ -45,15 +57,22 @@ class	aal5send:	public inxout
    
    void	restim(void);	// resets the time dependent values
    
+   //tolua_begin
    queue	q;		// input queue
    int	q_start;	// queue length at which to wake up the sender
    
    int	fixVCI;		// TRUE: do always use the VCI specified in definition statement
+   int	copyCID;	// TRUE: use the connection ID as VCI (without fixVCI)
    int     new_cid; 	// the new CID
    int     CopyClp;        // must clp bit be copied?
    int     NewClp;         // the new clp bit
    int     Pt1Clp0;        // must Pt=1 cells be set to CLP=0?
    int	maxcid;		// range of layer-4 connection IDs
+   int     addHeader;      // length of additional header (e.g LLC/SNAP)
+   int	train;		// max. number of cells sent as one aal5Train, 1: single cells
+   int printwarning;  // print warning messages (start/stop signal not recognized)?
+   //tolua_end
+
    int	*translationTabVCI;// translation connection ID -> VCI
    // NULL: copy connection ID of packets into VCI of cells
    int	*translationTabCID;// translation connection ID -> new ID
@@ -73,15 +92,11 @@ class	aal5send:	public inxout
    rec_typ	prec_state;	// state of the preceeding object
    rec_typ	send_state;	// state of this object
    
-   int     addHeader;      // length of additional header (e.g LLC/SNAP)
-   
    enum	{SucData = 0, SucCtrl = 1};
    enum	{InpData = 0, InpStart = 1};
    
    tim_typ	last_tim;	// when sent last (only a check to prevent sending twice in a slot)
    
-   int printwarning;  // print warning messages (start/stop signal not recognized)?
-   
-};
+}; //tolua_export
 
 #endif	// _AAL5SEND_H
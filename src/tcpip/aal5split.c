@@ -0,0 +1,66 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*     Copyright (C) 1995-1997	Chair for Telecommunications
+*				Dresden University of Technology
+*				D-01062 Dresden
+*				Germany
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+/*
+*	AAL5 train splitter, see aal5split.h
+*/
+
+#include "aal5split.h"
+
+// REC is a macro normally expanding to rec (for debugging)
+rec_typ	aal5split::REC(data *pd, int)
+{
+  if (q.enqueue(pd) == FALSE) {
+    delete pd;
+    if ( CNT_OVERFLOW( ++counter))
+      errm1s("%s: overflow of loss counter", name);
+  } else if (q.getlen() == 1)
+    alarme( &std_evt, 1);
+  return ContSend;
+}
+
+/*
+*	send the next cell
+*/
+void	aal5split::early(event *)
+{
+  data	*pd = q.first();
+
+  if (pd->type == AAL5TrainType) {
+    aal5Train	*pt = (aal5Train *) pd;
+    pd = pt->split();
+    if (pt->ncells == 0)
+      delete q.dequeue();
+  } else
+    q.dequeue();
+  suc->rec(pd, shand);
+
+  if (q.getlen() != 0)
+    alarme( &std_evt, 1);
+}
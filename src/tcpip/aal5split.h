@@ -0,0 +1,61 @@
+/*************************************************************************
+*
+*		YATS - Yet Another Tiny Simulator
+*
+**************************************************************************
+*
+*     Copyright (C) 1995-1997	Chair for Telecommunications
+*				Dresden University of Technology
+*				D-01062 Dresden
+*				Germany
+*
+**************************************************************************
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*************************************************************************/
+
+/*
+*	Splits AAL5 cell trains (aal5Train, see data.h) into single cells.
+*	Place it in front of objects working on single cells (multiplexers,
+*	measurements), which reject trains in typecheck() or traincheck().
+*	One cell is sent per slot, a train remains one object in the queue
+*	until its last cell is taken off. Other data items are forwarded in
+*	order, one per slot.
+*
+*	counter: number of data items lost (queue full)
+*/
+
+#ifndef	_AAL5SPLIT_H
+#define	_AAL5SPLIT_H
+
+#include "in1out.h"
+#include "queue.h"
+
+//tolua_begin
+class	aal5split:	public	in1out	{
+  typedef	in1out	baseclass;
+public:
+  aal5split(){}
+  ~aal5split(){}
+  rec_typ REC(data *, int);	// REC is a macro normally expanding to rec (for debugging)
+  void	early(event *);
+
+  queue	q;		// trains and other data items waiting
+  int	getQLen(void) {return q.getlen();}
+};
+//tolua_end
+
+#endif	// _AAL5SPLIT_H
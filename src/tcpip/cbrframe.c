@@ -62,7 +62,7 @@ int cbrframe::act(void)
 
 void cbrframe::early(event *)
 {
-   if ( ++counter == 0)
+   if ( CNT_OVERFLOW( ++counter))
       errm1s("%s: overflow of departs", name);
 
    if (sent + pkt_len > bytes)
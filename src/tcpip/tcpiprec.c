@@ -91,12 +91,12 @@
 
 Acknowledgement Handling
 ========================
-Delayed ACK:	- If we got new in-sequence data. Done in early(), branch evtProcq.
-Immediate ACK:	- If we got out-of-sequence data. Done in early(), branch evtProcq.
+Delayed ACK:	- If we got new in-sequence data. Done in procqExpired().
+Immediate ACK:	- If we got out-of-sequence data. Done in procqExpired().
 		- If the receiver window closed to 0. Done in process_reseq().
 		- If the receiver window opened by at least 1 MSS or 50 (35 fo SunOS) per cent of the
 		  buffer size (RFC1122, section 4.2.3.3). Done in process_output().
-		- If we got a window probe (window is 0). Done in early(), branch evtProcq.
+		- If we got a window probe (window is 0). Done in procqExpired().
 
 Both ACK types are launched via timers (evtDelAck and evtImAck).
 
@@ -108,10 +108,10 @@ Central routines
 ================
 rec() (branch: data received):
 Incomming packets are simply queued in the processing queue which models the processing delay per packet.
-The process which serves the queue is the main part of the method early(), where in the asociated branch
-the queue is served. This process is woken up if necessary.
+The process which serves the queue is the method procqExpired(), the handler of evtProcq.
+This process is woken up if necessary.
 
-early() (branch: event for serving processing queue)
+procqExpired() (event for serving processing queue)
 A packet is taken from the processing queue, and the sequence number and length of the packet are corrected
 according to the nxt value already reached, and to the current window size (the latter against misbehaving
 sender). If a window probe is encountered, the immediate acknowledge is launched. If the packet begins with
@@ -149,6 +149,8 @@ Problems
 
 tcpiprec::~tcpiprec()
 {
+  if (trace)
+    delete trace;
 }
 
 int tcpiprec::act(void)
@@ -336,6 +338,8 @@ void	tcpiprec::init(void)
 // REC is a macro normally expanding to rec (for debugging)
 rec_typ	tcpiprec::REC(data *pd,	int key)
 {
+  randscope rs(this);	// procDelay() draws random numbers
+
   switch (key) {
   case InpData:	// data input, continuation below
     break;
@@ -398,6 +402,8 @@ rec_typ	tcpiprec::REC(data *pd,	int key)
   if (SimTime >= pf->TCPSendStamp) {
     PDU_delay = SimTime - pf->TCPSendStamp;
     PDU_delay_mean = (PDU_delay_mean * PDU_cnt + PDU_delay) / (double)(PDU_cnt + 1);
+    if (trace)
+      trace->put(TREC_PDU, PDU_delay, connID, pf->frameLen);
   }
   else
     fprintf(stderr, "%s: SimTime has been reset, reusing last PDU_delay", name);
@@ -409,65 +415,95 @@ rec_typ	tcpiprec::REC(data *pd,	int key)
 } // end of tcpiprec::rec()
   
 //*****************************************************************************/
-// A timer expired
+// A timer expired: the events are bound to the methods below, early() is
+// only used for events without a handler
 //*****************************************************************************/
 void  tcpiprec::early(event *evt)
 {
   switch (evt->key) {
   case keyProcq:
-    break;	// processing queue, continuation below
-    
-  case keyImAck:	// timer for immediate ACK
-    needImAck = FALSE;
-		// we also doe the job of the delayed ACK
-    if (needDelAck) {
-      unalarme( &evtDelAck);
-      needDelAck = FALSE;
-    }
-    send_ack();
+    procqExpired(evt);
     return;
-
-  case keyTick:	// clock tick
-    ++tcp_now;
-    alarme( &evtTick, ticks_to_slots(1));
-    
-    // Update throughput value. netto throughput in bit per sec
-    if (SimTime > conn_time)
-      throughput = tp_bytes / slots_to_secs(SimTime - conn_time) * 8;
+  case keyImAck:
+    imAckExpired(evt);
     return;
-    
-  case keyDelAck:	// timer for delayed ACK
-    needDelAck = FALSE;
-    // if an immediate ACK is on the way, we skip this delayed one ...
-    // ### we also could say: use this ACK and drop the immediate one ???
-    if ( !needImAck)
-      send_ack();
+  case keyTick:
+    tickExpired(evt);
     return;
-    
-  case keyOutput:	// send next data to user
-    activeOutput = FALSE;
-    process_output();
+  case keyDelAck:
+    delAckExpired(evt);
     return;
-    
-  case keyKeepAlive:	// Keep Alive Timer
-    if(keepalive_secs > 0)
-      alarme( &evtKeepAlive, secs_to_slots(keepalive_secs));
-    
-    if ( arrived_segments > 0 && !needImAck) {
-      needImAck = TRUE;
-      alarme( &evtImAck, procDelay(iack_delay));
-    }
+  case keyOutput:
+    outputExpired(evt);
+    return;
+  case keyKeepAlive:
+    keepAliveExpired(evt);
     return;
-    
   default:errm1s("%s: in tcpiprec::early(): internal error: unknown event type", name);
     return;
   }
+}
 
-  // process waiting packets, all other cases already are returned
+// timer for immediate ACK
+void  tcpiprec::imAckExpired(event *)
+{
+  needImAck = FALSE;
+  // we also doe the job of the delayed ACK
+  if (needDelAck) {
+    unalarme( &evtDelAck);
+    needDelAck = FALSE;
+  }
+  send_ack();
+}
+
+// clock tick
+void  tcpiprec::tickExpired(event *)
+{
+  ++tcp_now;
+  alarme( &evtTick, ticks_to_slots(1));
+    
+  // Update throughput value. netto throughput in bit per sec
+  if (SimTime > conn_time)
+    throughput = tp_bytes / slots_to_secs(SimTime - conn_time) * 8;
+}
+
+// timer for delayed ACK
+void  tcpiprec::delAckExpired(event *)
+{
+  needDelAck = FALSE;
+  // if an immediate ACK is on the way, we skip this delayed one ...
+  // ### we also could say: use this ACK and drop the immediate one ???
+  if ( !needImAck)
+    send_ack();
+}
+
+// send next data to user
+void  tcpiprec::outputExpired(event *)
+{
+  activeOutput = FALSE;
+  process_output();
+}
+
+// Keep Alive Timer
+void  tcpiprec::keepAliveExpired(event *)
+{
+  if(keepalive_secs > 0)
+    alarme( &evtKeepAlive, secs_to_slots(keepalive_secs));
+    
+  if ( arrived_segments > 0 && !needImAck) {
+    needImAck = TRUE;
+    alarme( &evtImAck, procDelay(iack_delay));
+  }
+}
+
+// processing queue
+void  tcpiprec::procqExpired(event *)
+{
+  // process waiting packets
   
   tcpipFrame	*pf;     
   if ((pf = (tcpipFrame *) procq.dequeue()) == NULL)
-    errm1s("%s: internal error: tcpipsend::early(): queuing error in processing queue", name);
+    errm1s("%s: internal error: tcpiprec::procqExpired(): queuing error in processing queue", name);
   
   if ( !procq.isEmpty())
     alarme( &evtProcq, procDelay(proc_time));
@@ -522,7 +558,7 @@ void  tcpiprec::early(event *evt)
 	
   if (pf->frameLen < 0)	{
     // it's probably rubbish data, so we don't ACK this  
-    errm1s1d("%s: internal error: tcpipsend::early(): Frame Lenght < 0 not possible: value=%d", 
+    errm1s1d("%s: internal error: tcpiprec::procqExpired(): Frame Lenght < 0 not possible: value=%d", 
 	     name, pf->frameLen);	
     delete pf;
     return;
@@ -604,7 +640,7 @@ void  tcpiprec::early(event *evt)
 
   } // end of out-of-order segment
   
-} // end of early()
+} // end of procqExpired()
 
 
 //*****************************************************************************/
@@ -641,6 +677,8 @@ void tcpiprec::process_reseq(void)
     if (SimTime >= pk->TCPPackStamp){
       SDU_delay = SimTime - pk->TCPPackStamp;
       SDU_delay_mean = (SDU_delay_mean * SDU_cnt + SDU_delay) / (double)(SDU_cnt + 1);
+      if (trace)
+	trace->put(TREC_SDU, SDU_delay, connID, pk->frameLen);
     }
     else
       fprintf(stderr, "%s: SimTime has been reset, reusing last SDU_delay", name);
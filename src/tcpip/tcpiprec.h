@@ -31,22 +31,24 @@
 
 #include "inxout.h"
 #include "queue.h"
+#include "tracewr.h"
 
 //tolua_begin
 class	tcpiprec:	public inxout
 {
   typedef	inxout	baseclass;
 public:
-  tcpiprec(void): evtImAck(this, keyImAck), 
-		  evtTick(this, keyTick),
-		  evtDelAck(this, keyDelAck), 
-		  evtOutput(this, keyOutput),
-		  evtProcq(this, keyProcq),
-		  evtKeepAlive(this, keyKeepAlive)
+  tcpiprec(void): evtImAck(this, keyImAck, evt_method<tcpiprec, &tcpiprec::imAckExpired>), 
+		  evtTick(this, keyTick, evt_method<tcpiprec, &tcpiprec::tickExpired>),
+		  evtDelAck(this, keyDelAck, evt_method<tcpiprec, &tcpiprec::delAckExpired>), 
+		  evtOutput(this, keyOutput, evt_method<tcpiprec, &tcpiprec::outputExpired>),
+		  evtProcq(this, keyProcq, evt_method<tcpiprec, &tcpiprec::procqExpired>),
+		  evtKeepAlive(this, keyKeepAlive, evt_method<tcpiprec, &tcpiprec::keepAliveExpired>)
   {
     ptrTcpSend = NULL;		
     sockstate = ContSend;		
     reseq_head = NULL;
+    trace = NULL;
   }
   ~tcpiprec();
   int act(void);
@@ -98,6 +100,7 @@ public:
   int	PDU_delay;		// delay of current PDU
   double	PDU_delay_mean;		// mean delay of PDUs
   int	PDU_cnt;		// counter for delay statistic calculation
+  tracewr	*trace;		// binary trace of the PDU and SDU delays, or NULL
   
   double	throughput;		// throughput of connection in bits/sec
   
@@ -122,6 +125,12 @@ public:
   
   rec_typ	REC(data *, int);	// REC is a macro normally expanding to rec (for debugging)
   void    early(event *);
+  void    procqExpired(event *);	// handlers of the events
+  void    imAckExpired(event *);
+  void    tickExpired(event *);
+  void    delAckExpired(event *);
+  void    outputExpired(event *);
+  void    keepAliveExpired(event *);
 #if 0 
   //tolua_end
   int	command(char *, tok_typ *);
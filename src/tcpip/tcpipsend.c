@@ -625,32 +625,52 @@ void tcpipsend::connect()
 #endif
 /********************************************************************/
 /*
-*	a timer has expired
+*	a timer has expired: the events are bound to the methods below,
+*	early() is only used for events without a handler
 */
 void tcpipsend::early(event *evt)
 {
    switch (evt->key) {
-   case keyProcq:		// run processing queue
-      active_procq = FALSE;
-      send_pkt();
+   case keyProcq:
+      procqExpired(evt);
       break;
+   case keyRTO:
+      rtoExpired(evt);
+      break;
+   case keySlowtimo:
+      slowtimoExpired(evt);
+      break;
+   default:errm1s("%s: internal error: tcpipsend::early(): unknown event type",
+      name);
+   }  // switch
 
-   case keyRTO:		// Retransmission Timeout
-      active_rt_timer = FALSE;
-      nxt = una;  
-      rtt = 0;		// Karn's Algorithm
+}  // end of function void tcpipsend::early(event *)
 
-      if (doLogRetr)
-      	 printf("# %s at %d: retransmission timeout, rto_tim = %u\n",
+// run processing queue
+void tcpipsend::procqExpired(event *)
+{
+   active_procq = FALSE;
+   send_pkt();
+}
+
+// Retransmission Timeout
+void tcpipsend::rtoExpired(event *)
+{
+   active_rt_timer = FALSE;
+   nxt = una;  
+   rtt = 0;		// Karn's Algorithm
+
+   if (doLogRetr)
+   	 printf("# %s at " TIM_FMT ": retransmission timeout, rto_tim = " TIM_FMT "\n",
 	    name, SimTime, rto_val);
 
-      if (nxt == nxt_last_rto)	// no progress since last time-out
-      {
-      	 if ( ++abort_cnt >= 13) // reset connection after 12 failed retransm.
+   if (nxt == nxt_last_rto)	// no progress since last time-out
+   {
+   	 if ( ++abort_cnt >= 13) // reset connection after 12 failed retransm.
 	 {
 	    if (doLogRetr)
 	       fprintf(stderr, "# %s: end of transmission because of 12 failed "
-	          "retransmissions of segment with seq=%d, SimTime=%d\n",
+	          "retransmissions of segment with seq=%d, SimTime=" TIM_FMT "\n",
 		  name, nxt, SimTime);
 	    aborted = TRUE;		// means that the connection is closed
 	    unalarme(&slowtimo);
@@ -667,15 +687,15 @@ void tcpipsend::early(event *evt)
 
 	 // Test Mue ABORT_CNT 15.04.1998
 	 StatAbortCnt[abort_cnt-1]++;
-      }
-      else
-      	 abort_cnt = 0;	// we made a transmission progress
+   }
+   else
+   	 abort_cnt = 0;	// we made a transmission progress
 
-      nxt_last_rto = nxt;
+   nxt_last_rto = nxt;
 
-      // Reset ssthresh and congestion window size
-      {
-      	 int win;
+   // Reset ssthresh and congestion window size
+   {
+   	 int win;
 	 win = min(wnd, cwnd) / 2 / max_seg_size;
 	 win = max(win, 2);
 	 ssthresh = win * max_seg_size;	// approx. half of old win
@@ -686,44 +706,34 @@ void tcpipsend::early(event *evt)
 	 printf("# %s at %d: retransmission timeout, ssthresh = %d\n",
 	    name, SimTime, ssthresh);
 	 */
-      }
+   }
 
-      calc_send(TCPRetrans);	// we do retransmission
+   calc_send(TCPRetrans);	// we do retransmission
 
-      // Log retransmission timeout
-      ++rexmto;
+   // Log retransmission timeout
+   ++rexmto;
 
-      // register another timeout using exponential backoff
-      rto_val = min(rto_val * 2, secs_to_slots(rto_ub)); 
-      // Double retrans timeout, recognize upper bound
+   // register another timeout using exponential backoff
+   rto_val = min(rto_val * 2, secs_to_slots(rto_ub)); 
+   // Double retrans timeout, recognize upper bound
 
-      if (active_rt_timer)
-      	 unalarme( &rt_timer);
-      else
-      	 active_rt_timer = TRUE;
+   active_rt_timer = TRUE;
 
-      if(SimTime < SimTime + rto_val)
-      	 alarme(&rt_timer, rto_val);
-      else
-      	 errm1s("%s: want to alarm an event later then maximum SimTime\n",
+   if(SimTime < SimTime + rto_val)
+   	 realarme(&rt_timer, rto_val);
+   else
+   	 errm1s("%s: want to alarm an event later then maximum SimTime\n",
 	    name);
+}
 
-      break;	// end of Retransmission Timeout
-
-
-   case keySlowtimo:	// 500msec timer
-      if(rtt > 0)	// if RTT is currently being measured:
-      	 ++rtt;	// inc rtt
-      ++tcp_now;	// inc clock
-      alarme( &slowtimo, ticks_to_slots(1));
-      
-      break;
-
-   default:errm1s("%s: internal error: tcpipsend::early(): unknown event type",
-      name);
-   }  // switch
-
-}  // end of function void tcpipsend::early(event *)
+// 500msec timer
+void tcpipsend::slowtimoExpired(event *)
+{
+   if(rtt > 0)	// if RTT is currently being measured:
+   	 ++rtt;	// inc rtt
+   ++tcp_now;	// inc clock
+   alarme( &slowtimo, ticks_to_slots(1));
+}
 
 
 /********************************************************************/
@@ -732,6 +742,8 @@ void tcpipsend::early(event *evt)
 */
 rec_typ	tcpipsend::REC(data *pd,int key)
 {
+   randscope rs(this);	// procDelay() draws random numbers
+
    switch (key) {
    case InpData:	 // INPUT DATA
    {
@@ -769,7 +781,7 @@ rec_typ	tcpipsend::REC(data *pd,int key)
       if (received_bytes > received_bytes + pf->frameLen + wnd_max)
       {
       	 fprintf(stderr, "%s: end of transmission because of sequence number"
-	    "overflow, received_bytes=%d, SimTime=%d\n",
+	    "overflow, received_bytes=%d, SimTime=" TIM_FMT "\n",
 	    name, received_bytes, SimTime);
 	 prec_state = StopSend;
 	 EndSend = TRUE;   // means that no data from input DATA is excepted
@@ -877,7 +889,7 @@ void tcpipsend::process_ack(tcpAck *pa)
 	    int	win;
 
 	    if (doLogRetr)
-      	       printf("# %s at %d: fast retransmission\n", name, SimTime);
+      	       printf("# %s at " TIM_FMT ": fast retransmission\n", name, SimTime);
 
 	    old_next = nxt;	// store old nxt
 
@@ -940,7 +952,7 @@ void tcpipsend::process_ack(tcpAck *pa)
       if (doFastRetr && dupacks >= rexmtthresh && cwnd > ssthresh)	
       {	// first nonduplicate ACK -> fast recovery is complete
 	 if (doLogRetr)
-	    printf("# %s at %d: FROK\n", name, SimTime);
+	    printf("# %s at " TIM_FMT ": FROK\n", name, SimTime);
 	 cwnd = ssthresh;  // if cwnd exceeds ssthresh set it back
 	 cwnd_d = (double) cwnd;
       }
@@ -1044,25 +1056,24 @@ void tcpipsend::process_ack(tcpAck *pa)
    // set cwnd to least # of FULL packets allowed by cwnd_d
    cwnd = (((int)(cwnd_d))/max_seg_size) * max_seg_size;
 
-   // stop retrans timer
-   if(active_rt_timer)
-   {
-      unalarme(&rt_timer);
-      active_rt_timer = FALSE;
-   }
-
-   // If the retransm. queue is not empty, restart the retransmission timer 
+   // If the retransm. queue is not empty, restart the retransmission timer,
+   // otherwise stop it
    if(una < nxt)
    {
       rto_val = rto_calc;
       //{ rto_val = (tim_typ)(rto_calc * (1000 + my_rand() % 1000) / 1000.0);
       if(SimTime < SimTime + rto_val)
-      	 alarme( &rt_timer, rto_val);
+      	 realarme( &rt_timer, rto_val);
       else
       	 errm1s("%s: want to alarm an event later then maximum SimTime\n",
 	    name);
       active_rt_timer = TRUE; 
    }
+   else if(active_rt_timer)
+   {
+      unalarme(&rt_timer);
+      active_rt_timer = FALSE;
+   }
 
    calc_send(TCPPlain);
 
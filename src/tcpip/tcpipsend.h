@@ -37,13 +37,16 @@ class tcpipsend: public inxout
 {
   typedef	inxout	baseclass;
 public:
-  tcpipsend(void): evtProcq(this, keyProcq),
-		   rt_timer(this, keyRTO), 
-		   slowtimo(this, keySlowtimo){}
+  tcpipsend(void): evtProcq(this, keyProcq, evt_method<tcpipsend, &tcpipsend::procqExpired>),
+		   rt_timer(this, keyRTO, evt_method<tcpipsend, &tcpipsend::rtoExpired>), 
+		   slowtimo(this, keySlowtimo, evt_method<tcpipsend, &tcpipsend::slowtimoExpired>){}
   ~tcpipsend(){};
   int act(void);
 
   void	early(event *);
+  void	procqExpired(event *);		// handlers of the events
+  void	rtoExpired(event *);
+  void	slowtimoExpired(event *);
   // REC() normally expands to rec() (macro for debugging)
   rec_typ REC(data *, int);
   
@@ -93,7 +93,7 @@ rec_typ	termStartStop::REC(data	*pd, int	inpKey)
       // we cannot send this guy immediately, try to queue it
       if (q.enqueue(pd) == FALSE) {
 	delete pd;
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( ++counter))
 	  errm1s("%s: overflow of loss counter", name);
       }
       return ContSend;
@@ -104,7 +104,7 @@ rec_typ	termStartStop::REC(data	*pd, int	inpKey)
       // wait a slot.
       if (q.enqueue(pd) == FALSE) {
 	delete pd;
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( ++counter))
 	  errm1s("%s: overflow of loss counter", name);
       } else
 	alarme( &std_evt, 1);
@@ -102,7 +102,7 @@ void	aal5sendprio::early(event *)
 	chkStartStop(send_state = sucs[SucData]->rec(pc, shands[SucData]));	// send cell
 
 	// log the transmitted cell
-	if( ++counter == 0)
+	if( CNT_OVERFLOW( ++counter))
 		errm1s("%s: overflow of departs", name);
 	
 /*
@@ -214,7 +214,7 @@ void	aal5sred::early(event *)
 	chkStartStop(send_state = sucs[SucData]->rec(pc, shands[SucData]));	// send cell
 
 	// log the transmitted cell
-	if( ++counter == 0)
+	if( CNT_OVERFLOW( ++counter))
 		errm1s("%s: overflow of departs", name);
 	
 /*
@@ -234,6 +234,7 @@ void	aal5sred::early(event *)
 */
 rec_typ aal5sred::REC(data *pd, int key)	// REC is a macro normally expanding to rec (for debugging)
 {
+   randscope rs(this);	// red.Update() draws random numbers
    switch (key) {
    case InpData:	//input is data
 
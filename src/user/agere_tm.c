@@ -37,7 +37,6 @@
 AgereTm::AgereTm() : evtShapingRate(this, keyShapingRate)
   {
     TimeSendNextShapingRate = -1.0;
-    alarmed_late = FALSE;   	 // not alarmed
     alarmed_early = FALSE;
     connected = FALSE;
     buff_p = 0;
@@ -252,7 +251,7 @@ SdwrrScheduler::SdwrrScheduler(root* owner,
   maxPduSize = 1500;
   maxWeight = 100;
   
-  eachl(&std_evt);
+  lazyl(&std_evt);	// not woken, the sds is unused (see late())
 };
 
 ///////////////////////////////////////////////////////////////
@@ -508,11 +507,7 @@ rec_typ AgereTm::REC(data *pd,int i)
   
   inp_ptr->inp = i;
   (inp_ptr++)->pdata = pd;
-  if (!alarmed_late)
-    {
-      alarmed_late = TRUE;
-      alarml( &std_evt, 0);
-    }
+  wakel( &std_evt);	// process the input buffer in late()
   
   return ContSend;
   
@@ -535,8 +530,6 @@ void AgereTm::late(event *evt)
   inpstruct   *p;
   int todrop;
   
-  alarmed_late = FALSE;	// I am not alarmed anymore
-  
   n = inp_ptr - inp_buff;	// number of cells to serve
   while (n > 0)
     {	
@@ -6,6 +6,7 @@
 #include "inxout.h"
 #include "queue.h"
 #include "oqueue.h"
+#include "pqueue.h"
 #include "leakybucket.h"
 #include "mux.h"
 
@@ -99,7 +100,6 @@ public:
                 // issue: I need 4 of them
 #endif
 
-  int alarmed_late; 	// alarmed for late phase?
   int alarmed_early; 	// alarmed for elary phase?
 
   // We expose the the following to Lua via package file for direct access.
@@ -243,7 +243,10 @@ public:
                                                 // beginning from the startlist
   void enqueueQueue(AgereTmTrafficQueue *tq);	// enqueue new traffic queue
   
-  void late(event* evt)	// called each time slot
+  // The sds is unused: nothing puts a traffic queue into it, since the
+  // rate limiting in dequeueFrame() is not implemented. late() is registered
+  // by lazyl() and never woken; code filling the sds has to wakel(&std_evt).
+  void late(event* evt)
   {
     AgereTmTrafficQueue *tq;
     
@@ -257,12 +260,14 @@ public:
 	tq = (AgereTmTrafficQueue*) sds.dequeue();
 	enqueueQueue(tq); 	// enqueue the traffic queue in the 4 lists
       }
+    if(sds.first() != NULL)
+      wakel(&std_evt);	// poll again in the next slot
   };
   
   root* SchedulerOwner; 	// the owner object of this scheduler queue
   AgereTmTrafficQueue **TrafficQueue;
   uoqueue list[4];		// the 4 lists
-  uoqueue sds; 			// the shared dynamic scheduler
+  pqueue<root> sds; 		// the shared dynamic scheduler (sorted by time), unused
   // for rate limiting of traffic queues
   int currentList;
   int enqueueList;
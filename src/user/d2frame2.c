@@ -99,6 +99,7 @@ rec_typ	dat2fram2::REC(	// REC is a macro normally expanding to rec (for debuggi
 	data	*pd,
 	int)
 {
+	randscope rs(this);	// the frame length is drawn here
 	delete	pd;
 	flen =  table[my_rand() % RAND_MODULO];
 	if(flen <= 0)
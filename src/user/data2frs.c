@@ -39,7 +39,7 @@ int data2frs::REC(data    *pd,int)
 
    delete(pd);
 
-   if ( ++counter == 0)
+   if ( CNT_OVERFLOW( ++counter))
    {
       errm1s("%s: overflow of Count", name);
    }   
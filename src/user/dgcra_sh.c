@@ -161,7 +161,7 @@ rec_typ	dgcra_s::REC(
 			else
 			{  
 			  // no buffer available, delete cells
-				if ( ++counter == 0 )
+				if ( CNT_OVERFLOW( ++counter))
 					errm1s("%s: overflow of counter", name);
 					delete pd;
 			}
@@ -192,7 +192,7 @@ rec_typ	dgcra_s::REC(
 		if ( q_len >= q_max )
 		{  
 		  // buffer overflow -> delete cell
-			if ( ++counter == 0 )
+			if ( CNT_OVERFLOW( ++counter))
 				errm1s("%s: overflow of counter", name);
 			delete pd;
 		}
@@ -143,7 +143,7 @@ void	distsrc2::early(
 {
         tim_typ evt_time;
         
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( ++counter))
 		errm1s("%s: overflow of counter", name);
 	suc->rec(new cell(vci), shand);
 
@@ -282,19 +282,12 @@ rec_typ ethbridge::REC(data *pd, int portno)
 	    // second to n-th output port:
 	    // - duplicate and forward
 	    mcast++;
-	    pfn = new frame(pf->frameLen, pf->connID);
-	    // copy all header fields
-	    pfn->smac = pf->smac;
-	    pfn->dmac = pf->dmac;
-	    pfn->tpid = pf->tpid;
-	    pfn->vlanId = pf->vlanId;
-	    pfn->vlanPriority = pf->vlanPriority;
-	    pfn->tpid2 = pf->tpid2;
-	    pfn->vlanId2 = pf->vlanId2;
-	    pfn->vlanPriority2 = pf->vlanPriority2;
-	    pfn->dropPrecedence = pf->dropPrecedence;
-	    pfn->prioCodePoint = pf->prioCodePoint;
-	    pfn->sender = pf->sender;
+	    // copy all header fields, an embedded data item is shared
+	    pfn = (frame *) pf->clone();
+	    // the copies count as new frames: created now, default clp
+	    pfn->time = SimTime;
+	    pfn->clp = 1;
+	    pfn->internalDropPrecedence = 0;
 	    // handle rest on output
 	    out_mux[i]->rec(pfn, i);
 	 }
@@ -39,6 +39,8 @@
 *	original data object is forwarded to the first output.
 *	The data type should not matter, if the clone() method is defined
 *	properly. This is just to test the clone() methods.
+*	The copies share an embedded data item (see data::share()): one
+*	allocation per output, independent of the depth of embedding.
 *
 *	Fork fork:	NOUT=3,
 *			OUT=sink[1], sink[2], sink[3];
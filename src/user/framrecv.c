@@ -116,7 +116,7 @@ void	framerecv::early(event *)
    pf = (frame*) inqueue.first();
    if(pf == NULL)
    {
-      fprintf(stderr, "Simtime=%d, byte_to_send: %d\n",SimTime, byte_to_send);
+      fprintf(stderr, "Simtime=" TIM_FMT ", byte_to_send: %d\n",SimTime, byte_to_send);
       errm1s("%s: Internal error: no data in inqueue but order to send", name);
    }
          
@@ -69,7 +69,7 @@ rec_typ   framesend::REC(data *pd, int key)
 {
    data *newframe;
    
-   if(++counter == 0)
+   if(CNT_OVERFLOW( ++counter))
       errm1s("%s: overflow of departs", name);
 
    newframe = pd->clone();
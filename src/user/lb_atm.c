@@ -163,7 +163,7 @@ rec_typ	lb_atmf::REC(
 	//	test on overflow	
 	if (lb_siz > lb_max)
 	{	//	overflow -> tag or delete cell
-		if ( ++counter == 0)
+		if ( CNT_OVERFLOW( ++counter))
 			errm1s("%s: overflow of counter", name);
 
 		if (lb_tag == 1)
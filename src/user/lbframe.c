@@ -90,7 +90,7 @@ rec_typ	lbframe::REC(data *pd,int)
       
          vci_clp = 1;	// passed = false
 
-	 if ( ++counter == 0)
+	 if ( CNT_OVERFLOW( ++counter))
             errm1s("%s: overflow of counter", name);
       }
       else
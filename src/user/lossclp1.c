@@ -83,6 +83,7 @@ void lossclp1::init(void)
 /////////////////////////////////////////////////////////////////////////////
 rec_typ lossclp1::REC(data *pd,int)
 {
+   randscope rs(this);	// the loss decision draws random numbers
 
    received++;
 
@@ -55,7 +55,7 @@ rec_typ	measframe::REC(data *pd,int)
 
    typecheck(pd, FrameType);   // input data type check
    
-   if (++counter == 0)
+   if (CNT_OVERFLOW( ++counter))
       errm1s("%s: overflow of counter", name);
 
    pf = (frame*) pd;
@@ -113,6 +113,8 @@ void	muxpacket::early(event *)
 {
    suc->rec(q.dequeue(), shand);
    serving = FALSE;
+   if (q.getlen() != 0)
+      wakel( &event_each);	// serve the next one in late()
 }
 
 //	Transfered to LUA init
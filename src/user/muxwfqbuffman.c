@@ -425,7 +425,10 @@ void muxWFQBuffMan::late(event*)
 
    inp_ptr = inp_buff;
    if ( !sortq.isEmpty())
+   {
       alarme( &std_evt, 1);
+      wakel( &event_each);
+   }
 
 } // late()
 
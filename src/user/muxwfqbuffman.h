@@ -3,6 +3,7 @@
 
 
 #include "mux.h"
+#include "pqueue.h"
 #include "red_special.h"
 
 class WFQBuffManConnParam : public cell
@@ -74,7 +75,7 @@ class muxWFQBuffMan: public mux
 
       tim_typ spacTime; // the central WFQ variable "Spacing Time"
       wfqpar **partab;	// per VC a data structure
-      uqueue sortq;  	// the output sort queue
+      pqueue<data> sortq;  	// the output sort queue
       int *qLenVCI;  // per VC: input queue length
 
       enum {spacTimeMax = 100000000}; // when to reset spacTime
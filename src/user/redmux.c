@@ -176,7 +176,10 @@ void muxRED::late(event*)
    inp_ptr = inp_buff;
 
    if (q.getlen() != 0)
+   {
 	   alarme( &std_evt, 1);
+	   wakel( &event_each);
+   }
 
 } // late()
 
@@ -367,7 +367,7 @@ void tcpiplfnsend::early(event *evt)
 	 {
 	    if (doLogRetr)
 	       fprintf(stderr, "# %s: end of transmission because of 12 failed "
-	          "retransmissions of segment with seq=%d, SimTime=%d\n",
+	          "retransmissions of segment with seq=%d, SimTime=" TIM_FMT "\n",
 		  name, nxt, SimTime);
 	    aborted = TRUE;		// means that the connection is closed
 	    unalarme(&slowtimo);
@@ -503,7 +503,7 @@ rec_typ	tcpiplfnsend::REC(data *pd,int key)
       if (received_bytes > received_bytes + pf->frameLen + wnd_max)
       {
       	 fprintf(stderr, "%s: end of transmission because of sequence number"
-	    "overflow, received_bytes=%d, SimTime=%d\n",
+	    "overflow, received_bytes=%d, SimTime=" TIM_FMT "\n",
 	    name, received_bytes, SimTime);
 	 prec_state = StopSend;
 	 EndSend = TRUE;   // means that no data from input DATA is excepted
@@ -612,7 +612,7 @@ void tcpiplfnsend::process_ack(tcpAck *pa)
 	    int	win;
 
 	    if (doLogRetr)
-      	       printf("# %s at %d: fast retransmission\n", name, SimTime);
+      	       printf("# %s at " TIM_FMT ": fast retransmission\n", name, SimTime);
 
 	    old_next = nxt;	// store old nxt
 
@@ -677,7 +677,7 @@ void tcpiplfnsend::process_ack(tcpAck *pa)
       if (doFastRetr && dupacks >= rexmtthresh && cwnd > ssthresh)	
       {	// first nonduplicate ACK -> fast recovery is complete
 	 if (doLogRetr)
-	    printf("# %s at %d: FROK\n", name, SimTime);
+	    printf("# %s at " TIM_FMT ": FROK\n", name, SimTime);
 	 cwnd = ssthresh;  // if cwnd exceeds ssthresh set it back
 	 cwnd = limit_cwnd(cwnd);
 	 cwnd_d = (double) cwnd;
@@ -253,7 +253,7 @@ void tickctrl::early(event *)
    // send the item now
    if(pd != NULL) {
       chkStartStop(send_state = sucs[SucData]->rec(pd, shands[SucData]));
-      if (++counter == 0)
+      if (CNT_OVERFLOW( ++counter))
          errm1s("%s: overflow of counter", name); 
    } else
       errm1s("%s: alarmed, but no data in queue", name); 
@@ -147,7 +147,7 @@ void	vbrframe::init(void)
 
 void	vbrframe::early(event *)
 {
-	if ( ++counter == 0)
+	if ( CNT_OVERFLOW( ++counter))
 		errm1s("%s: overflow of departs", name);
 	
 	if (len_dist == 1)	//take next value for LEN
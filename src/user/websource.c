@@ -157,7 +157,7 @@ void websrc::early(event	*)
    if(framelen <= 0)
       framelen = 1;
    
-   if ( ++counter == 0)
+   if ( CNT_OVERFLOW( ++counter))
       errm1s("%s: overflow of counter", name);
 
    sucs[SucData]->rec(new frame(framelen, vci), shands[SucData]);
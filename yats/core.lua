@@ -266,6 +266,16 @@ function sim:resetTime()
 end
 sim.ResetTime = sim.resetTime
 
+------------------------------------------------------------------------------
+-- Get the width of the simulation clock.
+-- With a 64 bit clock (kernel compiled with TIME64), the clock never wraps
+-- around and long runs need no sim:resetTime().
+-- @return number - 32 or 64.
+------------------------------------------------------------------------------
+function sim:getClockBits()
+  return _sim:GetClockBits()
+end
+
 sim._SetSlotLength = sim.SetSlotLength
 
 function sim:setSlotLength(sl)
@@ -291,18 +301,470 @@ function time2slot(t)
   return t / SlotLength
 end
 
+local evtmanagers = {calendar = EVT_CALENDAR, wheel = EVT_WHEEL}
+
+------------------------------------------------------------------------------
+-- Select the event manager backend.
+-- "calendar" is the classic static calendar of TIME_LEN slots. "wheel" adds a
+-- hierarchical timing wheel for events scheduled TIME_LEN or more slots ahead,
+-- which are then no longer re-scanned in every calendar revolution.
+-- Pending events are moved to the new backend.
+-- @param mode string - "calendar" or "wheel".
+-- @return none.
+------------------------------------------------------------------------------
+function sim:setEventManager(mode)
+  local m = evtmanagers[mode]
+  assert(m, string.format("unknown event manager '%s'", tostring(mode)))
+  _sim:SetEventManager(m)
+end
+
+------------------------------------------------------------------------------
+-- Get the current event manager backend.
+-- @return string - "calendar" or "wheel".
+------------------------------------------------------------------------------
+function sim:getEventManager()
+  local m = _sim:GetEventManager()
+  for k, v in pairs(evtmanagers) do
+    if v == m then return k end
+  end
+end
+
+------------------------------------------------------------------------------
+-- Enable or disable skipping of empty slots.
+-- While no object is registered for activation in each slot (eache/eachl),
+-- the simulator jumps directly to the next slot with pending events.
+-- Skipping is disabled by default. It does not change simulation results.
+-- @param on boolean - true: skip empty slots.
+-- @return none.
+------------------------------------------------------------------------------
+function sim:setSlotSkip(on)
+  if on == false or on == 0 then
+    _sim:SetSlotSkip(0)
+  else
+    _sim:SetSlotSkip(1)
+  end
+end
+
+------------------------------------------------------------------------------
+-- Get state of empty slot skipping.
+-- @return boolean - true if empty slots are skipped.
+------------------------------------------------------------------------------
+function sim:getSlotSkip()
+  return _sim:GetSlotSkip() ~= 0
+end
+
+------------------------------------------------------------------------------
+-- Get the number of activations (early() and late() calls) since the
+-- start of the program. The difference over a run divided by its duration
+-- gives the events per second, see examples/bench.lua.
+-- @return number - number of activations.
+------------------------------------------------------------------------------
+function sim:getEventCount()
+  return _sim:GetEventCount()
+end
+
+------------------------------------------------------------------------------
+-- Enable or disable the per-object profiler.
+-- While enabled, the kernel counts the activations of each object and
+-- measures the processor cycles spent in it. The cycles of the kernel
+-- itself are charged to the simulator ("sim").
+-- @param on boolean - true to enable the profiler.
+-- @return none.
+------------------------------------------------------------------------------
+function sim:setProfile(on)
+  if on then
+    _sim:SetProfile(1)
+  else
+    _sim:SetProfile(0)
+  end
+end
+
+------------------------------------------------------------------------------
+-- Get state of the per-object profiler.
+-- @return boolean - true if the profiler is enabled.
+------------------------------------------------------------------------------
+function sim:getProfile()
+  return _sim:GetProfile() ~= 0
+end
+
+local profile_sortkeys = {
+  cycles = true, events = true, early = true, late = true, rec = true, name = true
+}
+
+------------------------------------------------------------------------------
+-- Get the results of the per-object profiler.
+-- Calls of rec() are only counted, if the kernel has been compiled with
+-- OBJECT_PROFILE.
+-- @param param table - Parameters (all optional)
+-- <ul>
+-- <li> byclass: true to accumulate the results per class.
+-- <li> sort: "cycles" (default), "events", "early", "late", "rec" or "name".
+-- <li> csv: name of a file to write the results as CSV.
+-- <li> reset: true to clear the profiling data afterwards.
+-- </ul>
+-- @return table - List of {name, class, early, late, rec, cycles, share},
+-- sorted in descending order. share is the fraction of all cycles.
+------------------------------------------------------------------------------
+function sim:profile(param)
+  param = param or {}
+  local sortkey = param.sort or "cycles"
+  assert(profile_sortkeys[sortkey], "profile: unknown sort key '"..tostring(sortkey)..
+	 "', valid: cycles, events, early, late, rec, name.")
+  local objs = {{name = "sim", clname = "kernel", obj = _sim}}
+  for name, obj in pairs(self.objectlist) do
+    table.insert(objs, {name = name, clname = obj.clname or "?", obj = obj})
+  end
+  local list, classes, total = {}, {}, 0
+  for _, v in ipairs(objs) do
+    local e = {
+      name = v.name, class = v.clname,
+      early = _sim:GetProfileData(v.obj, PROF_EARLY),
+      late = _sim:GetProfileData(v.obj, PROF_LATE),
+      rec = _sim:GetProfileData(v.obj, PROF_REC),
+      cycles = _sim:GetProfileData(v.obj, PROF_CYCLES)
+    }
+    total = total + e.cycles
+    if param.byclass then
+      local c = classes[e.class]
+      if not c then
+	c = {name = e.class, class = e.class, early = 0, late = 0, rec = 0, cycles = 0}
+	classes[e.class] = c
+	table.insert(list, c)
+      end
+      c.early = c.early + e.early
+      c.late = c.late + e.late
+      c.rec = c.rec + e.rec
+      c.cycles = c.cycles + e.cycles
+    else
+      table.insert(list, e)
+    end
+    if param.reset then
+      _sim:ResetProfile(v.obj)
+    end
+  end
+  for _, e in ipairs(list) do
+    e.share = (total > 0 and e.cycles / total) or 0
+  end
+  if sortkey == "name" then
+    table.sort(list, function(a, b) return a.name < b.name end)
+  elseif sortkey == "events" then
+    table.sort(list, function(a, b)
+		       return a.early + a.late > b.early + b.late
+		     end)
+  else
+    table.sort(list, function(a, b) return a[sortkey] > b[sortkey] end)
+  end
+  if param.csv then
+    local fout = assert(io.open(param.csv, "w+"))
+    fout:write("name,class,early,late,rec,cycles,share\n")
+    for _, e in ipairs(list) do
+      fout:write(string.format("%s,%s,%.0f,%.0f,%.0f,%.0f,%.6f\n",
+			       e.name, e.class, e.early, e.late, e.rec, e.cycles, e.share))
+    end
+    fout:close()
+  end
+  return list
+end
+
+------------------------------------------------------------------------------
+-- Get the statistics of the memory pools of the data classes.
+-- Data objects (cells, frames, ...) are taken from per class pools, which
+-- grow in chunks of objects.
+-- @param reset boolean - true to reset the high water marks afterwards.
+-- @return table - Table indexed by class name, each entry is a table
+-- {inuse, hiwat, chunks, bytes}. Only classes with a pool are included.
+------------------------------------------------------------------------------
+function sim:poolStats(reset)
+  local stats = {}
+  local t = 0
+  while true do
+    local name = _sim:GetPoolName(t)
+    if not name then break end
+    if _sim:GetPoolStat(t, POOL_HIWAT) > 0 or _sim:GetPoolStat(t, POOL_CHUNKS) > 0 then
+      stats[name] = {
+	inuse = _sim:GetPoolStat(t, POOL_INUSE),
+	hiwat = _sim:GetPoolStat(t, POOL_HIWAT),
+	chunks = _sim:GetPoolStat(t, POOL_CHUNKS),
+	bytes = _sim:GetPoolStat(t, POOL_BYTES)
+      }
+    end
+    t = t + 1
+  end
+  if reset then
+    _sim:ResetPoolStat()
+  end
+  return stats
+end
+
+------------------------------------------------------------------------------
+-- Return the memory of all data pools without objects in use to the system.
+-- Called by sim:reset().
+-- @return number - Number of bytes released.
+------------------------------------------------------------------------------
+function sim:releasePools()
+  return _sim:ReleasePools()
+end
+
+------------------------------------------------------------------------------
+-- Back new chunks of the data pools with transparent huge pages (Linux only).
+-- Reduces TLB misses of simulations with many data objects in flight.
+-- @param on boolean - true to use huge pages.
+-- @return none.
+------------------------------------------------------------------------------
+function sim:setPoolHugepages(on)
+  if on then
+    _sim:SetPoolHugepages(1)
+  else
+    _sim:SetPoolHugepages(0)
+  end
+end
+
+------------------------------------------------------------------------------
+-- Distribute the objects over several threads (parallel simulation).
+-- Requires a kernel compiled with PDES and the random generator "xoshiro".
+-- Objects connected by data paths stay in the same partition. The paths are
+-- only cut in front of line objects, the smallest delay of these lines is the
+-- lookahead: the threads synchronise every lookahead slots. The groups of
+-- connected objects are assigned to the partitions by their number of objects.
+-- Lua objects and objects without connections (displays, controls, ...) are
+-- put into partition 0, which is run by the main thread.
+-- The results are reproducible for the same seed and the same number of jobs,
+-- but differ from the sequential run (the order of activations within a slot
+-- changes). Objects coupled otherwise than by data paths must be kept together
+-- with the parameter 'together'.
+-- sim:reset() returns to sequential simulation.
+-- @param param table - Parameter list
+-- <ul>
+-- <li> jobs<br>
+--    Number of partitions (threads); 1 turns parallel simulation off.
+-- <li> together (optional)<br>
+--    List of lists of object names to be put into the same partition, e.g.
+--    <code>{{"ctrl", "src1"}}</code>.
+-- </ul>
+-- @return number, number - Number of partitions and lookahead in slots (0: unlimited).
+------------------------------------------------------------------------------
+function sim:setPartitions(param)
+  local jobs = param.jobs or 1
+  local maxjobs = _sim:GetMaxPartitions()
+  if jobs > 1 and maxjobs == 1 then
+    log:warn("sim:setPartitions(): kernel compiled without PDES, simulating sequentially")
+    jobs = 1
+  end
+  assert(jobs >= 1 and jobs <= maxjobs,
+	 string.format("sim:setPartitions(): jobs must be 1 ... %d", maxjobs))
+  if not self.connected then
+    self:connect()
+  end
+
+  -- groups of connected objects: union-find by object name
+  local up, names = {}, {}
+  local function find(n)
+    while up[n] ~= n do
+      up[n] = up[up[n]]
+      n = up[n]
+    end
+    return n
+  end
+  local function union(a, b)
+    a, b = find(a), find(b)
+    if a < b then up[b] = a elseif b < a then up[a] = b end
+  end
+  for name, obj in pairs(self.objectlist) do
+    up[name] = name
+    table.insert(names, name)
+  end
+  table.sort(names)
+  local linked, cuts = {}, {}
+  for _, name in ipairs(names) do
+    for _, v in self.objectlist[name]:successors() do
+      local suc = v.suc and self.objectlist[v.suc.name]
+      if suc then
+	linked[name], linked[suc.name] = true, true
+	if suc.clname == "line" then
+	  table.insert(cuts, {from = name, line = suc})
+	else
+	  union(name, suc.name)
+	end
+      end
+    end
+  end
+  for _, t in ipairs(param.together or {}) do
+    for i = 2, #t do
+      assert(up[t[1]] and up[t[i]], "sim:setPartitions(): unknown object in 'together'")
+      union(t[1], t[i])
+    end
+  end
+
+  -- size of each group; Lua objects and isolated objects fix their group to 0
+  local luatypes = {lua1out = true, luaxout = true}
+  local groups, size, fixed = {}, {}, {}
+  for _, name in ipairs(names) do
+    local g = find(name)
+    if not size[g] then
+      size[g] = 0
+      table.insert(groups, g)
+    end
+    size[g] = size[g] + 1
+    local obj = self.objectlist[name]
+    if luatypes[tolua.type(obj)] or not linked[name] then
+      fixed[g] = true
+    end
+  end
+  table.sort(groups, function(a, b)
+    if size[a] ~= size[b] then return size[a] > size[b] end
+    return a < b
+  end)
+
+  -- assign the groups, the largest first, to the partition with least objects
+  local n = math.min(jobs, #groups)
+  if n < 1 then n = 1 end
+  local load, part = {}, {}
+  for i = 1, n do load[i] = 0 end
+  for _, g in ipairs(groups) do
+    if fixed[g] then
+      part[g] = 0
+      load[1] = load[1] + size[g]
+    end
+  end
+  for _, g in ipairs(groups) do
+    if not fixed[g] then
+      local best = 1
+      for i = 2, n do
+	if load[i] < load[best] then best = i end
+      end
+      part[g] = best - 1
+      load[best] = load[best] + size[g]
+    end
+  end
+  for _, name in ipairs(names) do
+    self.objectlist[name].lp = part[find(name)]
+  end
+
+  -- lookahead: smallest delay of the lines between partitions
+  local lookahead = 0
+  for _, c in ipairs(cuts) do
+    if self.objectlist[c.from].lp ~= c.line.lp then
+      if lookahead == 0 or c.line.delay < lookahead then
+	lookahead = c.line.delay
+      end
+    end
+  end
+  _sim:SetPartitions(n, lookahead)
+  return n, lookahead
+end
+
+------------------------------------------------------------------------------
+-- Get the number of partitions (threads) of the simulation.
+-- @return number - 1 for sequential simulation.
+------------------------------------------------------------------------------
+function sim:getPartitions()
+  return _sim:GetPartitions()
+end
+
 sim._SetRand = sim.SetRand
 
+-- Offset added to all seeds (see sim:setSeedOffset).
+local seedoffset = 0
+-- Seeds passed to the generator, in order (see sim:getSeeds).
+local seedsused = {}
+
+local function setseed(n)
+  table.insert(seedsused, n + seedoffset)
+  return _sim:_SetRand(n + seedoffset)
+end
+
 ------------------------------------------------------------------------------
 -- Set the seed value for yats random number generator.
 -- @param n number - seed value.
 ------------------------------------------------------------------------------
 function sim:setRand(n) 
-  _sim:_SetRand(n) 
+  setseed(n)
 end
 sim.SetRand = sim.setRand
 sim.setrand = sim.SetRand
 
+local randgens = {legacy = RAND_LEGACY, xoshiro = RAND_XOSHIRO}
+
+------------------------------------------------------------------------------
+-- Select the random number generator.
+-- "legacy" is the 15 bit LCG shared by all objects; it reproduces results of
+-- earlier versions bit by bit. "xoshiro" is the 64 bit generator xoshiro256**
+-- with an independent stream per object. The streams are derived from the
+-- seed in the order of object creation. A stream is used in early() and
+-- late() of its object. Objects drawing random numbers in rec() (e.g.
+-- tcpiprec, tcpipsend, lossclp1, aal5sred) select their own stream there
+-- with a randscope (see defs.h); an object without one draws from the
+-- stream of its sender. Select the generator before
+-- sim:setRand() and before objects are created.
+-- @param gen string - "legacy" (default) or "xoshiro".
+-- @return none.
+------------------------------------------------------------------------------
+function sim:setRandGen(gen)
+  local g = randgens[gen]
+  assert(g, string.format("unknown random number generator '%s'", tostring(gen)))
+  _sim:SetRandGen(g)
+end
+
+------------------------------------------------------------------------------
+-- Get the random number generator.
+-- @return string - "legacy" or "xoshiro".
+------------------------------------------------------------------------------
+function sim:getRandGen()
+  local gen = _sim:GetRandGen()
+  for k, v in pairs(randgens) do
+    if v == gen then return k end
+  end
+end
+
+local randkeys = {order = RAND_BYORDER, name = RAND_BYNAME}
+
+------------------------------------------------------------------------------
+-- Select how the streams of the objects are derived from the seed
+-- (generator "xoshiro" only).
+-- "order" derives them in the order of object creation. "name" seeds the
+-- stream of each object from the seed and its name, so that an object gets
+-- the same random numbers, whatever other objects exist. This synchronises
+-- the streams of runs with different parameters (common random numbers).
+-- It needs explicit names for the objects which draw random numbers: the
+-- names autoname() gives ("autoobj1", ...) depend on the order of creation.
+-- @param key string - "order" (default) or "name".
+-- @return none.
+------------------------------------------------------------------------------
+function sim:setRandStreams(key)
+  local k = randkeys[key]
+  assert(k, string.format("unknown derivation of random streams '%s'", tostring(key)))
+  _sim:SetRandKey(k)
+end
+
+------------------------------------------------------------------------------
+-- Get the derivation of the random streams.
+-- @return string - "order" or "name".
+------------------------------------------------------------------------------
+function sim:getRandStreams()
+  local key = _sim:GetRandKey()
+  for k, v in pairs(randkeys) do
+    if v == key then return k end
+  end
+end
+
+------------------------------------------------------------------------------
+-- Set an offset which is added to all seed values.
+-- Used by parallel replications: each replication uses a different offset,
+-- such that seeds set by the script itself remain distinct.
+-- @param k number - seed offset (default: 0).
+------------------------------------------------------------------------------
+function sim:setSeedOffset(k)
+  seedoffset = k or 0
+end
+
+------------------------------------------------------------------------------
+-- Get the seeds passed to the generator so far, the seed offset included.
+-- @return table - List of seeds in the order of sim:setRand() calls.
+------------------------------------------------------------------------------
+function sim:getSeeds()
+  return seedsused
+end
+
 sim._GetRand = sim.GetRand
 ------------------------------------------------------------------------------
 -- Generate a random number
@@ -320,7 +782,7 @@ sim.GetRand = sim.getRand
 -- @return none.
 ------------------------------------------------------------------------------
 function randomseed(n)
-  return _sim:_SetRand(n)
+  return setseed(n)
 end
 
 ------------------------------------------------------------------------------
@@ -433,6 +895,8 @@ function sim:run(slots, dots)
    if not self.connected then
       self:connect()
    end
+   -- the dispatch functions of Lua objects may have been redefined
+   refresh_callbacks()
    while curslot < slots do
       local delta = yats.deltaSlot
       _sim:_run(delta, dots)
@@ -505,6 +969,8 @@ function sim:reset(no_flush)
       self:flushEvents(true)
    end
    self:pushgarbage()
+   self:releasePools()
+   _sim:SetPartitions(1, 0)
 end
 
 ------------------------------------------------------------------------------
@@ -588,6 +1054,42 @@ function nc()
 end
 _G.nc = nc
 
+------------------------------------------------------------------------------
+-- Create the writer of a binary trace for the parameter 'trace' of an
+-- object. The object deletes the writer.
+-- The codecs "lz4" and "zstd" must be compiled in (see src/kernel/tracewr.h).
+-- @param spec string or table - File name, or {file = "name", codec = "raw"
+-- | "lz4" | "zstd"}.
+-- @return userdata - tracewr object.
+------------------------------------------------------------------------------
+function tracewriter(spec)
+  local codecs = {raw = TRACE_RAW, lz4 = TRACE_LZ4, zstd = TRACE_ZSTD}
+  local file, codec = spec, "raw"
+  if type(spec) == "table" then
+    file, codec = spec.file, spec.codec or "raw"
+  end
+  assert(type(file) == "string", "trace: file name required.")
+  assert(codecs[codec], "trace: unknown codec '"..tostring(codec).."'.")
+  return tracewr:new(file, codecs[codec])
+end
+
+------------------------------------------------------------------------------
+-- Iterate over the records of a binary trace.
+-- Usage: <code>for r in tracerecords("delay.trc") do ... end</code>
+-- @param fname string - Name of the trace file.
+-- @return function - Iterator returning a table per record: time, delay,
+-- vci, len, kind (TREC_ARRIVAL, TREC_DELAY, TREC_PDU, TREC_SDU).
+------------------------------------------------------------------------------
+function tracerecords(fname)
+  local rd = tracerd:new_local(fname)
+  return function()
+    if rd:read() ~= 0 then
+      return {time = rd.time, delay = rd.delay, vci = rd.vci, len = rd.len,
+	      kind = rd.kind}
+    end
+  end
+end
+
 --==========================================================================
 -- Root Class: This the mother of all network objects in the Lua layer.
 --==========================================================================
@@ -621,6 +1123,11 @@ function root:finish()
     self._title = self.title
   end
 
+  -- Streams keyed by object names need the name (see sim:setRandStreams())
+  if type(self) == "userdata" then
+    _sim:NameRand(self)
+  end
+
   -- Act on parameters in yats object
   if self.act then self:act() else print("act not found for "..self.name) end
     
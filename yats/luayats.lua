@@ -78,10 +78,25 @@ Available options are:
 -l, --luadoc=docdir     generate Luadoc HTML anchor data base (default: doc/lua/files/yats).
 -o, --out=FILE          write output to file instead of stdout.
 -R, --read=FILE         read Luadoc HTML anchor data base
+-N, --replicas=N        run N independent replications of one script in
+                        parallel (non-GUI mode only). The report of the
+                        replications is written to --report=FILE.
+-O, --report=FILE       write the report of replications or of a sweep to
+                        FILE (as Lua table).
+-j, --jobs=N            max. number of parallel replications (default: N).
+-s, --seed=SEED         seed of first replication (default: 1).
+-G, --grid=SPEC         run one script over a parameter grid in parallel
+                        (non-GUI mode only), SPEC: "name=v1,v2,...;name2=...".
+                        The script reads the values by yats.sweep.param().
+                        --replicas, --jobs, --seed and --report apply per sweep;
+                        all grid points use common random numbers.
 
 Notes:
  (1) When running in non-GUI mode, hit <ctrl-C> twice to stop execution.
  (2) The simulator is NOT reset in non-GUI mode.
+ (3) Replication i shifts all seeds set by the script by i-1.
+ (4) A sweep selects the generator "xoshiro" with streams keyed by object
+     names (see sim:setRandStreams()).
 ]]
 end
 
@@ -95,6 +110,56 @@ local function version()
    eprint("svn version $Id:")
 end
 
+-----------------------------------------------------------------------------
+-- Run a user script w/o GUI.
+-- Returns exit value and the script's return value.
+-----------------------------------------------------------------------------
+local function runscript(fname)
+   local success, retval
+   local fn, err = io.open(fname,"r")
+   if not fn then
+      log:error(string.format("Cannot open file %q.", fname))
+      eprint(string.format("Cannot open file %q.", fname))
+      return 1
+   end
+   local s = fn:read("*a")
+   fn:close()
+   local worker = gui.initSimulation(s, true)
+   gui.resetSimulation()
+   log:info("Simulation started without GUI support. File: "..fname)
+   eprint("Simulation started without GUI support. File: "..fname)
+   while true do
+      success, retval = pcall(worker)
+      if success == true then
+	 if retval == "done" then
+	    -- continue after complete run
+	 elseif retval == "continue" then
+	    -- continue after partial run
+	 elseif retval == "reset" then
+	    -- command: reset
+	 elseif retval == "pause" then
+	    -- command: pause
+	    iup.Message("Information", "Script paused!\nHit ok to continue.")
+	 else
+	    -- script finished
+	    return 0, retval
+	 end
+      else
+	 if string.find(retval, "__ABORTED") then
+	    -- Test was aborted externally
+	    log:info("Simulation aborted.")
+	    os.exit(0)
+	 else
+	    -- A run-time error occurred - display error message
+	    eprint("Simulation aborted with runtime error.")
+	    eprint("%s", retval)
+	    eprint("%s", debug.traceback())
+	    os.exit(1)
+	 end
+      end
+   end
+end
+
 -----------------------------------------------------------------------------
 -- MAIN entry - Lua level
 -----------------------------------------------------------------------------
@@ -113,11 +178,17 @@ local function main(arg)
       {"luadoc", "o", "-l"},
       {"read", "r", "-R"},
       {"out", "r", "-o"},
+      {"report", "r", "-O"},
+      {"replicas", "r", "-N"},
+      {"jobs", "r", "-j"},
+      {"seed", "r", "-s"},
+      {"grid", "r", "-G"},
       {"zzz", "r", "-z"}
    }
-   local opts, pargs, err = getopt.getopt(arg, "d:i:no:rvz:R:lL:DH", longopts, 1)
+   local opts, pargs, err = getopt.getopt(arg, "d:i:no:O:rvz:R:lL:DHN:j:s:G:", longopts, 1)
    _G._PROGRAMARGS = pargs
    local luadoc, outfile
+   local replicas, jobs, seed, reportname, grid
    local tagfile = "doc/cpp/luayats.xml"
    local docdir = "doc/lua/files/yats"
    local luadocfile = "doc/ldocindex.lua"
@@ -145,6 +216,16 @@ local function main(arg)
 	 cmd = "info"
       elseif opt.sopt == "-o" then
 	 fout = io.open(opt.arg, "w+")
+      elseif opt.sopt == "-O" then
+	 reportname = opt.arg
+      elseif opt.sopt == "-N" then
+	 replicas = tonumber(opt.arg)
+      elseif opt.sopt == "-j" then
+	 jobs = tonumber(opt.arg)
+      elseif opt.sopt == "-s" then
+	 seed = tonumber(opt.arg)
+      elseif opt.sopt == "-G" then
+	 grid = opt.arg
       elseif opt.sopt == "-d" then
 	 if opt.arg then tagfile = opt.arg end
 	 cmd = "htmldoc"
@@ -207,50 +288,32 @@ local function main(arg)
    else
       local exitval = 0
       -- Run user scripts w/o GUI - graphics output still usable
+      if grid then
+	 if #pargs ~= 1 then
+	    eprint("Exactly one script required for a sweep.")
+	    os.exit(1)
+	 end
+	 require "yats.sweep"
+	 local report, status = yats.sweep.run{
+	    script = pargs[1], runner = runscript, grid = yats.sweep.parse(grid),
+	    replicas = replicas, jobs = jobs, seed = seed, out = reportname
+	 }
+	 os.exit(status)
+      end
+      if replicas then
+	 if #pargs ~= 1 then
+	    eprint("Exactly one script required for replications.")
+	    os.exit(1)
+	 end
+	 require "yats.replica"
+	 os.exit(yats.replica.run{
+		    script = pargs[1], runner = runscript, replicas = replicas,
+		    jobs = jobs, seed = seed, out = reportname
+		 })
+      end
       for i = 1, #pargs do
-	 local success, retval
-	 local fn, err = io.open(pargs[i],"r")
-	 if not fn then
-	    log:error(string.format("Cannot open file %q.", pargs[i]))
-	    eprint(string.format("Cannot open file %q.", pargs[i]))
+	 if runscript(pargs[i]) ~= 0 then
 	    exitval = 1
-	 else
-	    local s = fn:read("*a")
-	    fn:close()
-	    local worker = gui.initSimulation(s, true)
-	    gui.resetSimulation()
-	    log:info("Simulation started without GUI support. File: "..pargs[i])
-	    eprint("Simulation started without GUI support. File: "..pargs[i])
-	    while true do
-	       success, retval = pcall(worker)
-	       if success == true then
-		  if retval == "done" then
-		     -- continue after complete run
-		  elseif retval == "continue" then
-		     -- continue after partial run
-		  elseif retval == "reset" then
-		     -- command: reset
-		  elseif retval == "pause" then
-		     -- command: pause
-		     iup.Message("Information", "Script paused!\nHit ok to continue.")
-		  else
-		     -- script finished
-		     break
-		  end
-	       else
-		  if string.find(retval, "__ABORTED") then
-		     -- Test was aborted externally
-		     log:info("Simulation aborted.")
-		     os.exit(exitval)
-		  else
-		     -- A run-time error occurred - display error message
-		     eprint("Simulation aborted with runtime error.")
-		     eprint("%s", retval)
-		     eprint("%s", debug.traceback())
-		     os.exit(1)
-		  end
-	       end
-	    end
 	 end
       end
       log:info("Simulation finished without GUI support.")
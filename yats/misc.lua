@@ -95,6 +95,49 @@ function sink:init(param)
   return self:finish()
 end
 
+--==========================================================================
+-- SINKTRACE: Sink with a trace of inter-arrival times.
+--==========================================================================
+
+_sinktrace = sinktrace
+--- Definition of class 'sinktrace'.
+sinktrace = class(_sinktrace)
+
+--- Constructor for class 'sinktrace'.
+-- A sink which writes the inter-arrival time of every data item to a
+-- trace: an ASCII file with one IAT per line, or a binary trace of
+-- TREC_ARRIVAL records with the VCI of cells and the length of frames.
+-- @param param table - Parameter list
+-- <ul>
+-- <li> name (optional)<br>
+--    Name of the display. Default: "objNN"
+-- <li> file (optional)<br>
+--    Name of the ASCII trace file.
+-- <li> trace (optional)<br>
+--    Binary trace: file name, or {file = "name", codec = "raw" | "lz4" |
+--    "zstd"}. See tracewriter() and tracerecords(). Either 'file' or
+--    'trace' is required.
+-- </ul>
+-- @return table - Reference to object instance.
+function sinktrace:init(param)
+  self = _sinktrace:new()
+  self.name = autoname(param)
+  self.clname = "sinktrace"
+  self.parameters = {
+    file = false, trace = false
+  }
+  self:adjust(param)
+  assert((param.file ~= nil) ~= (param.trace ~= nil),
+	 "sinktrace: either parameter 'file' or 'trace' required.")
+  if param.trace then
+    self.trace = tracewriter(param.trace)
+  else
+    self:setFile(param.file)
+  end
+  self:definp(self.clname)
+  return self:finish()
+end
+
 --==========================================================================
 -- Dummy Object
 --==========================================================================
@@ -134,8 +177,20 @@ _meas = meas
 --- Definition of 'meas' object.
 meas = class(_meas)
 
+-- Relative precision of a log-linear histogram (parameter 'hist').
+local function histprec(hist)
+  if not hist then
+    return 0
+  elseif hist == true then
+    return 0.01
+  end
+  assert(type(hist) == "number" and hist > 0 and hist < 1,
+	 "relative precision 'hist' must be between 0 and 1.")
+  return hist
+end
+
 --- Constructor for class 'meas'.
--- @usage ref = yats.meas:new{[name=]"objname",vci=N,maxtim=N,out={"next", "pin"}}]].
+-- @usage ref = yats.meas:new{[name=]"objname",vci=N,maxtim=N,[hist=D,][trace="file",]out={"next", "pin"}}]].
 -- A measurement class for cell count and cell transfer delay.
 -- @param param table - Parameter table
 -- <ul>
@@ -145,6 +200,14 @@ meas = class(_meas)
 --    vci to measure. 
 -- <li> maxtim<br>
 --    Max. delay awaited (required to build a histogram). 
+--    May be 0, if 'hist' is given.
+-- <li> hist (optional)<br>
+--    Relative precision of a log-linear histogram of all delays, e.g. 0.01
+--    (true: 0.01). Its memory does not depend on the delays.
+--    See meas:getQuantile().
+-- <li> trace (optional)<br>
+--    Write all delays to a binary trace: file name, or {file = "name",
+--    codec = "raw" | "lz4" | "zstd"}. See tracewriter() and tracerecords().
 -- <li> out<br>
 --    Connection to successor.<br>
 --    Format: <code>{"name-of-successor", "input-pin-of-successor"}</code>.
@@ -156,18 +219,31 @@ function meas:init(param)
   self.name = autoname(param)
   self.clname = "meas"
   self.parameters = {
-    vci = true, maxtim = true, out = true
+    vci = true, maxtim = false, hist = false, trace = false, out = true
   }
   self:adjust(param)
   self:definp(self.clname)
   self:defout(param.out)
-  assert(param.maxtim > 0, "meas: maxtim > 0 required.")
-  self.maxtim = param.maxtim 
+  self.hist_prec = histprec(param.hist)
+  assert((param.maxtim or 0) > 0 or self.hist_prec > 0, "meas: maxtim > 0 or hist required.")
+  self.maxtim = param.maxtim or 0
   assert(param.vci, "meas: parameter 'vci' required.")
   self.vci = param.vci
+  if param.trace then
+    self.trace = tracewriter(param.trace)
+  end
   return self:finish()
 end
 
+--- Get a quantile of the transfer delays.
+-- Requires parameter 'hist'.
+-- @param q number - Quantile, e.g. 0.99.
+-- @return number - Delay in slots.
+function meas:getQuantile(q)
+  assert(self.hist, self.name..": no histogram (parameter 'hist').")
+  return self.hist:quantile(q)
+end
+
 --==========================================================================
 -- Meas2 Object
 --==========================================================================
@@ -184,8 +260,13 @@ meas2 = class(_meas2)
 --    Name of the display. Default: "objNN". 
 -- <li> vci<br>
 --    vci to measure. 
--- <li> maxtim<br>
---    Max. delay awaited (required to build a histogram). 
+-- <li> maxctd, maxiat<br>
+--    Max. delay and inter arrival time awaited (required to build a histogram). 
+--    May be 0, if 'hist' is given.
+-- <li> hist (optional)<br>
+--    Relative precision of log-linear histograms of all delays and inter
+--    arrival times, e.g. 0.01 (true: 0.01).
+--    See meas2:getCTDQuantile() and meas2:getIATQuantile().
 -- <li> out<br>
 --    Connection to successor. 
 --    Format: {"name-of-successor", "input-pin-of-successor"}.
@@ -197,13 +278,14 @@ function meas2:init(param)
   self.name = autoname(param)
   self.clname = "meas2"
   self.parameters = {
-    maxctd = true, maxiat = true, vci = false, out = true
+    maxctd = false, maxiat = false, vci = false, hist = false, out = true
   }
   self:adjust(param)
-  assert(param.maxctd > 0, self.name..": parameter 'maxctd' > 0 required.")
-  self.ctd_max = param.maxctd + 1
-  assert(param.maxctd > 0, self.name..": parameter 'maxiat' > 0 required.")
-  self.iat_max = param.maxiat + 1
+  self.hist_prec = histprec(param.hist)
+  assert((param.maxctd or 0) > 0 or self.hist_prec > 0, self.name..": parameter 'maxctd' > 0 required.")
+  self.ctd_max = (param.maxctd or -1) + 1
+  assert((param.maxiat or 0) > 0 or self.hist_prec > 0, self.name..": parameter 'maxiat' > 0 required.")
+  self.iat_max = (param.maxiat or -1) + 1
   self.vci = param.vci or -1
   if not param.vci then 
     self.inp_type = DataType
@@ -215,6 +297,24 @@ function meas2:init(param)
   return self:finish()
 end
 
+--- Get a quantile of the transfer delays.
+-- Requires parameter 'hist'.
+-- @param q number - Quantile, e.g. 0.99.
+-- @return number - Delay in slots.
+function meas2:getCTDQuantile(q)
+  assert(self.ctd_hist, self.name..": no histogram (parameter 'hist').")
+  return self.ctd_hist:quantile(q)
+end
+
+--- Get a quantile of the inter arrival times.
+-- Requires parameter 'hist'.
+-- @param q number - Quantile, e.g. 0.99.
+-- @return number - Inter arrival time in slots.
+function meas2:getIATQuantile(q)
+  assert(self.iat_hist, self.name..": no histogram (parameter 'hist').")
+  return self.iat_hist:quantile(q)
+end
+
 --==========================================================================
 -- Meas3 Object
 --==========================================================================
@@ -265,6 +365,10 @@ meas3 = class(_meas3)
 -- <li> erange (optional)
 --    If 'erange' is given: out-of-range cells or frames cause an error. 
 --    Otherwise: only the overall counter is incremented. 
+-- <li> hist (optional)<br>
+--    Relative precision of log-linear histograms of the (unscaled) CTDs and
+--    IATs, e.g. 0.01 (true: 0.01). Only for the values measured ('ctd', 'iat').
+--    See meas3:getCTDQuantile() and meas3:getIATQuantile().
 -- <li> out (optional)
 --    Connection to successor. If omitted, this device is a sink. <br>
 --    Format: <code>{"name-of-successor", "input-pin-of-successor"}</code>.
@@ -283,6 +387,7 @@ function meas3:init(param)
     iat = false,
     iatdiv = false,
     erange = false,
+    hist = false,
     connid = false,
     vci = false,
     out = false
@@ -299,7 +404,7 @@ function meas3:init(param)
   if param.ctd then
     -- ctd is given
     self.doMeanCTD = 1
-    if type(ctd) == "boolean" then
+    if type(param.ctd) == "boolean" then
       -- no range - set defaults
       self.ctd_min = 0
       self.ctd_max = 0
@@ -364,6 +469,7 @@ function meas3:init(param)
     self.idx_max = 1
   end
   self.doRangeError = param.errange or 0
+  self.hist_prec = histprec(param.hist)
   
   -- output is optional
   if param.out then
@@ -373,6 +479,28 @@ function meas3:init(param)
   return self:finish()
 end
 
+--- Get a quantile of the transfer delays of a connection.
+-- Requires parameters 'hist' and 'ctd'.
+-- @param id number - VCI or connection id (0 if neither 'vci' nor 'connid' given).
+-- @param q number - Quantile, e.g. 0.99.
+-- @return number - Delay in slots.
+function meas3:getCTDQuantile(id, q)
+  local h = self:getCTDHist(id - self.idx_min)
+  assert(h, self.name..": no CTD histogram for id "..id..".")
+  return h:quantile(q)
+end
+
+--- Get a quantile of the inter arrival times of a connection.
+-- Requires parameters 'hist' and 'iat'.
+-- @param id number - VCI or connection id (0 if neither 'vci' nor 'connid' given).
+-- @param q number - Quantile, e.g. 0.99.
+-- @return number - Inter arrival time in slots.
+function meas3:getIATQuantile(id, q)
+  local h = self:getIATHist(id - self.idx_min)
+  assert(h, self.name..": no IAT histogram for id "..id..".")
+  return h:quantile(q)
+end
+
 --==========================================================================
 -- Distribution
 --==========================================================================
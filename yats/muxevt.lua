@@ -33,7 +33,6 @@ local function mux_init(self, param)
      assert(param.service > 0, "muxBase: invalid service time: "..(param.service or "nil"))
   end
   self.serviceTime = param.service or 1
-  self.needToSchedule = 1
 
   -- Init output table
   self:defout(param.out)
@@ -271,7 +270,11 @@ muxFrmPrio = class(_muxFrmPrio, muxBase)
 -- In work-conserving mode "async" a frame that hits an empty queue is transmitted immediately.
 -- In non work-conserving mode "sync" the server process is activated strictly synchron in 
 -- fixed time intervals (frame rate scheduling).<br>
--- The multiplexer maintains loss counters per input priority, per priority , per queue and total loss.
+-- The multiplexer maintains loss counters per input priority, per priority , per queue and total loss.<br>
+-- In mode "async", inputs may also be connected to fluid sources (<code>fluidsrc</code>). The fluid
+-- is queued and served analytically with absolute priority; frames get the capacity left over by
+-- the fluid of their own and higher priorities (see <code>getFluidBacklog(prio)</code> and
+-- <code>getFluidRate(prio)</code>).
 -- @param param table - parameter list
 -- <ul>
 -- <li>name (optional))<br>
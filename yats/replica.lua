@@ -0,0 +1,325 @@
+-----------------------------------------------------------------------------------
+-- @copyright GNU Public License.
+-- @author Herbert Leuwer, Backnang.
+-- @release 4.0 $Id$
+-- @description Luayats - Parallel independent replications.
+-- <br>
+-- <br><b>module: yats</b><br>
+-- <br>
+-- Runs N independent replications of one simulation script in parallel worker
+-- processes, each with its own seed for the random number generator. The results
+-- of all replications are gathered and reported as confidence intervals.<br>
+-- The following results are collected from each replication:
+-- <ul>
+-- <li> the mean of each confidence object ('confid'),
+-- <li> the counter and the mean delay of each 'meas' object, and the 99%
+--      quantile of the delay, if the object has a histogram ('hist'),
+-- <li> all numbers in a table returned by the script.
+-- </ul>
+-- Usage from command line:<br>
+-- <code>luayats -n --replicas=16 --jobs=8 [--seed=1] script.lua</code><br>
+-- Within a script, sim:snapshot() and sim:branch() run several measurements
+-- from one warmed-up state.
+-----------------------------------------------------------------------------------
+
+require "yats.statist"
+
+module("yats", yats.seeall)
+
+replica = {}
+
+--- Replication context of the current process. 'nil' in a normal run.
+-- Fields: index, count, seed (set before the script runs) and offset
+-- (added to the seeds the script sets itself, see sim:setSeedOffset()).
+replica.current = nil
+
+------------------------------------------------------------------------------
+-- Collect the results of this replication.
+-- @param retval any - Return value of the script.
+-- @return table - Flat table mapping result names to numbers.
+------------------------------------------------------------------------------
+function replica.collect(retval)
+  local res = {}
+  local seen = {}
+  local function scan(list)
+    for name, obj in pairs(list) do
+      if not seen[name] then
+	seen[name] = true
+	if obj.clname == "confid" then
+	  if obj:getLen() > 0 then
+	    res[name..".mean"] = obj:getMean()
+	  end
+	elseif obj.clname == "meas" then
+	  local n, sum = 0, 0
+	  for i = 0, obj.maxtim - 1 do
+	    local d = obj:getDist(i)
+	    n = n + d
+	    sum = sum + i * d
+	  end
+	  res[name..".count"] = obj:getCounter()
+	  if n > 0 then
+	    res[name..".meandelay"] = sum / n
+	  end
+	  if obj.hist and obj.hist:getCount() > 0 then
+	    res[name..".p99"] = obj.hist:quantile(0.99)
+	  end
+	end
+      end
+    end
+  end
+  scan(sim.objectlist)
+  -- Objects of scripts which reset the simulator are in the garbage.
+  scan(garbage.cur)
+  if type(retval) == "table" then
+    for k, v in pairs(retval) do
+      if type(v) == "number" then
+	res["result["..tostring(k).."]"] = v
+      end
+    end
+  elseif type(retval) == "number" then
+    res["result"] = retval
+  end
+  return res
+end
+
+------------------------------------------------------------------------------
+-- Aggregate the results of all replications.
+-- @param results table - List of tables returned by replica.collect().
+-- @param level number - Confidence level (0.9, 0.95, 0.975 or 0.99).
+-- @return table - List of {name, n, mean, lo, up, width}, sorted by name.
+------------------------------------------------------------------------------
+function replica.aggregate(results, level)
+  local values = {}
+  for _, res in ipairs(results) do
+    for k, v in pairs(res) do
+      values[k] = values[k] or {}
+      table.insert(values[k], v)
+    end
+  end
+  local conf = _confidObj:new_local()
+  local report = {}
+  for k, list in pairs(values) do
+    conf:flush()
+    for _, v in ipairs(list) do
+      conf:add(v)
+    end
+    table.insert(report, {
+		   name = k, n = #list, mean = conf:getMean(),
+		   lo = conf:getLo(level), up = conf:getUp(level),
+		   width = conf:getWidth(level)
+		 })
+  end
+  table.sort(report, function(a, b) return a.name < b.name end)
+  return report
+end
+
+------------------------------------------------------------------------------
+-- Print a report.
+-- @param report table - Report as returned by replica.aggregate().
+-- @param param table - Parameters of the run (see replica.run()).
+-- @return none.
+------------------------------------------------------------------------------
+function replica.print(report, param)
+  printf("Replications: %d of %d successful (%d jobs), seed offsets 0...%d, level %g\n",
+	 param.ok, param.replicas, param.jobs, param.replicas - 1, param.level)
+  if param.seeds then
+    local list = {}
+    for i = 1, param.replicas do
+      local s = param.seeds[i]
+      table.insert(list, string.format("%d: %s", i,
+				       s and table.concat(s, ",") or "-"))
+    end
+    printf("Seeds used: %s\n", table.concat(list, "  "))
+  end
+  printf("%-30s %5s %14s %14s %14s %14s\n", "name", "n", "mean", "lo", "up", "width")
+  for _, v in ipairs(report) do
+    printf("%-30s %5d %14.6g %14.6g %14.6g %14.6g\n",
+	   v.name, v.n, v.mean, v.lo, v.up, v.width)
+  end
+end
+
+------------------------------------------------------------------------------
+-- Run work(index) for index = 1 ... n in worker processes, at most jobs at a
+-- time. work() returns a flat table of numbers (nil on failure), which is
+-- passed back to this process by a temporary file.
+-- @return table, number - List of results (nil for failed workers) and the
+-- number of successful workers.
+------------------------------------------------------------------------------
+local function spawn(n, jobs, work)
+  local running = {}
+  local nrunning, nextidx = 0, 1
+  local results, ok = {}, 0
+  while nextidx <= n or nrunning > 0 do
+    -- Start workers up to the job limit
+    while nextidx <= n and nrunning < jobs do
+      local fname = os.tmpname()
+      local pid = forkproc()
+      assert(pid >= 0, "replica: cannot start worker process")
+      if pid == 0 then
+	-- Worker: do the work and report the results
+	local success, res = pcall(work, nextidx)
+	if not success or type(res) ~= "table" then
+	  exitproc(1)
+	end
+	local fout = io.open(fname, "w+")
+	fout:write("return "..pretty(res).."\n")
+	fout:close()
+	exitproc(0)
+      end
+      running[pid] = {index = nextidx, fname = fname}
+      nrunning = nrunning + 1
+      nextidx = nextidx + 1
+    end
+    -- Wait for the next worker to finish
+    local pid = waitproc()
+    local w = running[pid]
+    if w then
+      running[pid] = nil
+      nrunning = nrunning - 1
+      if procstatus() == 0 then
+	local f = loadfile(w.fname)
+	if f then
+	  results[w.index] = f()
+	  ok = ok + 1
+	end
+      else
+	io.stderr:write(string.format("replica %d failed\n", w.index))
+      end
+      os.remove(w.fname)
+    elseif pid < 0 then
+      break
+    end
+  end
+  return results, ok
+end
+replica.spawn = spawn
+
+------------------------------------------------------------------------------
+-- Run independent replications in parallel worker processes.
+-- The script sees its replication context in <code>yats.replica.current</code>.
+-- Calls of <code>sim:setRand(n)</code> in the script are shifted by the
+-- replication index, so that each replication uses a different seed.
+-- @param param table - Parameters
+-- <ul>
+-- <li> script: name of the script file.
+-- <li> runner: function(fname) running a script, returns exitval, retval.
+-- <li> replicas: number of replications (default: 10).
+-- <li> jobs: max. number of concurrent workers (default: replicas).
+-- <li> seed: seed of the first replication (default: 1).
+-- <li> level: confidence level (default: 0.95).
+-- <li> out: file name for the report as Lua table (optional).
+-- </ul>
+-- @return number - 0 if all replications succeeded, 1 otherwise.
+------------------------------------------------------------------------------
+function replica.run(param)
+  param.replicas = param.replicas or 10
+  param.jobs = math.min(param.jobs or param.replicas, param.replicas)
+  param.seed = param.seed or 1
+  param.level = param.level or 0.95
+  assert(param.jobs > 0, "replica: number of jobs must be > 0")
+  local results
+  results, param.ok = spawn(param.replicas, param.jobs, function(index)
+    -- run the script with its own seed
+    replica.current = {
+      index = index, count = param.replicas, seed = param.seed + index - 1,
+      offset = index - 1
+    }
+    local seeds = sim:getSeeds()
+    local nseeds = table.getn(seeds)	-- set before the fork
+    sim:setSeedOffset(index - 1)
+    sim:setRand(param.seed)
+    local exitval, retval = param.runner(param.script)
+    if exitval ~= 0 then
+      return nil
+    end
+    local used = {}
+    for i = nseeds + 1, table.getn(seeds) do
+      table.insert(used, seeds[i])
+    end
+    return {results = replica.collect(retval), seeds = used}
+  end)
+  local list = {}
+  param.seeds = {}
+  for i = 1, param.replicas do
+    if results[i] then
+      table.insert(list, results[i].results)
+      param.seeds[i] = results[i].seeds
+    end
+  end
+  local report = replica.aggregate(list, param.level)
+  replica.print(report, param)
+  if param.out then
+    local fout = assert(io.open(param.out, "w+"))
+    fout:write("return "..pretty(report).."\n")
+    fout:close()
+  end
+  if param.ok == param.replicas then
+    return 0
+  else
+    return 1
+  end
+end
+
+------------------------------------------------------------------------------
+-- Take a snapshot of the simulator for sim:branch(), typically after the
+-- warm-up phase.
+-- The snapshot is the state of this process: calendar, queues, data objects
+-- and the Lua state. sim:branch() forks the measurement runs from it
+-- (copy-on-write), so the warm-up is simulated only once. The snapshot is
+-- kept as long as this process does not simulate any further.
+-- @return table - Snapshot {time = SimTime}.
+------------------------------------------------------------------------------
+function sim:snapshot()
+  if not self.connected then
+    self:connect()
+  end
+  -- less garbage to copy for the children
+  collectgarbage("collect")
+  self.snap = {time = SimTime}
+  return self.snap
+end
+
+------------------------------------------------------------------------------
+-- Run measurements from the snapshot in child processes.
+-- Each child starts with a copy of the snapshot, reseeds the random number
+-- streams of all objects with seed + index - 1 and calls run(index), which
+-- resets the counters of interest, simulates and returns its results (a
+-- table of numbers). If it returns nothing, the results of the confid and
+-- meas objects are taken (see replica.collect()). This process stays at the
+-- snapshot and can branch again.
+-- @param n number - Number of children.
+-- @param param table or function - Parameters, or the function run
+-- <ul>
+-- <li> run: function(index) of the measurement.
+-- <li> jobs: max. number of concurrent children (default: n).
+-- <li> seed: seed of the first child (default: 1).
+-- <li> level: confidence level of the report (default: 0.95).
+-- </ul>
+-- @return table, table - Results of the children (by index, nil if failed)
+-- and the report of all results as returned by replica.aggregate().
+------------------------------------------------------------------------------
+function sim:branch(n, param)
+  if type(param) == "function" then
+    param = {run = param}
+  end
+  assert(self.snap, "sim:branch(): no snapshot, call sim:snapshot() first")
+  assert(self.snap.time == SimTime,
+	 "sim:branch(): the simulator has been run after sim:snapshot()")
+  assert(type(param.run) == "function", "sim:branch(): function 'run' required")
+  local jobs = math.min(param.jobs or n, n)
+  local seed = param.seed or 1
+  assert(jobs > 0, "sim:branch(): number of jobs must be > 0")
+  local results = spawn(n, jobs, function(index)
+    replica.current = {index = index, count = n, seed = seed + index - 1,
+		       offset = 0}
+    self:setRand(seed + index - 1)
+    return param.run(index) or replica.collect()
+  end)
+  local list = {}
+  for i = 1, n do
+    if results[i] then table.insert(list, results[i]) end
+  end
+  return results, replica.aggregate(list, param.level or 0.95)
+end
+
+return yats
@@ -0,0 +1,185 @@
+-----------------------------------------------------------------------------------
+-- @copyright GNU Public License.
+-- @author Herbert Leuwer, Backnang.
+-- @release 4.0 $Id$
+-- @description Luayats - Rare event simulation with RESTART.
+-- <br>
+-- <br><b>module: yats</b><br>
+-- <br>
+-- sim:runRestart() estimates counts of rare events, e.g. cell losses of a
+-- multiplexer, with RESTART (importance splitting). A restart object
+-- watches the importance, the length of one or more queues. Whenever a
+-- trajectory crosses one of its thresholds upwards, the simulation state is
+-- cloned: the process forks retrials (see sim:branch()), which go on from
+-- the same state with own random numbers until they fall below the
+-- threshold again. The original trajectory goes on as well. The counts are
+-- weighted with 1 / (R1 * ... * Rk) at split depth k, so that the weighted
+-- sum over all trajectories is an unbiased estimate of the count in a
+-- plain run of the same length.
+-----------------------------------------------------------------------------------
+
+require "yats.statist"
+require "yats.replica"
+
+module("yats", yats.seeall)
+
+--
+-- Seed of the j-th retrial of the n-th split of a trajectory.
+--
+local function mixseed(seed, n, j)
+  return math.mod(seed * 69069 + n * 1013 + j, 2147483646) + 1
+end
+
+------------------------------------------------------------------------------
+-- Run the simulation with RESTART.
+-- Thresholds T1 < ... < Tn and the queues are defined by the restart object.
+-- The main trial simulates 'slots' slots. At each upward crossing of Tk,
+-- Rk - 1 retrials are forked (one after the other, at most 'jobs' at a
+-- time); a retrial ends when the importance falls below Tk, or at the end
+-- of the run. The thresholds should not exceed the buffer size of the
+-- queues, so that losses happen at the highest level.
+-- @param param table - Parameter list
+-- <ul>
+-- <li> watch<br>
+--    restart object.
+-- <li> slots<br>
+--    Slots of the main trial.
+-- <li> splits<br>
+--    Split factor R for all thresholds, or list of split factors.
+-- <li> count<br>
+--    Function returning the current value of the counter of interest,
+--    e.g. mux:getLossTot(), or a table of counters.
+-- <li> seed (optional)<br>
+--    Base of the seeds of the retrials. Default: 1.
+-- <li> jobs (optional)<br>
+--    Max. number of concurrent retrials per split. The number of processes
+--    may grow to jobs^n. Default: 1.
+-- </ul>
+-- @return table - Result: counts (weighted counts as returned by 'count'),
+-- slots, retrials (number of retrials), effort (slots simulated by all
+-- trajectories).
+------------------------------------------------------------------------------
+function sim:runRestart(param)
+  local w = param.watch
+  assert(w and w.clname == "restart", "runRestart: 'watch' must be a restart object")
+  assert(type(param.slots) == "number" and param.slots > 0,
+	 "runRestart: number of slots required")
+  assert(type(param.count) == "function", "runRestart: function 'count' required")
+  assert(self:getPartitions() <= 1, "runRestart: not available with parallel simulation")
+  local R, W = {}, {[0] = 1}
+  for k = 1, w.nthresh do
+    if type(param.splits) == "table" then
+      R[k] = param.splits[k]
+    else
+      R[k] = param.splits
+    end
+    assert(type(R[k]) == "number" and R[k] >= 1 and math.floor(R[k]) == R[k],
+	   string.format("runRestart: invalid split factor for threshold %d", k))
+    W[k] = W[k - 1] / R[k]
+  end
+  local jobs = param.jobs or 1
+  local tend = SimTime + param.slots
+  if not self.connected then
+    self:connect()
+  end
+
+  local scalar = type(param.count()) == "number"
+  local function counts()
+    local c = param.count()
+    if scalar then
+      c = {count = c}
+    end
+    return c
+  end
+
+  -- State of the trajectory simulated by this process
+  local est, last = {}, counts()
+  local stat = {retrials = 0, effort = 0}
+  local tseed, nsplit = param.seed or 1, 0
+
+  -- add the counts since the last call with the weight of the current depth
+  local function accumulate()
+    local c = counts()
+    local wt = W[w.depth]
+    for k, v in pairs(c) do
+      est[k] = (est[k] or 0) + (v - (last[k] or 0)) * wt
+    end
+    last = c
+  end
+
+  local trajectory
+
+  -- fork the retrials of a split to depth d, add their results
+  local function split(d)
+    nsplit = nsplit + 1
+    local results = replica.spawn(R[d] - 1, jobs, function(j)
+      est, stat = {}, {retrials = 1, effort = 0}
+      tseed, nsplit = mixseed(tseed, nsplit, j), 0
+      self:setRand(tseed)
+      w.depth, w.base = d, d
+      trajectory()
+      local res = {retrials = stat.retrials, effort = stat.effort}
+      for k, v in pairs(est) do
+	res["count."..k] = v
+      end
+      return res
+    end)
+    for j = 1, R[d] - 1 do
+      assert(results[j], "runRestart: retrial failed")
+      for k, v in pairs(results[j]) do
+	if stat[k] then
+	  stat[k] = stat[k] + v
+	else
+	  k = string.sub(k, 7)
+	  est[k] = (est[k] or 0) + v
+	end
+      end
+    end
+    w.depth = d
+  end
+
+  -- split or lower the depth until the state fits the depth
+  local function react(a)
+    while a == restartObj.Split or a == restartObj.Down do
+      if a == restartObj.Split then
+	split(w.depth + 1)
+      else
+	w.depth = w.depth - 1
+      end
+      a = w:check()
+    end
+    return a
+  end
+
+  -- simulate until the end of the run or until a retrial is killed
+  function trajectory()
+    local t0 = SimTime
+    -- a retrial may be born above further thresholds
+    local a = react(w:check())
+    w:start()
+    while SimTime < tend and a ~= restartObj.Kill do
+      local n = tend - SimTime
+      _sim:_run(n, 2 * n)
+      a = w.action
+      w.action = restartObj.None
+      if SimTime < tend then
+	accumulate()
+	a = react(a)
+      end
+    end
+    accumulate()
+    w:stop()
+    stat.effort = stat.effort + SimTime - t0
+  end
+
+  w.depth, w.base = 0, 0
+  trajectory()
+  local c = est
+  if scalar then
+    c = est.count or 0
+  end
+  return {counts = c, slots = param.slots, retrials = stat.retrials,
+	  effort = stat.effort}
+end
+
+return yats
@@ -0,0 +1,212 @@
+-----------------------------------------------------------------------------------
+-- @copyright GNU Public License.
+-- @author Herbert Leuwer, Backnang.
+-- @release 4.0 $Id$
+-- @description Luayats - Sequential run-length control.
+-- <br>
+-- <br><b>module: yats</b><br>
+-- <br>
+-- sim:runSequential() runs a simulation in intervals until the confidence
+-- intervals of the observed quantities are narrow enough. The end of the
+-- warm-up period is detected with MSER-5; the observations after it are
+-- grouped into batch means, from which the confidence intervals are
+-- calculated.
+-----------------------------------------------------------------------------------
+
+require "yats.statist"
+
+module("yats", yats.seeall)
+
+--
+-- Observer for one quantity: returns the value of the last interval or nil,
+-- if there were no samples.
+--
+local function observer(spec)
+  if type(spec) == "function" then
+    return spec, "function"
+  elseif spec.clname == "confid" then
+    -- mean of the values added within the interval
+    local n0, s0 = spec:getLen(), spec:getLen() * spec:getMean()
+    return function()
+      local n, s = spec:getLen(), spec:getLen() * spec:getMean()
+      local dn, ds = n - n0, s - s0
+      n0, s0 = n, s
+      if dn > 0 then return ds / dn end
+    end, spec.name
+  elseif spec.clname == "meas" then
+    -- mean delay of the cells measured within the interval
+    local function sums()
+      if spec.hist then
+	-- all delays, independent of maxtim
+	local n = spec.hist:getCount()
+	return n, n * spec.hist:getMean()
+      end
+      assert(spec.greater_cnt == 0, "runSequential: "..spec.name..
+	     ": delays >= maxtim, increase maxtim or use parameter 'hist'")
+      local n, sum = 0, 0
+      for i = 0, spec.maxtim - 1 do
+	local d = spec:getDist(i)
+	n = n + d
+	sum = sum + i * d
+      end
+      return n, sum
+    end
+    local n0, s0 = sums()
+    return function()
+      local n, s = sums()
+      local dn, ds = n - n0, s - s0
+      n0, s0 = n, s
+      if dn > 0 then return ds / dn end
+    end, spec.name
+  end
+  error("runSequential: cannot observe "..tostring(spec.name or spec))
+end
+
+--
+-- MSER-5: truncation point of the observations x[1 ... n] in units of x.
+-- Returns nil, as long as the optimum lies in the second half (warm-up
+-- not yet over).
+--
+local function mser5(x)
+  local z = {}
+  for i = 1, math.floor(table.getn(x) / 5) do
+    local s = 0
+    for j = 5 * i - 4, 5 * i do s = s + x[j] end
+    z[i] = s / 5
+  end
+  local nz = table.getn(z)
+  if nz < 2 then return nil end
+  -- sums of the batch means from the end
+  local sum, sumq = {}, {}
+  sum[nz + 1], sumq[nz + 1] = 0, 0
+  for i = nz, 1, -1 do
+    sum[i] = sum[i + 1] + z[i]
+    sumq[i] = sumq[i + 1] + z[i] * z[i]
+  end
+  local best, dbest
+  for d = 0, math.floor(nz / 2) do
+    local m = nz - d
+    local mean = sum[d + 1] / m
+    local stat = (sumq[d + 1] - m * mean * mean) / (m * m)
+    if not best or stat < best then
+      best, dbest = stat, d
+    end
+  end
+  if dbest == math.floor(nz / 2) then return nil end
+  return 5 * dbest
+end
+
+--
+-- Confidence interval from nbatch batch means of x[first ... n].
+--
+local function batchconf(x, first, nbatch, level)
+  local n = table.getn(x) - first + 1
+  local size = math.floor(n / nbatch)
+  if size < 1 then return nil end
+  -- skip the surplus at the beginning
+  local i = first + n - size * nbatch
+  local c = _confidObj:new_local()
+  for b = 1, nbatch do
+    local s = 0
+    for j = i, i + size - 1 do s = s + x[j] end
+    c:add(s / size)
+    i = i + size
+  end
+  local mean, width = c:getMean(), c:getWidth(level)
+  return mean, width, size
+end
+
+------------------------------------------------------------------------------
+-- Run the simulation until the confidence intervals of all observed
+-- quantities reach the requested relative half-width.
+-- The simulation runs in intervals of 'interval' slots. After each interval,
+-- every quantity yields one observation:
+-- <ul>
+-- <li> confid object: mean of the values added within the interval,
+-- <li> meas object: mean delay of the cells measured within the interval
+--      (from its histogram 'hist', if given; otherwise all delays must be
+--      below maxtim),
+-- <li> function: its return value (nil: no observation).
+-- </ul>
+-- The warm-up period is truncated with MSER-5 per quantity; the remaining
+-- observations are grouped into 'batches' batch means.
+-- @param param table - Parameter list
+-- <ul>
+-- <li> observe<br>
+--    List of quantities: confid objects, meas objects or functions.
+-- <li> relwidth (optional)<br>
+--    Requested half-width of the intervals relative to the mean. Default: 0.05.
+-- <li> level (optional)<br>
+--    Confidence level: 0.9, 0.95, 0.975 or 0.99. Default: 0.95.
+-- <li> interval (optional)<br>
+--    Slots between two observations. Default: 10000.
+-- <li> batches (optional)<br>
+--    Number of batch means. Default: 20.
+-- <li> maxslots (optional)<br>
+--    Stop after this number of slots in any case. Default: unlimited.
+-- <li> dots (optional)<br>
+--    Progress dots, see sim:run(). Default: interval.
+-- </ul>
+-- @return table - Result: converged (boolean), slots (slots run), warmup
+-- (slots truncated, max. over all quantities) and results (list with
+-- mean, width, relwidth, warmup per quantity, in the order of 'observe').
+------------------------------------------------------------------------------
+function sim:runSequential(param)
+  assert(type(param.observe) == "table" and table.getn(param.observe) > 0,
+	 "runSequential: no quantities to observe")
+  local relwidth = param.relwidth or 0.05
+  local level = param.level or 0.95
+  assert(level == 0.9 or level == 0.95 or level == 0.975 or level == 0.99,
+	 "runSequential: only levels 0.9/0.95/0.975/0.99 available")
+  local interval = param.interval or 10000
+  local nbatch = param.batches or 20
+  assert(nbatch >= 2, "runSequential: at least 2 batches required")
+  local maxslots = param.maxslots
+  local dots = param.dots or interval
+
+  local obs = {}
+  for i, spec in ipairs(param.observe) do
+    local f, name = observer(spec)
+    obs[i] = {f = f, name = name, x = {}}
+  end
+
+  local slots = 0
+  local res
+  while true do
+    self:run(interval, dots)
+    slots = slots + interval
+    local done = true
+    res = {converged = false, slots = slots, warmup = 0, results = {}}
+    for i, o in ipairs(obs) do
+      local v = o.f()
+      if v then table.insert(o.x, v) end
+      local r = {name = o.name, n = table.getn(o.x)}
+      res.results[i] = r
+      local d = table.getn(o.x) >= 2 * nbatch and mser5(o.x)
+      if d then
+	r.warmup = d * interval
+	if r.warmup > res.warmup then res.warmup = r.warmup end
+	local mean, width = batchconf(o.x, d + 1, nbatch, level)
+	if mean then
+	  r.mean, r.width = mean, width
+	  if mean ~= 0 then
+	    r.relwidth = width / math.abs(mean)
+	  elseif width == 0 then
+	    r.relwidth = 0
+	  end
+	end
+      end
+      if not r.relwidth or r.relwidth > relwidth then
+	done = false
+      end
+    end
+    if done then
+      res.converged = true
+      break
+    end
+    if maxslots and slots + interval > maxslots then break end
+  end
+  return res
+end
+
+return yats
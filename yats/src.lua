@@ -292,6 +292,157 @@ function distsrc:init(param)
   return self:finish()
 end
 
+--==========================================================================
+-- Trace Source Object.
+--==========================================================================
+
+_tracesrc = tracesrc
+--- Definition of source object 'tracesrc' (replay of a trace file).
+tracesrc = class(_tracesrc)
+
+local traceformats = {
+  iat32 = TRACE_IAT32, iat64 = TRACE_IAT64, frame = TRACE_FRAME
+}
+
+--- Constructor for class 'tracesrc'.
+-- Replays a recorded trace file. The file is mapped into memory and read
+-- ahead of the current record, large traces (64 bit file offsets) are
+-- supported. All values are in host byte order.
+-- @param param table - Parameter list
+-- <ul>
+-- <li>name (optional)<br>
+--    Name of the display. Default: "objNN"
+-- <li>file<br>
+--    Name of the trace file
+-- <li>format (optional)<br>
+--    "iat32": 32 bit IATs (files of the old filsrc), sends cells<br>
+--    "iat64": 64 bit IATs, sends cells<br>
+--    "frame": records of 16 bytes (64 bit IAT, 32 bit length, 16 bit
+--    VLAN ID (0: untagged), 8 bit VLAN priority, 8 bit drop precedence),
+--    sends frames. Default: "frame"
+-- <li>vci (optional)<br>
+--    Virtual connection id of the cells. Default: 0
+-- <li>connid (optional)<br>
+--    Connection ID of the frames. Default: 0
+-- <li>rep (optional)<br>
+--    Number of passes through the file, 0: endless. Default: 1
+-- <li>start (optional)<br>
+--    First record to replay (0 ...). Default: 0
+-- <li>wait (optional)<br>
+--    Delay of the first record in slots. Default: 0
+-- <li>ahead (optional)<br>
+--    Number of bytes to read ahead. Default: 64 MB
+-- <li>prefetch (optional)<br>
+--    true: read ahead in a thread of its own. Default: false
+-- <li>out<br>
+--    Connection to successor
+--    Format: {"name-of-successor", "input-pin-of-successor"}
+-- </ul>.
+-- IATs are the distances to the previous record in slots. Records with
+-- IAT 0 are sent in the same slot. The first record is sent wait + IAT
+-- slots (at least one) after the start.
+-- @return table -  Reference to object instance.
+function tracesrc:init(param)
+  self = _tracesrc:new()
+  self.name = autoname(param)
+  self.clname = "tracesrc"
+  self.parameters =  {
+    file = true, format = false, vci = false, connid = false, rep = false,
+    start = false, wait = false, ahead = false, prefetch = false, out = true
+  }
+  -- Adjust parameters.
+  self:adjust(param)
+
+  -- Set paramaters
+  local format = traceformats[param.format or "frame"]
+  assert(format, "tracesrc: unknown format '"..tostring(param.format).."'")
+  assert(param.file, "tracesrc: no trace file")
+  self.vci = param.vci or 0
+  self.connID = param.connid or 0
+  self.rep_max = param.rep or 1
+  self.start = param.start or 0
+  self.wait = param.wait or 0
+  self.ahead = param.ahead or 64 * 2^20
+  if param.prefetch == true then self.prefetch = 1 else self.prefetch = 0 end
+  self:openTrace(param.file, format)
+
+  -- Init output table
+  self:defout(param.out)
+
+  -- Init input table
+  -- no inputs
+
+  -- Finish with C++ act() if necesary
+  return self:finish()
+end
+
+--==========================================================================
+-- Fluid Source Object.
+--==========================================================================
+
+_fluidsrc = fluidsrc
+--- Definition of source object 'fluidsrc' (fluid background load).
+fluidsrc = class(_fluidsrc)
+
+--- Constructor for class 'fluidsrc'.
+-- Aggregate of n on/off sources as fluid flow: no frames are generated,
+-- only the changes of the aggregate rate are sent, whenever one of the
+-- sources switches. On and off durations are exponentially distributed.
+-- The successor has to be fluid-aware (muxFrmPrio, mode "async").
+-- @param param table - Parameter list
+-- <ul>
+-- <li>name (optional)<br>
+--    Name of the display. Default: "objNN" 
+-- <li>n (optional)<br>
+--    Number of on/off sources. Default: 1
+-- <li>rate<br>
+--    Rate of a source in the on state in bits per slot
+-- <li>eb (optional)<br>
+--    Mean on duration in slots. Default: 0 (always on, constant rate)
+-- <li>es (optional)<br>
+--    Mean off duration in slots, required with eb
+-- <li>inprio (optional)<br>
+--    Priority code point of the flow (as in frames). Default: 0
+-- <li>out<br>
+--    Connection to successor 
+--    Format: {"name-of-successor", "input-pin-of-successor"}
+-- </ul>.
+-- @return table -  Reference to object instance.
+function fluidsrc:init(param)
+  self = _fluidsrc:new()
+  self.name = autoname(param)
+  self.clname = "fluidsrc"
+  self.parameters =  {
+    n = false, rate = true, eb = false, es = false, inprio = false, out = true
+  }
+
+  -- Adjust parameters.
+  self:adjust(param)
+  
+  -- Set paramaters.
+  self.nsrc = param.n or 1
+  assert(self.nsrc >= 1, self.name..": n must be >= 1")
+  assert(param.rate >= 0, self.name..": rate must be >= 0")
+  self.rate = param.rate
+  self.eb = param.eb or 0
+  if self.eb > 0 then
+    assert(param.es and param.es > 0, self.name..": es must be > 0")
+    self.es = param.es
+  else
+    self.es = 0
+  end
+  self.prioCodePoint = param.inprio or 0
+  
+  -- Init output table.
+  self:defout(param.out)
+  
+  -- Init input table.
+  -- no inputs
+  
+  -- Finish with C++ act() if necesary
+  return self:finish()
+end
+
 --==========================================================================
 -- MMBP Cell Source Object.
 --==========================================================================
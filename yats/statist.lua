@@ -32,6 +32,18 @@ confid = confidObj
 --    Name of the display. Default: "objNN". 
 -- <li> level<br>
 --    Confidence level: 0.9, 0.95, 0.975 and 0.99 are supported.
+-- <li> stream (optional)<br>
+--    true: streaming mode, the values are not stored. Mean and variance
+--    are updated incrementally, the confidence interval is calculated
+--    from batch means with automatically doubled batch size. getVal() is
+--    not available, getCorr(lag, 1) gives the autocorrelation of the values
+--    (lag <= maxlag), getCorr(lag, b) with b > 1 the one of the batch means.
+--    Default: false.
+-- <li> batches (optional)<br>
+--    Streaming mode: number of batch means kept is batches ... 2 * batches.
+--    Default: 32.
+-- <li> maxlag (optional)<br>
+--    Streaming mode: largest lag of getCorr(lag, 1). Default: 10.
 -- </ul>
 -- @return table - reference to object instance.
 function confidObj:init(param)
@@ -39,12 +51,17 @@ function confidObj:init(param)
   self.name = autoname(param)
   self.clname = "confid"
   self.parameters = {
-    level = true
+    level = true, stream = false, batches = false, maxlag = false
   }
   local l = param.level or 0.95
   assert(l == 0.9 or l == 0.95 or l == 0.975 or  l == 0.99,
 	 self.name.." only levels 0.9/0.95/0.975/0.99 available")
   self:adjust(param)
+  if param.stream == true then
+    self.stream = 1
+    self.nBatch = param.batches or 32
+    self.maxLag = param.maxlag or 10
+  end
   return self:finish()
 end
 
@@ -56,4 +73,46 @@ function confidObj:getCorr(lag, batchsize)
   return self:_getCorr(lag, batchsize)
 end
 
+
+--- Definition of class 'restart'
+_restartObj = restartObj
+restartObj = class(_restartObj)
+restart = restartObj
+
+--- Constructor for class 'restart'.
+-- Importance watcher for RESTART simulations, see sim:runRestart(). The
+-- importance is the sum of the lengths of the given queues, e.g. 'mux.q'
+-- or 'muxFrmPrio:getQueue(p)'. At the end of each slot it is compared with
+-- the thresholds, and the simulation is stopped, whenever the trajectory
+-- has to split, to end or to change its weight.
+-- @param param table - parameter list
+-- <ul>
+-- <li> name (optional)<br>
+--    Name of the object. Default: "objNN".
+-- <li> queue<br>
+--    Queue or list of queues.
+-- <li> thresholds<br>
+--    List of increasing thresholds of the importance, all >= 1.
+-- </ul>
+-- @return table - reference to object instance.
+function restartObj:init(param)
+  self = _restartObj:new()
+  self.name = autoname(param)
+  self.clname = "restart"
+  self.parameters = {queue = true, thresholds = true}
+  self:adjust(param)
+  local q = param.queue
+  if type(q) ~= "table" then q = {q} end
+  assert(table.getn(q) > 0, self.name..": no queue given")
+  for _, v in ipairs(q) do
+    self:addQueue(v)
+  end
+  assert(type(param.thresholds) == "table" and table.getn(param.thresholds) > 0,
+	 self.name..": no thresholds given")
+  for _, t in ipairs(param.thresholds) do
+    self:addThreshold(t)
+  end
+  return self:finish()
+end
+
 return yats
@@ -0,0 +1,249 @@
+-----------------------------------------------------------------------------------
+-- @copyright GNU Public License.
+-- @author Herbert Leuwer, Backnang.
+-- @release 4.0 $Id$
+-- @description Luayats - Parameter sweeps with common random numbers.
+-- <br>
+-- <br><b>module: yats</b><br>
+-- <br>
+-- Runs a scenario over a grid of parameter values in parallel worker
+-- processes. Every grid point is simulated with the same replications:
+-- replication r uses the same seed at all points, and the random streams
+-- of the objects are keyed by their names (generator "xoshiro", see
+-- sim:setRandStreams()). A source therefore draws the same random numbers
+-- at all grid points, and differences between the points are not buried in
+-- noise (common random numbers).<br>
+-- Give all objects which draw random numbers an explicit name. Objects
+-- without a name are named by autoname() in the order of creation
+-- ("autoobj1", "autoobj2", ...): if a parameter changes the number or order
+-- of the objects created, such a name - and with it the stream - moves to
+-- another object, and the random numbers are no longer common.<br>
+-- The scenario reads its parameters with <code>yats.sweep.param()</code>.
+-- Usage from command line:<br>
+-- <code>luayats -n --grid="buff=16,32,64;ed=10,12" --replicas=8 --jobs=8
+-- script.lua</code>
+-----------------------------------------------------------------------------------
+
+require "yats.replica"
+
+module("yats", yats.seeall)
+
+sweep = {}
+
+--- Sweep context of the current process. 'nil' outside of a sweep.
+-- Fields: point (parameter values), index (of the point), replica, seed.
+sweep.current = nil
+
+------------------------------------------------------------------------------
+-- Parameters of the scenario.
+-- @param defaults table - Default values of the parameters.
+-- @return table - The defaults, overridden by the values of the grid point
+-- in a sweep.
+------------------------------------------------------------------------------
+function sweep.param(defaults)
+  local p = {}
+  for k, v in pairs(defaults or {}) do
+    p[k] = v
+  end
+  if sweep.current then
+    for k, v in pairs(sweep.current.point) do
+      p[k] = v
+    end
+  end
+  return p
+end
+
+------------------------------------------------------------------------------
+-- Grid points: all combinations of the parameter values.
+-- @param grid table - Lists of values by parameter name.
+-- @return table, table - List of points (tables of parameter values), the
+-- last parameter in alphabetical order varying fastest, and the sorted list
+-- of parameter names.
+------------------------------------------------------------------------------
+function sweep.points(grid)
+  local keys = {}
+  for k in pairs(grid) do
+    table.insert(keys, k)
+  end
+  table.sort(keys)
+  local points = {{}}
+  for _, k in ipairs(keys) do
+    local values = grid[k]
+    if type(values) ~= "table" then
+      values = {values}
+    end
+    local new = {}
+    for _, p in ipairs(points) do
+      for _, v in ipairs(values) do
+	local q = {}
+	for kk, vv in pairs(p) do
+	  q[kk] = vv
+	end
+	q[k] = v
+	table.insert(new, q)
+      end
+    end
+    points = new
+  end
+  return points, keys
+end
+
+------------------------------------------------------------------------------
+-- Parse a grid given on the command line.
+-- @param spec string - "name=v1,v2,...;name2=w1,w2,...".
+-- @return table - Lists of values by parameter name.
+------------------------------------------------------------------------------
+function sweep.parse(spec)
+  local grid = {}
+  for item in string.gfind(spec, "[^;]+") do
+    local _, _, k, list = string.find(item, "^%s*([%w_]+)%s*=(.*)$")
+    assert(k, string.format("sweep: invalid grid '%s'", item))
+    grid[k] = {}
+    for v in string.gfind(list, "[^,]+") do
+      v = string.gsub(v, "^%s*(.-)%s*$", "%1")
+      table.insert(grid[k], tonumber(v) or v)
+    end
+    assert(table.getn(grid[k]) > 0, string.format("sweep: no values for '%s'", k))
+  end
+  return grid
+end
+
+------------------------------------------------------------------------------
+-- Print the results table of a sweep.
+-- @param report table - Report as returned by sweep.run().
+-- @param param table - Parameters of the sweep.
+-- @return none.
+------------------------------------------------------------------------------
+function sweep.print(report, param)
+  printf("Sweep: %d points x %d replications (%d jobs), seed %d, seed offsets 0...%d, level %g\n",
+	 table.getn(param.points), param.replicas, param.jobs, param.seed,
+	 param.replicas - 1, param.level)
+  local head = ""
+  for _, k in ipairs(param.keys) do
+    head = head..string.format("%10s ", k)
+  end
+  printf("%s%-24s %3s %12s %12s %12s %12s\n", head, "name", "n", "mean", "width",
+	 "diff", "dwidth")
+  for _, v in ipairs(report) do
+    local s = ""
+    for _, k in ipairs(param.keys) do
+      s = s..string.format("%10s ", tostring(v.point[k]))
+    end
+    local diff, dwidth = "", ""
+    if v.diff then
+      diff = string.format("%12.6g", v.diff)
+      dwidth = string.format("%12.6g", v.dwidth or 0)
+    end
+    printf("%s%-24s %3d %12.6g %12.6g %12s %12s\n", s, v.name, v.n, v.mean, v.width,
+	   diff, dwidth)
+  end
+end
+
+------------------------------------------------------------------------------
+-- Run a parameter sweep.
+-- The scenario is either a script, or a function building and running the
+-- model. It runs in a worker process for each grid point and replication.
+-- Before, the worker selects the generator "xoshiro" with streams keyed by
+-- object names, and shifts the seeds set by the scenario by r - 1 in
+-- replication r (see sim:setSeedOffset()). The results of a run are those of
+-- replica.collect(). For each grid point, the mean and the confidence
+-- interval over the replications are reported, and from the second point
+-- on, the mean difference to the first point and its confidence interval,
+-- calculated from the differences of the replications with the same seed.
+-- @param param table - Parameters
+-- <ul>
+-- <li> grid: lists of values by parameter name.
+-- <li> script: name of the script file, with runner: function(fname) running
+--      a script, returns exitval, retval.
+-- <li> run: function(point, r) instead of script, returns its results.
+-- <li> replicas: number of replications per point (default: 10).
+-- <li> jobs: max. number of concurrent workers (default: all runs).
+-- <li> seed: seed of the first replication (default: 1).
+-- <li> level: confidence level (default: 0.95).
+-- <li> out: file name for the report as Lua table (optional).
+-- <li> quiet: do not print the report (optional).
+-- </ul>
+-- @return table, number - Report: list of {index, point, name, n, mean, lo,
+-- up, width, diff, dwidth}, and 0 if all runs succeeded, 1 otherwise.
+------------------------------------------------------------------------------
+function sweep.run(param)
+  assert(type(param.grid) == "table", "sweep: grid required")
+  assert(param.run or (param.script and param.runner), "sweep: scenario required")
+  param.points, param.keys = sweep.points(param.grid)
+  param.replicas = param.replicas or 10
+  param.seed = param.seed or 1
+  param.level = param.level or 0.95
+  local npoints = table.getn(param.points)
+  local n = npoints * param.replicas
+  param.jobs = math.min(param.jobs or n, n)
+  assert(param.jobs > 0, "sweep: number of jobs must be > 0")
+  local results, ok = replica.spawn(n, param.jobs, function(i)
+    local k = math.floor((i - 1) / param.replicas) + 1
+    local r = i - (k - 1) * param.replicas
+    local point = param.points[k]
+    sweep.current = {
+      point = point, index = k, replica = r, seed = param.seed + r - 1
+    }
+    -- common random numbers
+    sim:setRandGen("xoshiro")
+    sim:setRandStreams("name")
+    sim:setSeedOffset(r - 1)
+    sim:setRand(param.seed)
+    local retval
+    if param.run then
+      retval = param.run(point, r)
+    else
+      local exitval
+      exitval, retval = param.runner(param.script)
+      if exitval ~= 0 then
+	return nil
+      end
+    end
+    return replica.collect(retval)
+  end)
+  local function result(k, r)
+    return results[(k - 1) * param.replicas + r]
+  end
+  local conf = _confidObj:new_local()
+  local report = {}
+  for k, point in ipairs(param.points) do
+    local list = {}
+    for r = 1, param.replicas do
+      if result(k, r) then
+	table.insert(list, result(k, r))
+      end
+    end
+    for _, v in ipairs(replica.aggregate(list, param.level)) do
+      v.index, v.point = k, point
+      if k > 1 then
+	-- paired differences to the first point
+	conf:flush()
+	for r = 1, param.replicas do
+	  local a, b = result(k, r), result(1, r)
+	  if a and b and a[v.name] and b[v.name] then
+	    conf:add(a[v.name] - b[v.name])
+	  end
+	end
+	if conf:getLen() > 1 then
+	  v.diff, v.dwidth = conf:getMean(), conf:getWidth(param.level)
+	end
+      end
+      table.insert(report, v)
+    end
+  end
+  if not param.quiet then
+    sweep.print(report, param)
+  end
+  if param.out then
+    local fout = assert(io.open(param.out, "w+"))
+    fout:write("return "..pretty(report).."\n")
+    fout:close()
+  end
+  if ok == n then
+    return report, 0
+  else
+    return report, 1
+  end
+end
+
+return yats
@@ -261,6 +261,9 @@ tcpiprecv = tcpiprec
 --    Processing time in s. Default: 0.3 ms. 
 -- <li>keepalive (optional)<br>
 --    Keepalive timer in s. Default: no timer. 
+-- <li>trace (optional)<br>
+--    Write the delays of the PDUs and SDUs to a binary trace: file name, or
+--    {file = "name", codec = "raw" | "lz4" | "zstd"}. See tracewriter().
 -- <li>out<br>
 --    Connection to successor. 
 --    Format: {{"name-of-data-successor", "input-pin-of-data-successor"}
@@ -273,7 +276,7 @@ function tcpiprec:init(param)
   self.clname = "tcpiprec"
   self.parameters = {
     wnd = true, proctim = false, ackdel = false, out = true, keepalive = false,
-    iackdel = false
+    iackdel = false, trace = false
   }
 
   self:adjust(param)
@@ -293,6 +296,9 @@ function tcpiprec:init(param)
   assert((not param.keepalive) or (param.keepalive >= 0),
 	 ": parameter 'keepalive' must be >= 0.")
   self.keepalive_secs = param.keepalive or 0
+  if param.trace then
+    self.trace = tracewriter(param.trace)
+  end
 
   -- Outputs
   self:set_nout(table.getn(param.out))
@@ -348,5 +354,233 @@ function termStartStop:init(param)
   return self:finish()
 end
 
+--==========================================================================
+-- AAL5SEND Object
+--==========================================================================
+_aal5send = aal5send
+--- Definition of 'aal5send' class.
+aal5send = class(_aal5send)
+
+--- Constructor for class 'aal5send'.
+-- The aal5send object segments frames into AAL5 cells (AAL5CellType).
+-- The cells of a frame are sent one per slot; with 'train' = n, up to n
+-- consecutive cells are sent as one cell train (AAL5TrainType) in a single
+-- transfer, the next transfer follows as many slots later as the train has
+-- cells. Trains are taken by aal5rec and aal5recMult as a whole. Multiplexers
+-- and measurements (mux, demux, meas, ...) reject a train with an error;
+-- line and sink pass it as one data item. Feed trains through an aal5split
+-- object in front of objects working on single cells.
+-- <br>
+-- The object implements the start/stop protocol at input and output. Input
+-- 'data' receives the frames, input 'start' resumes a stopped output.
+-- Output 1 carries the cells, output 2 stops and restarts the preceding
+-- object.
+-- @param param table - Parameter list
+-- <ul>
+-- <li>name (optional)<br>
+--    Name of the object. Default: "objNN". 
+-- <li>vci (optional)<br>
+--    VCI of all cells. Either 'vci' or 'maxcid' is required.
+-- <li>maxcid (optional)<br>
+--    Highest connection ID of the frames. The VCI of the cells is taken
+--    from a translation table (see setTransVCI()), or with 'copycid' from
+--    the connection ID.
+-- <li>copycid (optional)<br>
+--    Use the connection ID as VCI. Default: false.
+-- <li>buf<br>
+--    Size of the input buffer in frames.
+-- <li>bstart<br>
+--    Input buffer occupation at which a stopped sender is restarted.
+-- <li>header (optional)<br>
+--    Length of an additional header (e.g. LLC/SNAP). Default: 0.
+-- <li>printwarning (optional)<br>
+--    Print warnings about a violated start/stop protocol. Default: true.
+-- <li>copyclp (optional)<br>
+--    Copy the CLP bit of the frames into the cells. Default: false.
+-- <li>pt1clp0 (optional)<br>
+--    Send the last cell of a frame with CLP = 0. Default: false.
+-- <li>train (optional)<br>
+--    Max. number of cells sent as one train. Default: 1 (single cells).
+-- <li>out<br>
+--    Connections to successors. 
+--    Format: {{"name-of-cell-successor", "input-pin"},
+--             {"name-of-frame-source", "input-pin-for-start"}}. 
+-- </ul>.
+-- @return table - Reference to object instance.
+function aal5send:init(param)
+  local self = _aal5send:new()
+  self.name=autoname(param)
+  self.clname = "aal5send"
+  self.parameters = {
+    vci = false, maxcid = false, copycid = false, buf = true, bstart = true,
+    header = false, printwarning = false, copyclp = false, pt1clp0 = false,
+    train = false, out = true
+  }
+  self:adjust(param)
+
+  if param.vci then
+    assert(not param.maxcid, self.name .. ": parameters 'vci' and 'maxcid' exclude each other.")
+    self.vci = param.vci
+    self.fixVCI = 1
+    self.maxcid = 1
+  else
+    assert(param.maxcid and param.maxcid >= 0,
+	   self.name .. ": parameter 'vci' or 'maxcid' required.")
+    self.maxcid = param.maxcid + 1
+    self.copyCID = b2i(param.copycid or false)
+  end
+  assert(param.buf > 0, self.name .. ": parameter 'buf' must be > 0.")
+  self.q:setmax(param.buf)
+  self.q_start = param.bstart
+  self.addHeader = param.header or 0
+  if param.printwarning == false then
+    self.printwarning = 0
+  end
+  self.CopyClp = b2i(param.copyclp or false)
+  self.Pt1Clp0 = b2i(param.pt1clp0 or false)
+  self.train = param.train or 1
+  assert(self.train >= 1, self.name .. ": parameter 'train' must be >= 1.")
+
+  -- Outputs
+  self:set_nout(2)
+  self:defout(param.out)
+
+  -- Inputs
+  self:definp("data")
+  self:definp("start")
+
+  return self:finish()
+end
+
+--==========================================================================
+-- AAL5REC Object
+--==========================================================================
+_aal5rec = aal5rec
+--- Definition of 'aal5rec' class.
+aal5rec = class(_aal5rec)
+
+--- Constructor for class 'aal5rec'.
+-- The aal5rec object reassembles the frames sent by an aal5send object
+-- from AAL5 cells or cell trains of a single connection. Cell and SDU
+-- losses are detected by sequence numbers. The SDU delay spans from the
+-- first cell sent until the last one received (getSDUCount(), delay_mean,
+-- cell_loss, sdu_loss).
+-- @param param table - Parameter list
+-- <ul>
+-- <li>name (optional)<br>
+--    Name of the object. Default: "objNN". 
+-- <li>out<br>
+--    Connection to successor. 
+--    Format: {"name-of-successor", "input-pin-of-successor"}. 
+-- </ul>.
+-- @return table - Reference to object instance.
+function aal5rec:init(param)
+  local self = _aal5rec:new()
+  self.name=autoname(param)
+  self.clname = "aal5rec"
+  self.parameters = {
+    out = true
+  }
+  self:adjust(param)
+
+  -- Outputs
+  self:defout(param.out)
+
+  -- Inputs
+  self:definp("in")
+
+  return self:finish()
+end
+
+--==========================================================================
+-- AAL5RECMULT Object
+--==========================================================================
+_aal5recMult = aal5recMult
+--- Definition of 'aal5recMult' class.
+aal5recMult = class(_aal5recMult)
+
+--- Constructor for class 'aal5recMult'.
+-- Like aal5rec, but reassembles the frames of the VCIs 0 ... maxvci
+-- concurrently. The statistics are kept per VCI (getCellCount(vci),
+-- getSDUCount(vci), getDelayMean(vci), ...).
+-- @param param table - Parameter list
+-- <ul>
+-- <li>name (optional)<br>
+--    Name of the object. Default: "objNN". 
+-- <li>maxvci<br>
+--    Highest VCI. 
+-- <li>copycid (optional)<br>
+--    Copy the VCI into the connection ID of the frames. Default: false. 
+-- <li>copyclp (optional)<br>
+--    Copy the CLP bit of the last cell into the frames. Default: false. 
+-- <li>out<br>
+--    Connection to successor. 
+--    Format: {"name-of-successor", "input-pin-of-successor"}. 
+-- </ul>.
+-- @return table - Reference to object instance.
+function aal5recMult:init(param)
+  local self = _aal5recMult:new()
+  self.name=autoname(param)
+  self.clname = "aal5recMult"
+  self.parameters = {
+    maxvci = true, copycid = false, copyclp = false, out = true
+  }
+  self:adjust(param)
+  assert(param.maxvci >= 0, self.name .. ": parameter 'maxvci' must be >= 0.")
+  self.maxvci = param.maxvci + 1
+  self.doCopyCid = b2i(param.copycid or false)
+  self.doCopyClp = b2i(param.copyclp or false)
+
+  -- Outputs
+  self:defout(param.out)
+
+  -- Inputs
+  self:definp("in")
+
+  return self:finish()
+end
+
+--==========================================================================
+-- AAL5SPLIT Object
+--==========================================================================
+_aal5split = aal5split
+--- Definition of 'aal5split' class.
+aal5split = class(_aal5split)
+
+--- Constructor for class 'aal5split'.
+-- The aal5split object splits AAL5 cell trains (AAL5TrainType) into
+-- single AAL5 cells, one cell per slot. It is placed in front of objects
+-- which work on single cells (multiplexers, measurements). Other
+-- data items are forwarded unchanged, one per slot.
+-- @param param table - Parameter list
+-- <ul>
+-- <li>name (optional)<br>
+--    Name of the display. Default: "objNN". 
+-- <li>nbuf (optional)<br>
+--    Buffer size in trains. Default is 100. 
+-- <li>out<br>
+--    Connection to successor. 
+--    Format: {"name-of-successor", "input-pin-of-successor"}. 
+-- </ul>.
+-- @return table - Reference to object instance.
+function aal5split:init(param)
+  local self = _aal5split:new()
+  self.name=autoname(param)
+  self.clname = "aal5split"
+  self.parameters = {
+    nbuf = false, out = true
+  }
+  self:adjust(param)
+  self.q:setmax(param.nbuf or 100)
+
+  -- Outputs
+  self:defout(param.out)
+
+  -- Inputs
+  self:definp("in")
+
+  return self:finish()
+end
+
 return yats
 